@@ -39,37 +39,52 @@
 #define SVH_LOG_DEBUG_STREAM(NAME, M)                                                              \
   do                                                                                               \
   {                                                                                                \
-    std::stringstream ss;                                                                          \
-    ss << M;                                                                                       \
-    Logger::log(__FILE__, __LINE__, NAME, driver_svh::LogLevel::DEBUG, ss.str());                  \
+    if (Logger::isEnabled(driver_svh::LogLevel::DEBUG))                                            \
+    {                                                                                              \
+      std::stringstream ss;                                                                        \
+      ss << M;                                                                                     \
+      Logger::log(__FILE__, __LINE__, NAME, driver_svh::LogLevel::DEBUG, ss.str());                \
+    }                                                                                              \
   } while (false)
 #define SVH_LOG_INFO_STREAM(NAME, M)                                                               \
   do                                                                                               \
   {                                                                                                \
-    std::stringstream ss;                                                                          \
-    ss << M;                                                                                       \
-    Logger::log(__FILE__, __LINE__, NAME, driver_svh::LogLevel::INFO, ss.str());                   \
+    if (Logger::isEnabled(driver_svh::LogLevel::INFO))                                             \
+    {                                                                                              \
+      std::stringstream ss;                                                                        \
+      ss << M;                                                                                     \
+      Logger::log(__FILE__, __LINE__, NAME, driver_svh::LogLevel::INFO, ss.str());                 \
+    }                                                                                              \
   } while (false)
 #define SVH_LOG_WARN_STREAM(NAME, M)                                                               \
   do                                                                                               \
   {                                                                                                \
-    std::stringstream ss;                                                                          \
-    ss << M;                                                                                       \
-    Logger::log(__FILE__, __LINE__, NAME, driver_svh::LogLevel::WARN, ss.str());                   \
+    if (Logger::isEnabled(driver_svh::LogLevel::WARN))                                             \
+    {                                                                                              \
+      std::stringstream ss;                                                                        \
+      ss << M;                                                                                     \
+      Logger::log(__FILE__, __LINE__, NAME, driver_svh::LogLevel::WARN, ss.str());                 \
+    }                                                                                              \
   } while (false)
 #define SVH_LOG_ERROR_STREAM(NAME, M)                                                              \
   do                                                                                               \
   {                                                                                                \
-    std::stringstream ss;                                                                          \
-    ss << M;                                                                                       \
-    Logger::log(__FILE__, __LINE__, NAME, driver_svh::LogLevel::ERROR, ss.str());                  \
+    if (Logger::isEnabled(driver_svh::LogLevel::ERROR))                                            \
+    {                                                                                              \
+      std::stringstream ss;                                                                        \
+      ss << M;                                                                                     \
+      Logger::log(__FILE__, __LINE__, NAME, driver_svh::LogLevel::ERROR, ss.str());                \
+    }                                                                                              \
   } while (false)
 #define SVH_LOG_FATAL_STREAM(NAME, M)                                                              \
   do                                                                                               \
   {                                                                                                \
-    std::stringstream ss;                                                                          \
-    ss << M;                                                                                       \
-    Logger::log(__FILE__, __LINE__, NAME, driver_svh::LogLevel::FATAL, ss.str());                  \
+    if (Logger::isEnabled(driver_svh::LogLevel::FATAL))                                            \
+    {                                                                                              \
+      std::stringstream ss;                                                                        \
+      ss << M;                                                                                     \
+      Logger::log(__FILE__, __LINE__, NAME, driver_svh::LogLevel::FATAL, ss.str());                \
+    }                                                                                              \
   } while (false)
 
 namespace driver_svh {
@@ -101,6 +116,9 @@ public:
     logger.m_log_level = log_level;
   }
 
+  //! Cheap check whether a message of \a level would be logged, so that formatting can be skipped
+  static bool isEnabled(const LogLevel level) { return level >= getInstance().m_log_level; }
+
   static void log(const std::string& file,
                   const int line,
                   const std::string& name,
@@ -52,12 +52,21 @@
 #include <schunk_svh_library/control/SVHControlCommand.h>
 #include <schunk_svh_library/control/SVHControllerFeedback.h>
 #include <schunk_svh_library/control/SVHControllerState.h>
+#include <schunk_svh_library/control/SVHFeedbackStore.h>
 #include <schunk_svh_library/control/SVHCurrentSettings.h>
 #include <schunk_svh_library/control/SVHEncoderSettings.h>
 #include <schunk_svh_library/control/SVHPositionSettings.h>
+#include <schunk_svh_library/control/SVHRequestTracker.h>
 #include <schunk_svh_library/serial/SVHReceiveThread.h>
 #include <schunk_svh_library/serial/SVHSerialInterface.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace driver_svh {
 
 //! Channel indicates which motor to use in command calls. WARNING: DO NOT CHANGE THE ORDER OF THESE
@@ -98,9 +107,14 @@ public:
   /*!
    * \brief Open serial device connection
    * \param dev_name System handle (filename in linux) to the device
+   * \param thread_config settings of the threads of the serial interface
    * \return true if connect was successfull
    */
-  bool connect(const std::string& dev_name);
+  bool connect(const std::string& dev_name,
+               const SVHThreadConfig& thread_config = SVHThreadConfig());
+
+  //! thread settings of the last connect that could not be applied
+  std::vector<SVHThreadSetupFailure> getThreadSetupFailures() const;
 
   //! disconnect serial device
   void disconnect();
@@ -109,14 +123,60 @@ public:
    * \brief Set new position target for finger index
    * \param channel Motorchanel to set the target for
    * \param position Target position for the channel given in encoder Ticks
+   * \param force send the target right away, even if it lies within the deadband or would be
+   *        collected with others. Used by loops that wait for the answer to every target.
    */
-  void setControllerTarget(const SVHChannel& channel, const int32_t& position);
+  void setControllerTarget(const SVHChannel& channel,
+                           const int32_t& position,
+                           bool force = false);
 
   /*!
    * \brief Setting new position controller target for all fingers
    * \param positions Target positions for all fingers, Only the first nine values will be evaluated
+   * \param force send the targets even if they lie within the deadband
+   */
+  void setControllerTargetAllChannels(const std::vector<int32_t>& positions, bool force = false);
+
+  /*!
+   * \brief setCommandCoalescing collects the per channel targets of setControllerTarget() for a
+   * short window and sends them as one frame for all channels. Channels without a new target keep
+   * their last target. A single target within the window is still sent as a single command.
+   * The targets are sent by a thread with the command settings of the thread configuration passed
+   * to the last connect().
+   * \param window time targets are collected after the first one, 0 sends every target at once
+   */
+  void setCommandCoalescing(const std::chrono::microseconds& window);
+
+  /*!
+   * \brief beginCommandBatch collects all per channel targets until commitCommandBatch() is
+   * called, independent of the coalescing window. Batches may be nested, the outermost commit
+   * sends the targets.
+   */
+  void beginCommandBatch();
+
+  //! sends the targets collected since beginCommandBatch(), see there
+  void commitCommandBatch();
+
+  //! number of per channel targets that were merged into frames for all channels
+  uint64_t getCoalescedCommandCount();
+
+  /*!
+   * \brief setCommandDeadband drops targets that differ by at most the tolerance from the last
+   * target of their channel. A frame for all channels is only dropped if this holds for every
+   * channel. Targets are sent anyway once the last one of the channel is older than the keepalive
+   * period, so the hand keeps getting fresh commands.
+   * \param tolerance tolerance in encoder ticks, a negative tolerance disables the deadband
+   * \param keepalive period after which a redundant target is sent nevertheless
+   */
+  void setCommandDeadband(
+    int32_t tolerance, const std::chrono::milliseconds& keepalive = std::chrono::milliseconds(100));
+
+  /*!
+   * \brief getSuppressedCommandCount returns the number of targets dropped by the deadband
+   * \param channel channel to get the count for, SVH_ALL for the sum of all channels
+   * \return number of dropped targets
    */
-  void setControllerTargetAllChannels(const std::vector<int32_t>& positions);
+  uint64_t getSuppressedCommandCount(const SVHChannel& channel);
 
 
   // Access functions
@@ -128,10 +188,16 @@ public:
 
   /*!
    *  \brief Disable one or all motor channels
+   *
+   *  Disabling all channels is an emergency stop. The packet overtakes all queued traffic, which
+   *  is discarded, and the time it took is available through getEmergencyStopLatency().
    *  \param channel Motor to deactivate
    */
   void disableChannel(const SVHChannel& channel);
 
+  //! time from the last disableChannel(SVH_ALL) call until its frame was handed to the device
+  std::chrono::microseconds getEmergencyStopLatency();
+
   //! Request current controller state (mainly usefull for debug purposes)
   void requestControllerState();
 
@@ -226,6 +292,14 @@ public:
    */
   SVHFirmwareInfo getFirmwareInfo();
 
+  /*!
+   * \brief waitForFirmwareInfo blocks until the hand answered a firmware info request. Never
+   * returns true in pump mode before the caller pumped the answer.
+   * \param timeout maximum time to wait
+   * \return true if a firmware info was received since connecting, false on timeout
+   */
+  bool waitForFirmwareInfo(const std::chrono::microseconds& timeout);
+
   /*!
    * \brief requests the number of sent packages. Request ist transferred to the serial interface
    * that knows about this count \return number of packages correctly sent
@@ -244,6 +318,95 @@ public:
    */
   void resetPackageCounts();
 
+  /*!
+   * \brief startRequestTracking records every following request together with the index it is
+   * sent with, so that its response can be matched. While tracking, packets are always written
+   * from the calling thread as their index has to be known.
+   */
+  void startRequestTracking();
+
+  //! stops recording requests, see startRequestTracking()
+  void stopRequestTracking();
+
+  /*!
+   * \brief waitForTrackedRequests blocks until every tracked request was answered
+   * \param timeout maximum time to wait
+   * \return true as soon as the last response arrived, false on timeout
+   */
+  bool waitForTrackedRequests(const std::chrono::microseconds& timeout);
+
+  /*!
+   * \brief retransmitUnacknowledgedRequests sends all tracked requests that were not answered
+   * again. The retransmitted requests are tracked with their new index.
+   * \return number of retransmitted requests
+   */
+  size_t retransmitUnacknowledgedRequests();
+
+  //! number of tracked requests that were answered since startRequestTracking()
+  size_t getAcknowledgedRequestCount();
+
+  //! number of tracked requests that still wait for their response
+  size_t getPendingRequestCount();
+
+  /*!
+   * \brief setTransmitWindow paces outgoing packets by their acknowledgements instead of a fixed
+   * delay. See SVHSerialInterface::setTransmitWindow()
+   * \param window number of unacknowledged packets allowed in flight, 0 for fixed delay pacing
+   * \param acknowledge_timeout time after which an unacknowledged packet is considered lost
+   */
+  void setTransmitWindow(unsigned int window,
+                         const std::chrono::microseconds& acknowledge_timeout =
+                           std::chrono::milliseconds(10));
+
+  /*!
+   * \brief setAsynchronousTransmit lets all commands return immediately. Packets are handed to
+   * the writer thread of the serial interface which keeps the order of all settings, state
+   * changes and targets and also takes over the delays needed between the enable packets. Note that
+   * the sent package count then lags behind until the queue is empty.
+   * \param enable true to queue packets, false (default) to send them from the calling thread
+   */
+  void setAsynchronousTransmit(bool enable);
+
+  //! \brief current fill level statistics of the transmit queue
+  SVHTransmitQueueStatistics getTransmitQueueStatistics();
+
+  /*!
+   * \brief setPriorityBudget limits the share of the link a priority class may use. See
+   * SVHSerialInterface::setPriorityBudget()
+   * \param priority priority class to limit
+   * \param share fraction of the link byte time in (0, 1], 1 does not limit the class at all
+   */
+  void setPriorityBudget(SVHTransmitPriority priority, double share);
+
+  /*!
+   * \brief setPumpMode lets the caller drive the communication through read() and write()
+   * instead of the threads of the serial interface. See SVHSerialInterface::setPumpMode(). All
+   * commands are queued then. Request tracking and the command coalescing window need threads
+   * and are not available in pump mode, command batches are.
+   * \param enable true to pump from the caller's thread
+   */
+  void setPumpMode(bool enable);
+
+  //! true if the caller pumps the communication
+  bool isPumped() const;
+
+  //! processes the received bytes in pump mode, see SVHSerialInterface::read()
+  size_t read();
+
+  //! sends the queued packets that are due in pump mode, see SVHSerialInterface::write()
+  size_t write();
+
+  /*!
+   * \brief setReactor lets a reactor serve the serial interface from the next connect() on. See
+   * SVHSerialInterface::setReactor()
+   * \param reactor reactor to register with, NULL to use the own threads
+   * \return false if the hand is connected
+   */
+  bool setReactor(const std::shared_ptr<SVHReactor>& reactor);
+
+  //! true while a reactor serves the serial interface
+  bool usesReactor() const;
+
   /*!
    * \brief Check if a channel was enabled
    * \param channel to check
@@ -260,6 +423,71 @@ public:
   //! Get all currently available controllerfeedbacks
   void getControllerFeedbackAllChannels(SVHControllerFeedbackAllChannels& controller_feedback);
 
+  /*!
+   * \brief getControllerFeedbackSnapshot returns the latest feedback of all channels as one
+   * consistent copy. It never blocks the receive thread and never allocates, so it can be called
+   * from a fast control loop.
+   */
+  SVHFeedbackSnapshot getControllerFeedbackSnapshot();
+
+  /*!
+   * \brief getControllerFeedbackSample returns the latest feedback of a channel together with its
+   * monotonic receive time and sequence number
+   * \param channel channel to get the feedback for
+   * \param sample latest feedback, its sequence number is 0 if nothing was received yet
+   * \return false for an unknown channel
+   */
+  bool getControllerFeedbackSample(const SVHChannel& channel, SVHFeedbackSample& sample);
+
+  /*!
+   * \brief getControllerFeedbackAge returns how long ago the latest feedback of a channel arrived
+   * \param channel channel to get the age for
+   * \param age time since the latest feedback was received
+   * \return false for an unknown channel or if no feedback was received yet
+   */
+  bool getControllerFeedbackAge(const SVHChannel& channel, std::chrono::nanoseconds& age);
+
+  //! returns the sequence number of the latest feedback of a channel, 0 if none was received yet
+  uint64_t getControllerFeedbackSequence(const SVHChannel& channel);
+
+  //! returns the sequence numbers of the latest feedback of all channels
+  SVHFeedbackSequences getControllerFeedbackSequences();
+
+  //! returns true if feedback for the channel arrived after the one with the given sequence number
+  bool controllerFeedbackChangedSince(const SVHChannel& channel, uint64_t sequence);
+
+  /*!
+   * \brief waitForControllerFeedback blocks until the next feedback arrives
+   * \param channel channel to wait for, SVH_ALL waits until every channel got new feedback
+   * \param timeout maximum time to wait
+   * \return true if new feedback arrived, false on timeout or for an unknown channel
+   */
+  bool waitForControllerFeedback(const SVHChannel& channel,
+                                 const std::chrono::microseconds& timeout);
+
+  /*!
+   * \brief waitForControllerFeedbackAfter blocks until a channel got feedback newer than a known
+   * sequence number. Taking the sequence number before sending a command avoids missing an answer
+   * that arrives before the wait starts.
+   * \param channel channel to wait for
+   * \param sequence sequence number of the last feedback the caller knows about
+   * \param timeout maximum time to wait
+   * \return true if new feedback arrived, false on timeout or for an unknown channel
+   */
+  bool waitForControllerFeedbackAfter(const SVHChannel& channel,
+                                      uint64_t sequence,
+                                      const std::chrono::microseconds& timeout);
+
+  /*!
+   * \brief waitForControllerFeedbackAfter blocks until every channel got feedback newer than the
+   * given sequence numbers, e.g. the answer to a command for all channels
+   * \param sequences sequence numbers of the last feedback the caller knows about
+   * \param timeout maximum time to wait
+   * \return true if all channels got new feedback, false on timeout
+   */
+  bool waitForControllerFeedbackAfter(const SVHFeedbackSequences& sequences,
+                                      const std::chrono::microseconds& timeout);
+
 private:
   // Data Structures for holding configurations and feedback of the Controller
 
@@ -269,8 +497,12 @@ private:
   //! vector of position controller parameters for each finger
   std::vector<SVHPositionSettings> m_position_settings;
 
-  //! ControllerFeedback indicates current position and current per finger
-  std::vector<SVHControllerFeedback> m_controller_feedback;
+  //! ControllerFeedback indicates current position and current per finger. Written by the receive
+  //! thread and read lock-free by the user threads.
+  SVHFeedbackStore m_feedback_store;
+
+  //! Decode buffer for feedback of all channels, only used by the receive thread
+  std::vector<SVHControllerFeedback> m_received_feedback;
 
   //! Currently active controllerstate on the HW Controller (indicates if PWM active etc.)
   SVHControllerState m_controller_state;
@@ -281,6 +513,15 @@ private:
   //! Latest firmware info
   SVHFirmwareInfo m_firmware_info;
 
+  //! guards the firmware info, which is written by the receive thread
+  std::mutex m_firmware_info_mutex;
+
+  //! signals a received firmware info
+  std::condition_variable m_firmware_info_condition;
+
+  //! a firmware info was received since connecting
+  bool m_firmware_info_received;
+
   // Hardware control
 
   //! Serial interface for transmission and reveibing of data packets
@@ -292,6 +533,106 @@ private:
   //! store how many packages where actually received. Updated every time the receivepacket callback
   //! is called
   unsigned int m_received_package_count;
+
+  //! hand packets to the writer thread instead of sending them from the calling thread
+  std::atomic<bool> m_asynchronous_transmit;
+
+  //! latency of the last emergency stop in microseconds
+  std::atomic<int64_t> m_emergency_stop_latency;
+
+  //! matches requests with their responses during pipelined exchanges like the connect handshake
+  SVHRequestTracker m_request_tracker;
+
+  //! guards the command coalescing state below
+  std::mutex m_command_mutex;
+
+  //! keeps the command frames in order while they are sent without m_command_mutex
+  std::mutex m_command_transmit_mutex;
+
+  //! wakes up the command flusher on new targets and on stop
+  std::condition_variable m_command_condition;
+
+  //! last target that was sent or collected for each channel
+  std::vector<int32_t> m_command_targets;
+
+  //! channels that got a target since the start, others are sent with their current position
+  uint16_t m_command_known_mask;
+
+  //! channels with a collected target that was not sent yet
+  uint16_t m_command_pending_mask;
+
+  //! time the first pending target was collected
+  std::chrono::steady_clock::time_point m_command_pending_since;
+
+  //! coalescing window, 0 if targets are sent at once
+  std::chrono::microseconds m_command_window;
+
+  //! nesting depth of beginCommandBatch()
+  unsigned int m_command_batch_depth;
+
+  //! number of targets that were merged into frames for all channels
+  uint64_t m_coalesced_commands;
+
+  //! deadband of the targets in encoder ticks, negative if disabled
+  int32_t m_command_tolerance;
+
+  //! period after which a target is sent even if it lies within the deadband
+  std::chrono::steady_clock::duration m_command_keepalive;
+
+  //! time the target of each channel was last sent
+  std::vector<std::chrono::steady_clock::time_point> m_command_sent_times;
+
+  //! number of targets dropped by the deadband for each channel
+  std::vector<uint64_t> m_suppressed_commands;
+
+  //! true if the target lies within the deadband of the channel, m_command_mutex has to be held
+  bool isRedundantCommand(size_t channel,
+                          int32_t position,
+                          const std::chrono::steady_clock::time_point& now) const;
+
+  //! the command flusher sends pending targets once their window has passed
+  bool m_command_flusher_running;
+  std::thread m_command_flusher;
+
+  //! thread settings of the last connect, used for the command flusher
+  SVHThreadConfig m_thread_config;
+
+  //! starts the command flusher with its settings and collects what could not be applied
+  SVHThreadSetup m_thread_setup;
+
+  //! frames of the pending targets, at most one per channel
+  typedef std::array<SVHFixedSerialPacket, SVH_DIMENSION> SVHCommandPackets;
+
+  /*!
+   * \brief flushPendingCommands prepares the frames of the pending targets, preferably a single
+   *        frame for all channels. m_command_mutex has to be held.
+   * \param packets receives the frames
+   * \return number of prepared frames
+   */
+  size_t flushPendingCommands(SVHCommandPackets& packets);
+
+  //! sends prepared frames after releasing the held m_command_mutex, in the order of preparation
+  void transmitCommandPackets(std::unique_lock<std::mutex>& lock,
+                              SVHCommandPackets& packets,
+                              size_t count);
+
+  //! run method of the command flusher thread
+  void runCommandFlusher();
+
+  //! stops the command flusher thread, pending targets are sent
+  void stopCommandFlusher();
+
+  /*!
+   * \brief transmitPacket sends a packet directly or queues it, depending on the transmit mode
+   * \param packet the prepared Serial Packet
+   * \param hold_off time to wait after this packet before the next one may be sent
+   */
+  void transmitPacket(SVHSerialPacket& packet,
+                      const std::chrono::microseconds& hold_off = std::chrono::microseconds(0));
+
+  //! allocation free variant of transmitPacket() used on the command hot path
+  void transmitPacket(SVHFixedSerialPacket& packet,
+                      const std::chrono::microseconds& hold_off = std::chrono::microseconds(0));
 };
 
 } // namespace driver_svh
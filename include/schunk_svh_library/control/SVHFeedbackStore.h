@@ -0,0 +1,217 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains the feedback store that is shared between the receive
+ * thread and the user threads. The receive thread publishes the feedback of
+ * all channels with a sequence lock, readers take a consistent copy without
+ * ever blocking the writer. Every channel carries the receive time and a
+ * sequence number of its latest feedback so readers can judge its freshness.
+ * Readers that want to react on new feedback can block until it arrives.
+ */
+//----------------------------------------------------------------------
+#ifndef DRIVER_SVH_SVH_FEEDBACK_STORE_H_INCLUDED
+#define DRIVER_SVH_SVH_FEEDBACK_STORE_H_INCLUDED
+
+#include <schunk_svh_library/ImportExport.h>
+#include <schunk_svh_library/control/SVHControllerFeedback.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace driver_svh {
+
+//! Number of channels held by the feedback store
+const size_t C_FEEDBACK_CHANNELS = 9;
+
+//! Feedback of all channels taken at one point in time
+using SVHFeedbackSnapshot = std::array<SVHControllerFeedback, C_FEEDBACK_CHANNELS>;
+
+//! Sequence numbers of all channels
+using SVHFeedbackSequences = std::array<std::uint64_t, C_FEEDBACK_CHANNELS>;
+
+/*!
+ * \brief Latest feedback of one channel together with its receive time
+ */
+struct SVHFeedbackSample
+{
+  //! position and current of the channel
+  SVHControllerFeedback feedback;
+  //! number of feedback updates of the channel so far, 0 if none was received yet
+  std::uint64_t sequence;
+  //! monotonic time at which the feedback was received
+  std::chrono::steady_clock::time_point timestamp;
+
+  SVHFeedbackSample()
+    : feedback()
+    , sequence(0)
+    , timestamp()
+  {
+  }
+};
+
+/*!
+ * \brief Lock-free store of the latest controller feedback of all channels.
+ *
+ * Writes are guarded by a sequence counter that is odd while an update is in progress. Readers
+ * copy the values and retry if the counter was odd or changed in between, so they never see a
+ * half written update and never block the writer. All values are stored in fixed size atomics,
+ * nothing is reallocated after construction.
+ *
+ * Only one thread may write at a time (the receive thread), any number of threads may read.
+ * The writer only touches the mutex of the waiting readers if somebody actually waits.
+ */
+class DRIVER_SVH_IMPORT_EXPORT SVHFeedbackStore
+{
+public:
+  //! Constructs a store with zero position and current on all channels
+  SVHFeedbackStore();
+
+  /*!
+   * \brief store publishes the feedback of one channel and increments its sequence number
+   * \param channel channel the feedback belongs to, ignored if out of range
+   * \param feedback latest feedback of the channel
+   * \param timestamp time at which the feedback was received
+   */
+  void store(size_t channel,
+             const SVHControllerFeedback& feedback,
+             const std::chrono::steady_clock::time_point& timestamp);
+
+  /*!
+   * \brief storeAll publishes the feedback of all channels as one update
+   * \param feedbacks latest feedback, surplus elements are ignored and missing ones left unchanged
+   * \param timestamp time at which the feedback was received
+   */
+  void storeAll(const std::vector<SVHControllerFeedback>& feedbacks,
+                const std::chrono::steady_clock::time_point& timestamp);
+
+  /*!
+   * \brief load reads the latest feedback of one channel
+   * \param channel channel to read
+   * \param feedback latest feedback of the channel
+   * \return false if the channel is out of range
+   */
+  bool load(size_t channel, SVHControllerFeedback& feedback) const;
+
+  /*!
+   * \brief load reads the latest feedback of one channel with its sequence number and receive time
+   * \param channel channel to read
+   * \param sample latest feedback of the channel
+   * \return false if the channel is out of range
+   */
+  bool load(size_t channel, SVHFeedbackSample& sample) const;
+
+  //! returns the sequence number of the latest feedback of a channel, 0 if none or out of range
+  std::uint64_t sequence(size_t channel) const;
+
+  //! returns true if the channel received feedback after the one with the given sequence number
+  bool changedSince(size_t channel, std::uint64_t sequence) const
+  {
+    return this->sequence(channel) > sequence;
+  }
+
+  //! returns the sequence numbers of all channels
+  SVHFeedbackSequences sequences() const;
+
+  /*!
+   * \brief waitForUpdate blocks until a channel received feedback newer than a sequence number
+   * \param channel channel to wait for
+   * \param sequence sequence number of the last feedback the caller knows about
+   * \param deadline time at which to give up
+   * \return true if newer feedback arrived, false on timeout or for an unknown channel
+   */
+  bool waitForUpdate(size_t channel,
+                     std::uint64_t sequence,
+                     const std::chrono::steady_clock::time_point& deadline) const;
+
+  /*!
+   * \brief waitForAll blocks until every channel received feedback newer than the given sequences
+   * \param sequences sequence numbers of the last feedback the caller knows about
+   * \param deadline time at which to give up
+   * \return true if all channels were updated, false on timeout
+   */
+  bool waitForAll(const SVHFeedbackSequences& sequences,
+                  const std::chrono::steady_clock::time_point& deadline) const;
+
+  //! returns a consistent copy of the feedback of all channels
+  SVHFeedbackSnapshot snapshot() const;
+
+  /*!
+   * \brief loadAll copies a consistent snapshot into a vector
+   * \param feedbacks resized to the number of channels, does not allocate if already large enough
+   */
+  void loadAll(std::vector<SVHControllerFeedback>& feedbacks) const;
+
+private:
+  //! opens a write section, the version is odd until endWrite() is called
+  void beginWrite();
+
+  //! closes a write section and publishes the written values
+  void endWrite();
+
+  //! writes the values of one channel, only valid inside a write section
+  void write(size_t channel, const SVHControllerFeedback& feedback, std::int64_t timestamp);
+
+  //! wakes up blocked readers after an update, does nothing if nobody is waiting
+  void notifyWaiters();
+
+  //! waits on the condition until the predicate holds or the deadline passes
+  template <typename Predicate>
+  bool waitUntil(const std::chrono::steady_clock::time_point& deadline, Predicate predicate) const;
+
+  //! version counter of the sequence lock, odd while a write is in progress
+  std::atomic<std::uint32_t> m_version;
+
+  //! latest position of every channel
+  std::array<std::atomic<std::int32_t>, C_FEEDBACK_CHANNELS> m_positions;
+
+  //! latest current of every channel
+  std::array<std::atomic<std::int16_t>, C_FEEDBACK_CHANNELS> m_currents;
+
+  //! number of feedback updates of every channel
+  std::array<std::atomic<std::uint64_t>, C_FEEDBACK_CHANNELS> m_sequences;
+
+  //! receive time of the latest feedback of every channel in steady clock ticks
+  std::array<std::atomic<std::int64_t>, C_FEEDBACK_CHANNELS> m_timestamps;
+
+  //! number of readers blocked in one of the wait functions
+  mutable std::atomic<unsigned int> m_waiters;
+
+  //! mutex and condition the blocked readers wait on
+  mutable std::mutex m_wait_mutex;
+  mutable std::condition_variable m_wait_condition;
+};
+
+} // namespace driver_svh
+
+#endif
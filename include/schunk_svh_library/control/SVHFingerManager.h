@@ -43,13 +43,21 @@
 #include <schunk_svh_library/control/SVHCurrentSettings.h>
 #include <schunk_svh_library/control/SVHHomeSettings.h>
 #include <schunk_svh_library/control/SVHPositionSettings.h>
+#include <schunk_svh_library/control/SVHTrajectory.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <thread>
 
 
 namespace driver_svh {
 
+//! Highest rate at which feedback can be polled. Feedback requests may use half of the link by
+//! default, which carries about 1280 frames per second.
+const double C_FEEDBACK_POLLING_MAX_RATE = 500.0;
+
 /*! This class manages controller parameters and the finger reset.
  */
 class DRIVER_SVH_IMPORT_EXPORT SVHFingerManager
@@ -95,9 +103,19 @@ public:
    *  \brief Open connection to SCHUNK five finger hand. Wait until expected return packages are
    * received. \param dev_name file handle of the serial device e.g. "/dev/ttyUSB0" \param
    * _retry_count The number of times a connection is tried to be established if at least one
-   * package was received \return true if connection was succesful
+   * package was received \param thread_config scheduling settings of all threads, settings that
+   * cannot be applied are reported by getThreadSetupFailures() \return true if connection was
+   * succesful
    */
-  bool connect(const std::string& dev_name = "/dev/ttyUSB0", const unsigned int& retry_count = 3);
+  bool connect(const std::string& dev_name          = "/dev/ttyUSB0",
+               const unsigned int& retry_count      = 3,
+               const SVHThreadConfig& thread_config = SVHThreadConfig());
+
+  //!
+  //! \brief getThreadSetupFailures lists the thread settings of the last connect that could not
+  //! be applied, e.g. a real-time policy without the privileges for it
+  //!
+  std::vector<SVHThreadSetupFailure> getThreadSetupFailures() const;
 
   //!
   //! \brief disconnect SCHUNK five finger hand
@@ -117,6 +135,46 @@ public:
   //!
   bool resetChannel(const SVHChannel& channel);
 
+  //!
+  //! \brief setResetGroups enables concurrent homing for resetChannel(SVH_ALL). The groups are
+  //! homed one after another in the given order, all channels of one group at the same time off
+  //! the shared feedback of all channels. Only put mechanically independent channels into one
+  //! group, ordering constraints (e.g. the finger spread before the fingers) are expressed by the
+  //! order of the groups. Channels that are not part of any group are homed one by one afterwards.
+  //! \param groups groups of channels, an empty vector restores homing channel by channel
+  //! \return false if a channel is unknown or part of more than one group, nothing is changed then
+  //!
+  bool setResetGroups(const std::vector<std::vector<SVHChannel> >& groups);
+
+  //!
+  //! \brief saveHomingCalibration stores the soft limits and home positions found by homing,
+  //! together with the device name and firmware version of the hand and the current encoder
+  //! positions
+  //! \param file_name path of the calibration file, it is overwritten
+  //! \return true if all channels were homed, their positions are known and the file could be
+  //! written. Always false in pump mode.
+  //!
+  bool saveHomingCalibration(const std::string& file_name);
+
+  //!
+  //! \brief loadHomingCalibration restores a saved homing calibration instead of homing again. It
+  //! is only accepted for the same device and firmware and if every encoder still reads the
+  //! position that was saved. After a power cycle the encoders restart at zero, so the calibration
+  //! is rejected then.
+  //! \param file_name path of the calibration file
+  //! \return true if the calibration was valid, all channels are homed then. Always false in
+  //! pump mode, the hand can only be identified before pump mode is entered.
+  //!
+  bool loadHomingCalibration(const std::string& file_name);
+
+  //!
+  //! \brief setHomingCalibrationCache makes resetChannel(SVH_ALL) try the given calibration file
+  //! before homing and save a new one after a successful homing. The file is updated with the
+  //! last encoder positions on disconnect.
+  //! \param file_name path of the calibration file, empty to always home
+  //!
+  void setHomingCalibrationCache(const std::string& file_name);
+
   //!
   //! \brief enable controller of channel
   //! \param channel channel to enable
@@ -126,10 +184,19 @@ public:
 
   //!
   //! \brief disable controller of channel
+  //!
+  //! Disabling all channels stops a running trajectory and is sent as an emergency stop ahead of
+  //! all queued packets.
   //! \param channel channel to disable
   //!
   void disableChannel(const SVHChannel& channel);
 
+  //!
+  //! \brief getEmergencyStopLatency returns the time the last disableChannel(SVH_ALL) took until
+  //! its frame was handed to the serial device
+  //!
+  std::chrono::microseconds getEmergencyStopLatency();
+
   //!
   //! \brief sends request controller feedback packet for all channels
   //! \return true if the request was successfully send to the hardware
@@ -178,6 +245,135 @@ public:
   //!
   bool setTargetPosition(const SVHChannel& channel, double position, double current);
 
+  //!
+  //! \brief setCommandCoalescing merges the targets of setTargetPosition() calls that follow each
+  //! other within the window into one frame for all channels. See
+  //! SVHController::setCommandCoalescing()
+  //! \param window time targets are collected after the first one, 0 to disable coalescing
+  //!
+  void setCommandCoalescing(const std::chrono::microseconds& window);
+
+  //!
+  //! \brief beginCommandBatch collects the targets of all following setTargetPosition() calls
+  //! until commitCommandBatch() sends them as one frame
+  //!
+  void beginCommandBatch();
+
+  //! sends the targets collected since beginCommandBatch()
+  void commitCommandBatch();
+
+  //!
+  //! \brief setCommandDeadband drops targets that are within the tolerance of the last target of
+  //! their channel, except for a keepalive. See SVHController::setCommandDeadband()
+  //! \param tolerance tolerance in encoder ticks, a negative tolerance disables the deadband
+  //! \param keepalive period after which a redundant target is sent nevertheless
+  //!
+  void setCommandDeadband(int32_t tolerance, const std::chrono::milliseconds& keepalive);
+
+  //!
+  //! \brief getSuppressedCommandCount returns the number of targets dropped by the deadband
+  //! \param channel channel to get the count for, SVH_ALL for the sum of all channels
+  //! \return number of dropped targets
+  //!
+  uint64_t getSuppressedCommandCount(const SVHChannel& channel);
+
+  //!
+  //! \brief executeTrajectory streams an interpolated trajectory to the hand. A dedicated thread
+  //! samples the trajectory at the trajectory rate and sends the targets of all channels at once.
+  //! Every target is kept within the soft limits found during homing and the reference limits of
+  //! the position settings, and no channel moves faster than the dwmx of its position settings.
+  //! A running trajectory is stopped first.
+  //! \param waypoints timed waypoints with one position in [rad] per channel. If the first
+  //! waypoint is not at time 0 the trajectory starts at the current position of the fingers.
+  //! \param interpolation interpolation between the waypoints
+  //! \return true if the trajectory was valid and inside the bounds and is executed now
+  //!
+  bool executeTrajectory(const std::vector<SVHTrajectoryWaypoint>& waypoints,
+                         SVHInterpolation interpolation = SVH_INTERPOLATION_CUBIC);
+
+  //! stops a running trajectory, the fingers stay at the last sent targets
+  void stopTrajectory();
+
+  //! true while a trajectory is executed
+  bool isTrajectoryActive() const { return m_trajectory_active; }
+
+  //!
+  //! \brief waitForTrajectory blocks until the running trajectory was executed or stopped
+  //! \param timeout maximum time to wait
+  //! \return true if no trajectory is active anymore
+  //!
+  bool waitForTrajectory(const std::chrono::milliseconds& timeout);
+
+  //!
+  //! \brief setTrajectoryRate sets the rate at which trajectories are streamed to the hand. It is
+  //! used by the next call to executeTrajectory().
+  //! \param rate rate in [Hz], at most C_TRAJECTORY_MAX_RATE
+  //! \return true if the rate was valid
+  //!
+  bool setTrajectoryRate(double rate);
+
+  //! number of stream cycles whose deadline was missed and which were skipped
+  uint64_t getTrajectoryDeadlineMisses() const { return m_trajectory_deadline_misses; }
+
+  //!
+  //! \brief setFeedbackPollingRate sets the rate at which the feedback of all channels is
+  //! requested. A running polling thread picks it up after its next poll, a reactor right away.
+  //! \param rate rate in [Hz], at most C_FEEDBACK_POLLING_MAX_RATE
+  //! \return true if the rate was valid
+  //!
+  bool setFeedbackPollingRate(double rate);
+
+  //!
+  //! \brief setAdaptiveFeedbackPolling skips polls while the feedback is fresh anyway
+  //!
+  //! The hand answers every target with the feedback of the commanded channels. While targets are
+  //! streamed at least at the polling rate no polls are sent, once the hand is idle polling
+  //! resumes.
+  //! \param enable true to skip polls if all channels received feedback within the last period
+  //!
+  void setAdaptiveFeedbackPolling(bool enable);
+
+  //! number of polls that were skipped because all feedback was fresh
+  uint64_t getSkippedFeedbackPolls() const { return m_skipped_feedback_polls; }
+
+  //!
+  //! \brief setPumpMode hands the communication to an external real-time loop
+  //!
+  //! Connecting and homing need the own threads, so pump mode is entered once the hand is
+  //! connected. The feedback thread and the threads of the serial interface are stopped and the
+  //! loop calls read() and write() once per cycle instead. Disconnecting leaves pump mode.
+  //! \param enable true to pump from the caller's thread, false to restart the threads
+  //! \return false if pump mode was requested without a connected hand
+  //!
+  bool setPumpMode(bool enable);
+
+  //!
+  //! \brief setReactor lets one reactor thread do all communication from the next connect() on
+  //!
+  //! The reactor replaces the receive, writer and feedback threads: it parses the received bytes,
+  //! paces the transmitted packets and polls the feedback with a timer. One thread is easier to
+  //! prioritize and causes fewer context switches. Several hands can share one reactor, see
+  //! SVHReactorPool. Their thread count stays the same and hands polling at the same rate share
+  //! the wakeups of one timer.
+  //! \param reactor reactor to use, NULL to use the own threads (default)
+  //! \return false if the hand is connected, the reactor can only be changed before
+  //!
+  bool setReactor(const std::shared_ptr<SVHReactor>& reactor);
+
+  //!
+  //! \brief read processes the bytes received since the last call without waiting. Only does
+  //! something in pump mode.
+  //! \return number of bytes processed
+  //!
+  size_t read();
+
+  //!
+  //! \brief write requests feedback at the polling rate and sends the queued packets that are
+  //! due, without waiting. Only does something in pump mode.
+  //! \return number of packets written
+  //!
+  size_t write();
+
   //!
   //! \brief returns true, if current channel has been enabled
   //! \param channel channel to check if it is enabled
@@ -288,6 +484,13 @@ public:
   //!
   void setResetTimeout(const int& reset_timeout);
 
+  //!
+  //! \brief setHomingTimeout sets the time after which homing a channel is aborted if it does not
+  //! move anymore or does not reach its idle position
+  //! \param homing_timeout timeout in Seconds. Values smaler than 1 will be interpreted as 1
+  //!
+  void setHomingTimeout(const int& homing_timeout);
+
   //!
   //! \brief setMaxForce set the max force / current as a persentage of the maximum possible current
   //! \param max_force in percent [0,1]
@@ -337,6 +540,40 @@ private:
   //! \brief Thread for polling periodic feedback from the hardware
   std::thread m_feedback_thread;
 
+  //! \brief thread settings of the current connection
+  SVHThreadConfig m_thread_config;
+
+  //! \brief starts the feedback and trajectory threads with their settings
+  SVHThreadSetup m_thread_setup;
+
+  //! \brief time between two feedback polls in microseconds
+  std::atomic<int64_t> m_feedback_period;
+
+  //! \brief skip polls while all channels receive feedback anyway
+  std::atomic<bool> m_adaptive_feedback;
+
+  //! \brief number of polls skipped in adaptive mode
+  std::atomic<uint64_t> m_skipped_feedback_polls;
+
+  //! \brief feedback sequences at the last poll decision, only used by the active poller
+  SVHFeedbackSequences m_poll_sequences;
+
+  //! \brief true if the last poll decision sent a poll
+  bool m_poll_sent;
+
+  //! \brief wakes up the feedback thread when polling is stopped
+  std::mutex m_feedback_mutex;
+  std::condition_variable m_feedback_condition;
+
+  //! \brief time of the next feedback poll in pump mode
+  std::chrono::steady_clock::time_point m_pump_next_poll;
+
+  //! \brief reactor used by the next connect(), may be NULL
+  std::shared_ptr<SVHReactor> m_reactor;
+
+  //! \brief periodic reactor handler polling the feedback, -1 if polled by the feedback thread
+  std::atomic<int> m_feedback_timer;
+
   //! \brief holds the connected state
   bool m_connected;
 
@@ -425,6 +662,38 @@ private:
   //! \brief vector storing the reset order of the channels
   std::vector<SVHChannel> m_reset_order;
 
+  //! \brief groups of channels that are homed concurrently, empty to home channel by channel
+  std::vector<std::vector<SVHChannel> > m_reset_groups;
+
+  //! \brief calibration file used by resetChannel(SVH_ALL), empty to always home
+  std::string m_homing_calibration_cache;
+
+  //! \brief Thread streaming the active trajectory
+  std::thread m_trajectory_thread;
+
+  //! \brief trajectory that is streamed, positions are given in ticks
+  SVHTrajectory m_trajectory;
+
+  //! \brief true while the trajectory thread streams
+  std::atomic<bool> m_trajectory_active;
+
+  //! \brief time between two streamed targets
+  std::chrono::microseconds m_trajectory_period;
+
+  //! \brief lower and upper target limit in ticks of each channel during a trajectory
+  std::vector<double> m_trajectory_min;
+  std::vector<double> m_trajectory_max;
+
+  //! \brief maximum velocity in ticks per second of each channel, 0 if unlimited
+  std::vector<double> m_trajectory_max_velocity;
+
+  //! \brief number of skipped stream cycles
+  std::atomic<uint64_t> m_trajectory_deadline_misses;
+
+  //! \brief wakes up the trajectory thread on stop and waiters on the end of a trajectory
+  std::mutex m_trajectory_mutex;
+  std::condition_variable m_trajectory_condition;
+
   /*!
    * \brief Vector containing factors for the currents at reset.
    * Vector containing factors for the currents at reset.
@@ -474,6 +743,31 @@ private:
   bool currentSettingsAreSafe(const SVHChannel& channel,
                               const SVHCurrentSettings& current_settings);
 
+  //! \brief resetChannelWithRetries resets a single channel, trying up to three times
+  bool resetChannelWithRetries(const SVHChannel& channel);
+
+  //! \brief resetChannelGroups homes all channels group by group as configured by setResetGroups()
+  bool resetChannelGroups();
+
+  /*!
+   * \brief resetChannelGroup drives all channels of a group to their hard stops at the same time
+   * and evaluates the hit count of every channel on the shared feedback of all channels
+   * \param channels channels to home concurrently
+   * \param failed channels that did not find their hard stop in time
+   * \return true if no channel failed
+   */
+  bool resetChannelGroup(const std::vector<SVHChannel>& channels, std::vector<SVHChannel>& failed);
+
+  //! \brief updateResetDiagnostics tracks current extremes and deadlocks while homing a channel
+  void updateResetDiagnostics(const SVHChannel& channel,
+                              const SVHHomeSettings& home,
+                              const SVHControllerFeedback& feedback);
+
+  //! \brief setHomeReference sets the soft limits and home position from the hard stop position
+  void setHomeReference(const SVHChannel& channel,
+                        const SVHHomeSettings& home,
+                        const SVHControllerFeedback& feedback);
+
   /**
    * \brief Periodically poll feedback from the hardware
    *
@@ -482,6 +776,33 @@ private:
    */
   void pollFeedback();
 
+  //! \brief (Re)starts the feedback polling thread, or the reactor timer if a reactor is used
+  void startFeedbackPolling();
+
+  //! \brief Stops the feedback polling thread or timer and waits for it to finish
+  void stopFeedbackPolling();
+
+  //! \brief polls the feedback with a periodic handler of the reactor, false on failure
+  bool startReactorFeedbackPolling();
+
+  /*!
+   * \brief true if every channel that is not switched off received feedback within max_age that
+   *        was not the reply to the last own poll
+   * \param max_age maximum age of the feedback
+   * \param sequences current feedback sequences of all channels
+   */
+  bool isFeedbackFresh(const std::chrono::microseconds& max_age,
+                       const SVHFeedbackSequences& sequences);
+
+  //! \brief requests the feedback of all channels and waits for it, false if none arrived
+  bool requestFeedbackSnapshot(SVHFeedbackSnapshot& feedback);
+
+  //! \brief requests the feedback of all channels unless adaptive polling finds it fresh
+  void requestFeedbackPoll(const std::chrono::microseconds& period);
+
+  //! \brief Streams m_trajectory with absolute deadlines until it is executed or stopped
+  void streamTrajectory();
+
   // DEBUG
   SVHControllerFeedback m_debug_feedback;
 };
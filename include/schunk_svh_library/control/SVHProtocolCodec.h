@@ -0,0 +1,445 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains the compile time codec of the SVH protocol. Every payload
+ * structure has a fixed wire layout which is described by a specialization of
+ * SVHWireLayout. Encoding and decoding is straight-line code on the raw payload
+ * bytes and every address is bound to the payload types it carries, so a packet
+ * can neither be filled with the wrong structure nor be misparsed if truncated.
+ */
+//----------------------------------------------------------------------
+#ifndef SVHPROTOCOLCODEC_H
+#define SVHPROTOCOLCODEC_H
+
+#include <schunk_svh_library/SVHFirmwareInfo.h>
+#include <schunk_svh_library/control/SVHControlCommand.h>
+#include <schunk_svh_library/control/SVHControllerFeedback.h>
+#include <schunk_svh_library/control/SVHControllerState.h>
+#include <schunk_svh_library/control/SVHCurrentSettings.h>
+#include <schunk_svh_library/control/SVHEncoderSettings.h>
+#include <schunk_svh_library/control/SVHPositionSettings.h>
+#include <schunk_svh_library/serial/ByteOrderConversion.h>
+#include <schunk_svh_library/serial/SVHSerialPacket.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace driver_svh {
+
+//! Number of channels in every message that addresses all channels at once
+const size_t C_CODEC_CHANNELS = 9;
+
+//! Payload of requests that do not carry any data (all SVH_GET_* requests)
+struct SVHNoPayload
+{
+};
+
+/*!
+ * \brief SVHWireLayout describes the fixed wire layout of one payload type.
+ *
+ * Every specialization provides size() as compile time constant and encode()/decode() working
+ * on at least size() raw payload bytes.
+ */
+template <typename Message>
+struct SVHWireLayout;
+
+template <>
+struct SVHWireLayout<SVHNoPayload>
+{
+  static constexpr size_t size() { return 0; }
+  static void encode(const SVHNoPayload&, std::uint8_t*) {}
+  static void decode(const std::uint8_t*, SVHNoPayload&) {}
+};
+
+template <>
+struct SVHWireLayout<SVHControlCommand>
+{
+  static constexpr size_t size() { return 4; }
+  static void encode(const SVHControlCommand& message, std::uint8_t* data)
+  {
+    writeLittleEndian(message.position, data);
+  }
+  static void decode(const std::uint8_t* data, SVHControlCommand& message)
+  {
+    message.position = readLittleEndian<int32_t>(data);
+  }
+};
+
+template <>
+struct SVHWireLayout<SVHControlCommandAllChannels>
+{
+  static constexpr size_t size() { return C_CODEC_CHANNELS * 4; }
+  static void encode(const SVHControlCommandAllChannels& message, std::uint8_t* data)
+  {
+    const size_t channels = std::min(message.commands.size(), C_CODEC_CHANNELS);
+    for (size_t i = 0; i < channels; ++i)
+    {
+      writeLittleEndian(message.commands[i].position, data + 4 * i);
+    }
+  }
+  static void decode(const std::uint8_t* data, SVHControlCommandAllChannels& message)
+  {
+    message.commands.resize(C_CODEC_CHANNELS);
+    for (size_t i = 0; i < C_CODEC_CHANNELS; ++i)
+    {
+      message.commands[i].position = readLittleEndian<int32_t>(data + 4 * i);
+    }
+  }
+};
+
+template <>
+struct SVHWireLayout<SVHControllerFeedback>
+{
+  static constexpr size_t size() { return 6; }
+  static void encode(const SVHControllerFeedback& message, std::uint8_t* data)
+  {
+    writeLittleEndian(message.position, data);
+    writeLittleEndian(message.current, data + 4);
+  }
+  static void decode(const std::uint8_t* data, SVHControllerFeedback& message)
+  {
+    message.position = readLittleEndian<int32_t>(data);
+    message.current  = readLittleEndian<int16_t>(data + 4);
+  }
+};
+
+//! All positions are transmitted first, followed by all currents
+template <>
+struct SVHWireLayout<SVHControllerFeedbackAllChannels>
+{
+  static constexpr size_t size() { return C_CODEC_CHANNELS * 6; }
+  static void encode(const SVHControllerFeedbackAllChannels& message, std::uint8_t* data)
+  {
+    const size_t channels = std::min(message.feedbacks.size(), C_CODEC_CHANNELS);
+    for (size_t i = 0; i < channels; ++i)
+    {
+      writeLittleEndian(message.feedbacks[i].position, data + 4 * i);
+      writeLittleEndian(message.feedbacks[i].current, data + 4 * C_CODEC_CHANNELS + 2 * i);
+    }
+  }
+  static void decode(const std::uint8_t* data, SVHControllerFeedbackAllChannels& message)
+  {
+    decode(data, message.feedbacks);
+  }
+  //! decodes in place into an existing feedback vector, does not allocate if it has 9 elements
+  static void decode(const std::uint8_t* data, std::vector<SVHControllerFeedback>& feedbacks)
+  {
+    feedbacks.resize(C_CODEC_CHANNELS);
+    for (size_t i = 0; i < C_CODEC_CHANNELS; ++i)
+    {
+      feedbacks[i].position = readLittleEndian<int32_t>(data + 4 * i);
+      feedbacks[i].current  = readLittleEndian<int16_t>(data + 4 * C_CODEC_CHANNELS + 2 * i);
+    }
+  }
+};
+
+template <>
+struct SVHWireLayout<SVHPositionSettings>
+{
+  static constexpr size_t size() { return 10 * 4; }
+  static void encode(const SVHPositionSettings& message, std::uint8_t* data)
+  {
+    writeLittleEndian(message.wmn, data);
+    writeLittleEndian(message.wmx, data + 4);
+    writeLittleEndian(message.dwmx, data + 8);
+    writeLittleEndian(message.ky, data + 12);
+    writeLittleEndian(message.dt, data + 16);
+    writeLittleEndian(message.imn, data + 20);
+    writeLittleEndian(message.imx, data + 24);
+    writeLittleEndian(message.kp, data + 28);
+    writeLittleEndian(message.ki, data + 32);
+    writeLittleEndian(message.kd, data + 36);
+  }
+  static void decode(const std::uint8_t* data, SVHPositionSettings& message)
+  {
+    message.wmn  = readLittleEndian<float>(data);
+    message.wmx  = readLittleEndian<float>(data + 4);
+    message.dwmx = readLittleEndian<float>(data + 8);
+    message.ky   = readLittleEndian<float>(data + 12);
+    message.dt   = readLittleEndian<float>(data + 16);
+    message.imn  = readLittleEndian<float>(data + 20);
+    message.imx  = readLittleEndian<float>(data + 24);
+    message.kp   = readLittleEndian<float>(data + 28);
+    message.ki   = readLittleEndian<float>(data + 32);
+    message.kd   = readLittleEndian<float>(data + 36);
+  }
+};
+
+template <>
+struct SVHWireLayout<SVHCurrentSettings>
+{
+  static constexpr size_t size() { return 10 * 4; }
+  static void encode(const SVHCurrentSettings& message, std::uint8_t* data)
+  {
+    writeLittleEndian(message.wmn, data);
+    writeLittleEndian(message.wmx, data + 4);
+    writeLittleEndian(message.ky, data + 8);
+    writeLittleEndian(message.dt, data + 12);
+    writeLittleEndian(message.imn, data + 16);
+    writeLittleEndian(message.imx, data + 20);
+    writeLittleEndian(message.kp, data + 24);
+    writeLittleEndian(message.ki, data + 28);
+    writeLittleEndian(message.umn, data + 32);
+    writeLittleEndian(message.umx, data + 36);
+  }
+  static void decode(const std::uint8_t* data, SVHCurrentSettings& message)
+  {
+    message.wmn = readLittleEndian<float>(data);
+    message.wmx = readLittleEndian<float>(data + 4);
+    message.ky  = readLittleEndian<float>(data + 8);
+    message.dt  = readLittleEndian<float>(data + 12);
+    message.imn = readLittleEndian<float>(data + 16);
+    message.imx = readLittleEndian<float>(data + 20);
+    message.kp  = readLittleEndian<float>(data + 24);
+    message.ki  = readLittleEndian<float>(data + 28);
+    message.umn = readLittleEndian<float>(data + 32);
+    message.umx = readLittleEndian<float>(data + 36);
+  }
+};
+
+template <>
+struct SVHWireLayout<SVHControllerState>
+{
+  static constexpr size_t size() { return 6 * 2; }
+  static void encode(const SVHControllerState& message, std::uint8_t* data)
+  {
+    writeLittleEndian(message.pwm_fault, data);
+    writeLittleEndian(message.pwm_otw, data + 2);
+    writeLittleEndian(message.pwm_reset, data + 4);
+    writeLittleEndian(message.pwm_active, data + 6);
+    writeLittleEndian(message.pos_ctrl, data + 8);
+    writeLittleEndian(message.cur_ctrl, data + 10);
+  }
+  static void decode(const std::uint8_t* data, SVHControllerState& message)
+  {
+    message.pwm_fault  = readLittleEndian<uint16_t>(data);
+    message.pwm_otw    = readLittleEndian<uint16_t>(data + 2);
+    message.pwm_reset  = readLittleEndian<uint16_t>(data + 4);
+    message.pwm_active = readLittleEndian<uint16_t>(data + 6);
+    message.pos_ctrl   = readLittleEndian<uint16_t>(data + 8);
+    message.cur_ctrl   = readLittleEndian<uint16_t>(data + 10);
+  }
+};
+
+template <>
+struct SVHWireLayout<SVHEncoderSettings>
+{
+  static constexpr size_t size() { return C_CODEC_CHANNELS * 4; }
+  static void encode(const SVHEncoderSettings& message, std::uint8_t* data)
+  {
+    const size_t channels = std::min(message.scalings.size(), C_CODEC_CHANNELS);
+    for (size_t i = 0; i < channels; ++i)
+    {
+      writeLittleEndian(message.scalings[i], data + 4 * i);
+    }
+  }
+  static void decode(const std::uint8_t* data, SVHEncoderSettings& message)
+  {
+    message.scalings.resize(C_CODEC_CHANNELS);
+    for (size_t i = 0; i < C_CODEC_CHANNELS; ++i)
+    {
+      message.scalings[i] = readLittleEndian<uint32_t>(data + 4 * i);
+    }
+  }
+};
+
+//! 4 characters hardware name, major and minor version and 48 characters of text
+template <>
+struct SVHWireLayout<SVHFirmwareInfo>
+{
+  static constexpr size_t size() { return 4 + 2 + 2 + 48; }
+  static void encode(const SVHFirmwareInfo& message, std::uint8_t* data)
+  {
+    const size_t svh_size  = std::min<size_t>(message.svh.size(), 4);
+    const size_t text_size = std::min<size_t>(message.text.size(), 48);
+    std::copy(message.svh.begin(), message.svh.begin() + svh_size, data);
+    writeLittleEndian(message.version_major, data + 4);
+    writeLittleEndian(message.version_minor, data + 6);
+    std::copy(message.text.begin(), message.text.begin() + text_size, data + 8);
+  }
+  static void decode(const std::uint8_t* data, SVHFirmwareInfo& message)
+  {
+    message.svh.assign(data, data + 4);
+    message.version_major = readLittleEndian<uint16_t>(data + 4);
+    message.version_minor = readLittleEndian<uint16_t>(data + 6);
+    message.text.assign(data + 8, data + 56);
+  }
+};
+
+//! Payload type that is sent to the hand with a given address
+template <std::uint8_t Address>
+struct SVHRequestPayload
+{
+  typedef SVHNoPayload type;
+};
+template <>
+struct SVHRequestPayload<SVH_SET_CONTROL_COMMAND>
+{
+  typedef SVHControlCommand type;
+};
+template <>
+struct SVHRequestPayload<SVH_SET_CONTROL_COMMAND_ALL>
+{
+  typedef SVHControlCommandAllChannels type;
+};
+template <>
+struct SVHRequestPayload<SVH_SET_POSITION_SETTINGS>
+{
+  typedef SVHPositionSettings type;
+};
+template <>
+struct SVHRequestPayload<SVH_SET_CURRENT_SETTINGS>
+{
+  typedef SVHCurrentSettings type;
+};
+template <>
+struct SVHRequestPayload<SVH_SET_CONTROLLER_STATE>
+{
+  typedef SVHControllerState type;
+};
+template <>
+struct SVHRequestPayload<SVH_SET_ENCODER_VALUES>
+{
+  typedef SVHEncoderSettings type;
+};
+
+//! Payload type the hand answers with for a given address, GET and SET share the answer
+template <std::uint8_t Address>
+struct SVHResponsePayload;
+template <>
+struct SVHResponsePayload<SVH_GET_CONTROL_FEEDBACK>
+{
+  typedef SVHControllerFeedback type;
+};
+template <>
+struct SVHResponsePayload<SVH_SET_CONTROL_COMMAND> : SVHResponsePayload<SVH_GET_CONTROL_FEEDBACK>
+{
+};
+template <>
+struct SVHResponsePayload<SVH_GET_CONTROL_FEEDBACK_ALL>
+{
+  typedef SVHControllerFeedbackAllChannels type;
+};
+template <>
+struct SVHResponsePayload<SVH_SET_CONTROL_COMMAND_ALL>
+  : SVHResponsePayload<SVH_GET_CONTROL_FEEDBACK_ALL>
+{
+};
+template <>
+struct SVHResponsePayload<SVH_GET_POSITION_SETTINGS>
+{
+  typedef SVHPositionSettings type;
+};
+template <>
+struct SVHResponsePayload<SVH_SET_POSITION_SETTINGS> : SVHResponsePayload<SVH_GET_POSITION_SETTINGS>
+{
+};
+template <>
+struct SVHResponsePayload<SVH_GET_CURRENT_SETTINGS>
+{
+  typedef SVHCurrentSettings type;
+};
+template <>
+struct SVHResponsePayload<SVH_SET_CURRENT_SETTINGS> : SVHResponsePayload<SVH_GET_CURRENT_SETTINGS>
+{
+};
+template <>
+struct SVHResponsePayload<SVH_GET_CONTROLLER_STATE>
+{
+  typedef SVHControllerState type;
+};
+template <>
+struct SVHResponsePayload<SVH_SET_CONTROLLER_STATE> : SVHResponsePayload<SVH_GET_CONTROLLER_STATE>
+{
+};
+template <>
+struct SVHResponsePayload<SVH_GET_ENCODER_VALUES>
+{
+  typedef SVHEncoderSettings type;
+};
+template <>
+struct SVHResponsePayload<SVH_SET_ENCODER_VALUES> : SVHResponsePayload<SVH_GET_ENCODER_VALUES>
+{
+};
+template <>
+struct SVHResponsePayload<SVH_GET_FIRMWARE_INFO>
+{
+  typedef SVHFirmwareInfo type;
+};
+
+/*!
+ * \brief encodeRequest builds a request packet for a compile time address. Passing a payload that
+ * does not belong to the address or does not fit into a packet fails to compile.
+ * \param message payload to send
+ * \param channel channel encoded in the upper nibble of the address
+ * \return packet ready to be sent, the payload is zero padded
+ */
+template <std::uint8_t Address>
+SVHFixedSerialPacket encodeRequest(const typename SVHRequestPayload<Address>::type& message,
+                                   std::uint8_t channel = 0)
+{
+  typedef SVHWireLayout<typename SVHRequestPayload<Address>::type> Layout;
+  static_assert(Layout::size() <= C_PACKET_DATA_SIZE, "Payload does not fit into a packet");
+
+  SVHFixedSerialPacket packet(static_cast<std::uint8_t>(Address | (channel << 4)));
+  Layout::encode(message, packet.data.data());
+  return packet;
+}
+
+//! \brief encodeRequest for requests without payload
+template <std::uint8_t Address>
+SVHFixedSerialPacket encodeRequest(std::uint8_t channel = 0)
+{
+  return encodeRequest<Address>(SVHNoPayload(), channel);
+}
+
+/*!
+ * \brief decodeResponse decodes the payload of a received packet for a compile time address
+ * \param data payload of the received packet
+ * \param message decoded payload, untouched if the payload is too short
+ * \return false if the payload is shorter than the wire layout of the message
+ */
+template <std::uint8_t Address, typename Message>
+bool decodeResponse(const std::vector<std::uint8_t>& data, Message& message)
+{
+  typedef typename SVHResponsePayload<Address>::type Payload;
+  typedef SVHWireLayout<Payload> Layout;
+  static_assert(Layout::size() <= C_PACKET_DATA_SIZE, "Payload does not fit into a packet");
+
+  if (data.size() < Layout::size())
+  {
+    return false;
+  }
+  Layout::decode(data.data(), message);
+  return true;
+}
+
+} // namespace driver_svh
+
+#endif // SVHPROTOCOLCODEC_H
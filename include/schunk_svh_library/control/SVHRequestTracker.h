@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains the request tracker that matches sent requests with the
+ * responses of the SVH. The hand echoes index and address of every request in
+ * its response, so several requests can be in flight at once and the caller
+ * can wait until the last of them is acknowledged. Requests without an
+ * acknowledgement can be handed back for a retransmission.
+ */
+//----------------------------------------------------------------------
+#ifndef DRIVER_SVH_SVH_REQUEST_TRACKER_H_INCLUDED
+#define DRIVER_SVH_SVH_REQUEST_TRACKER_H_INCLUDED
+
+#include <schunk_svh_library/ImportExport.h>
+#include <schunk_svh_library/serial/SVHSerialPacket.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace driver_svh {
+
+//! Number of responses that are kept while their request is not recorded yet
+const size_t C_TRACKER_UNMATCHED_RESPONSES = 64;
+
+/*!
+ * \brief Keeps track of requests that wait for their response
+ *
+ * Requests are recorded after they were written, i.e. once their index is known. A fast hand
+ * may answer before that happens, so responses that match no request are kept for a short while
+ * and are matched once the request is recorded.
+ */
+class DRIVER_SVH_IMPORT_EXPORT SVHRequestTracker
+{
+public:
+  SVHRequestTracker();
+
+  //! forgets all requests and responses and starts recording new requests
+  void start();
+
+  //! stops recording requests, responses are ignored afterwards
+  void stop();
+
+  //! true while requests are recorded
+  bool isActive() const { return m_active.load(std::memory_order_acquire); }
+
+  //!
+  //! \brief records a request that was written with its final index
+  //! \param packet the request as it was sent
+  //!
+  void track(const SVHFixedSerialPacket& packet);
+
+  //!
+  //! \brief marks the request with the given index and address as answered
+  //! \param index index echoed by the hand
+  //! \param address address echoed by the hand
+  //! \return true if a recorded request matched the response
+  //!
+  bool acknowledge(std::uint8_t index, std::uint8_t address);
+
+  //!
+  //! \brief blocks until all recorded requests are answered
+  //! \param timeout maximum time to wait
+  //! \return true if all requests were answered, false on timeout
+  //!
+  bool waitForAll(const std::chrono::microseconds& timeout);
+
+  //!
+  //! \brief removes all unanswered requests and returns them for a retransmission
+  //! \return the unanswered requests in the order they were sent
+  //!
+  std::vector<SVHFixedSerialPacket> takeUnacknowledged();
+
+  //! number of requests that were answered since start()
+  size_t acknowledgedCount();
+
+  //! number of recorded requests that still wait for their response
+  size_t pendingCount();
+
+private:
+  //! a recorded request
+  struct Request
+  {
+    SVHFixedSerialPacket packet;
+    bool acknowledged;
+  };
+
+  //! index and address of a response that matched no request (yet)
+  struct Response
+  {
+    std::uint8_t index;
+    std::uint8_t address;
+  };
+
+  //! cheap check for the receive thread whether it has to take the lock at all
+  std::atomic<bool> m_active;
+
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+
+  //! requests recorded since start()
+  std::vector<Request> m_requests;
+
+  //! responses that arrived before their request was recorded
+  std::deque<Response> m_unmatched;
+
+  //! number of answered requests since start()
+  size_t m_acknowledged;
+
+  //! number of recorded requests without response
+  size_t m_pending;
+};
+
+} // namespace driver_svh
+
+#endif
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains the interpolation of timed waypoints for all channels.
+ * The finger manager samples the trajectory at a fixed rate and streams the
+ * samples to the hand as control commands.
+ */
+//----------------------------------------------------------------------
+#ifndef DRIVER_SVH_SVH_TRAJECTORY_H_INCLUDED
+#define DRIVER_SVH_SVH_TRAJECTORY_H_INCLUDED
+
+#include <schunk_svh_library/ImportExport.h>
+
+#include <chrono>
+#include <vector>
+
+namespace driver_svh {
+
+//! Number of channels every waypoint has to provide
+const size_t C_TRAJECTORY_CHANNELS = 9;
+
+//! Highest rate in [Hz] at which trajectories can be streamed to the hand
+const double C_TRAJECTORY_MAX_RATE = 500.0;
+
+//! Interpolation between two waypoints
+enum SVHInterpolation
+{
+  //! constant velocity, velocity jumps at the waypoints
+  SVH_INTERPOLATION_LINEAR,
+  //! continuous velocity, starts and ends at rest
+  SVH_INTERPOLATION_CUBIC,
+  //! continuous velocity and acceleration, starts and ends at rest
+  SVH_INTERPOLATION_QUINTIC
+};
+
+/*!
+ * \brief Positions of all channels that are to be reached at a given time
+ */
+struct SVHTrajectoryWaypoint
+{
+  //! time relative to the start of the trajectory
+  std::chrono::microseconds time;
+  //! one position per channel
+  std::vector<double> positions;
+
+  SVHTrajectoryWaypoint()
+    : time(0)
+    , positions(C_TRAJECTORY_CHANNELS, 0.0)
+  {
+  }
+
+  SVHTrajectoryWaypoint(const std::chrono::microseconds& time, const std::vector<double>& positions)
+    : time(time)
+    , positions(positions)
+  {
+  }
+};
+
+/*!
+ * \brief Interpolates timed waypoints of all channels
+ *
+ * The velocities at inner waypoints are chosen so that no channel overshoots its neighbouring
+ * waypoints, i.e. a trajectory whose waypoints are within limits stays within these limits.
+ */
+class DRIVER_SVH_IMPORT_EXPORT SVHTrajectory
+{
+public:
+  SVHTrajectory();
+
+  //!
+  //! \brief replaces the waypoints of the trajectory
+  //! \param waypoints at least one waypoint, strictly increasing in time starting at or after 0
+  //! \param interpolation interpolation between the waypoints
+  //! \return false if the waypoints are malformed, the trajectory is left unchanged then
+  //!
+  bool setWaypoints(const std::vector<SVHTrajectoryWaypoint>& waypoints,
+                    SVHInterpolation interpolation);
+
+  //! time of the last waypoint
+  std::chrono::microseconds duration() const;
+
+  //!
+  //! \brief positions of all channels at the given time. Before the first and after the last
+  //! waypoint the positions of that waypoint are returned.
+  //! \param time time relative to the start of the trajectory
+  //! \param positions receives one position per channel, does not allocate if already sized
+  //!
+  void sample(const std::chrono::microseconds& time, std::vector<double>& positions) const;
+
+private:
+  SVHInterpolation m_interpolation;
+
+  //! waypoint times in seconds
+  std::vector<double> m_times;
+
+  //! positions per waypoint, C_TRAJECTORY_CHANNELS values each
+  std::vector<double> m_positions;
+
+  //! velocities per waypoint in position units per second
+  std::vector<double> m_velocities;
+};
+
+} // namespace driver_svh
+
+#endif
@@ -36,99 +36,155 @@
 
 #include <assert.h>
 #include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <type_traits>
 #include <vector>
 
 
 namespace driver_svh {
 
+//! true if the host stores multi byte values in little endian order, evaluated at compile time
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) &&                                    \
+  (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+const bool C_HOST_IS_LITTLE_ENDIAN = false;
+#else
+const bool C_HOST_IS_LITTLE_ENDIAN = true;
+#endif
+
+//! unsigned integer type with the same size as the value type, used for its raw representation
+template <size_t Size>
+struct RawBytesOfSize;
+template <>
+struct RawBytesOfSize<1>
+{
+  typedef std::uint8_t type;
+};
+template <>
+struct RawBytesOfSize<2>
+{
+  typedef std::uint16_t type;
+};
+template <>
+struct RawBytesOfSize<4>
+{
+  typedef std::uint32_t type;
+};
+template <>
+struct RawBytesOfSize<8>
+{
+  typedef std::uint64_t type;
+};
+
+//! reverses the byte order, the compiler turns these into a single bswap instruction
+inline std::uint8_t byteSwap(std::uint8_t value)
+{
+  return value;
+}
+
+//! reverses the byte order, the compiler turns these into a single bswap instruction
+inline std::uint16_t byteSwap(std::uint16_t value)
+{
+#if defined(__GNUC__)
+  return __builtin_bswap16(value);
+#else
+  return static_cast<std::uint16_t>((value << 8) | (value >> 8));
+#endif
+}
+
+//! reverses the byte order, the compiler turns these into a single bswap instruction
+inline std::uint32_t byteSwap(std::uint32_t value)
+{
+#if defined(__GNUC__)
+  return __builtin_bswap32(value);
+#else
+  return ((value & 0x000000FFu) << 24) | ((value & 0x0000FF00u) << 8) |
+         ((value & 0x00FF0000u) >> 8) | ((value & 0xFF000000u) >> 24);
+#endif
+}
+
+//! reverses the byte order, the compiler turns these into a single bswap instruction
+inline std::uint64_t byteSwap(std::uint64_t value)
+{
+#if defined(__GNUC__)
+  return __builtin_bswap64(value);
+#else
+  return (static_cast<std::uint64_t>(byteSwap(static_cast<std::uint32_t>(value))) << 32) |
+         byteSwap(static_cast<std::uint32_t>(value >> 32));
+#endif
+}
+
+//! writes any arithmetic value in little endian byte order straight into raw bytes. On little
+//! endian hosts this is a plain copy, on big endian hosts a byte swap.
+template <typename T>
+void writeLittleEndian(const T& value, std::uint8_t* data)
+{
+  static_assert(std::is_arithmetic<T>::value, "Only arithmetic types can be converted");
+  typename RawBytesOfSize<sizeof(T)>::type raw;
+  std::memcpy(&raw, &value, sizeof(T));
+  if (!C_HOST_IS_LITTLE_ENDIAN)
+  {
+    raw = byteSwap(raw);
+  }
+  std::memcpy(data, &raw, sizeof(T));
+}
+
+//! reads any arithmetic value stored in little endian byte order straight from raw bytes
+template <typename T>
+T readLittleEndian(const std::uint8_t* data)
+{
+  static_assert(std::is_arithmetic<T>::value, "Only arithmetic types can be converted");
+  typename RawBytesOfSize<sizeof(T)>::type raw;
+  std::memcpy(&raw, data, sizeof(T));
+  if (!C_HOST_IS_LITTLE_ENDIAN)
+  {
+    raw = byteSwap(raw);
+  }
+  T value;
+  std::memcpy(&value, &raw, sizeof(T));
+  return value;
+}
+
 //! template function for adding data to an array while converting everything into correct endianess
 template <typename T>
 size_t toLittleEndian(const T& data, std::vector<std::uint8_t>& array, size_t& write_pos)
 {
-  // Resize the target array in case it it to small to avoid out of bounds acces
+  // Resize the target array in case it it to small to avoid out of bounds acces. This does not
+  // allocate as long as enough capacity was reserved.
   if (write_pos + sizeof(T) > array.size())
   {
-    // TODO: Remove Debug
-    // std::cout << "To Little Endian has to extend the Array. Current array Size: "<<
-    // (int)array.size() << " Pos: " << (int)pos << " Size_T: "<< sizeof(T) << " New array Size: "<<
-    // (int)(pos + sizeof(T)) << std::endl;
     array.resize(write_pos + sizeof(T));
   }
 
-  // Endianess Conversion
-  for (size_t i = 0; i < sizeof(T); ++i)
-  {
-    // Copy each byte into the bytearray, always convert byte order to little endian regardles of
-    // source architecture
-    array[write_pos + i] = static_cast<std::uint8_t>((data >> (i * 8)) & 0xFF);
-  }
+  // Endianess Conversion, always convert byte order to little endian regardles of source
+  // architecture
+  writeLittleEndian(data, &array[write_pos]);
 
   return write_pos + sizeof(T);
 }
 
-//! Template specialization for float as these have to be handled seperately
-template <>
-DRIVER_SVH_IMPORT_EXPORT size_t toLittleEndian<float>(const float& data,
-                                                      std::vector<std::uint8_t>& array,
-                                                      size_t& write_pos);
-
-//! Template specialization for float as these have to be handled seperately
-template <>
-DRIVER_SVH_IMPORT_EXPORT size_t toLittleEndian<double>(const double& data,
-                                                       std::vector<std::uint8_t>& array,
-                                                       size_t& write_pos);
-
-
 //! template function for reating data out of an array while converting everything into correct
 //! endianess
 template <typename T>
 size_t fromLittleEndian(T& data, std::vector<std::uint8_t>& array, size_t& read_pos)
 {
-  // TODO: Remove once everything is tested :)
-  // std::cout << "From Little Endian Called with: "<<" Size_T: "<< sizeof(T) << " Pos: " <<
-  // (int)read_pos << "Current Array Size: "<< (int)array.size() << std::endl;
-
-  // Reset data as we only write with or
-  data = 0;
-
   // Check if ArrayBuilder has enough data
   if (read_pos + sizeof(T) > array.size())
   {
     // TODO: better error handling?
+    data = 0;
     return read_pos;
   }
 
-
-  // Endianess Conversion
-  for (size_t i = 0; i < sizeof(T); ++i)
-  {
-    // Copy each byte into the bytearray, always convert byte order back from little endian
-    data |= (array[read_pos + i] & 0xFF) << (i * 8);
-    // std::cout << "Converting Value: 0x" << std::setw(2) << std::setfill('0') << std::hex <<
-    // static_cast<int>((array[read_pos+i]& 0xFF) <<(i*8)) << " At the position
-    // i="<<static_cast<int>(i) << "resulting in the variable data: " << static_cast<int>(data)  <<
-    // std::dec <<" Or on DEC :" << static_cast<int>(data) << std::endl;
-  }
+  // Endianess Conversion, always convert byte order back from little endian
+  data = readLittleEndian<T>(&array[read_pos]);
 
   // Note: The Vector still contains the elements at this point maybe we would like to delete that?
   // But its expensive
   return read_pos + sizeof(T);
 }
 
-//! Template specialization for float as these have to be handled seperately
-template <>
-DRIVER_SVH_IMPORT_EXPORT size_t fromLittleEndian<float>(float& data,
-                                                        std::vector<std::uint8_t>& array,
-                                                        size_t& read_pos);
-
-//! Template specialization for float as these have to be handled seperately
-template <>
-DRIVER_SVH_IMPORT_EXPORT size_t fromLittleEndian<double>(double& data,
-                                                         std::vector<std::uint8_t>& array,
-                                                         size_t& read_pos);
-
 //! template class holding an array and the current index for write commands. Can be used to easily
 //! create an array for low level byte streams
 //!
@@ -169,6 +225,11 @@ public:
   //! \param array_size size the array is supposed to have after reset
   void reset(size_t array_size = 1);
 
+  //!
+  //! \brief Reserves memory so that following writes do not allocate
+  //! \param size number of bytes the array can grow to without reallocation
+  void reserve(size_t size) { array.reserve(size); }
+
   //! add data without any byte conversion
   template <typename T>
   void appendWithoutConversion(const T& data)
@@ -180,7 +241,7 @@ public:
     }
 
     // write data to array without conversion
-    *(reinterpret_cast<T*>(&array[write_pos])) = data;
+    std::memcpy(&array[write_pos], &data, sizeof(T));
     write_pos += sizeof(T);
   }
 
@@ -188,11 +249,18 @@ public:
   template <typename T>
   void appendWithoutConversion(const std::vector<T>& data)
   {
-    // Just insert every element of the Vector individually
-    for (typename std::vector<T>::const_iterator it = data.begin(); it != data.end(); ++it)
+    // The elements are contiguous, so the whole vector is copied at once
+    const size_t size = data.size() * sizeof(T);
+    if (size == 0)
+    {
+      return;
+    }
+    if (write_pos + size > array.size())
     {
-      appendWithoutConversion(*it);
+      array.resize(write_pos + size);
     }
+    std::memcpy(&array[write_pos], data.data(), size);
+    write_pos += size;
   }
 
   //! Write any type into ArrayBuilder, convert to LittleEndian in process
@@ -240,6 +308,13 @@ ArrayBuilder& ArrayBuilder::operator<<(const T& data)
 template <typename T>
 ArrayBuilder& ArrayBuilder::operator<<(const std::vector<T>& data)
 {
+  // Grow the array only once. The wire size of compound types is unknown here, so only
+  // arithmetic elements are reserved up front.
+  if (std::is_arithmetic<T>::value)
+  {
+    array.reserve(write_pos + data.size() * sizeof(T));
+  }
+
   // Just insert every element of the Vector individually
   for (typename std::vector<T>::const_iterator it = data.begin(); it != data.end(); ++it)
   {
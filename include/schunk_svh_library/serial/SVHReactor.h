@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains the SVHReactor, an event loop that serves the serial
+ * devices, the timers and the wakeup events of the driver from one thread.
+ * On Linux it is built on epoll, timerfd and eventfd, so the thread only
+ * wakes up if there is something to do and timers expire without drift.
+ * Several hands can share a reactor, or a small pool of them.
+ */
+//----------------------------------------------------------------------
+#ifndef DRIVER_SVH_SVH_REACTOR_H_INCLUDED
+#define DRIVER_SVH_SVH_REACTOR_H_INCLUDED
+
+#include <schunk_svh_library/ImportExport.h>
+#include <schunk_svh_library/serial/SVHThreadConfig.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace driver_svh {
+
+//! Handler the reactor calls from its thread once a source is ready
+using ReactorHandler = std::function<void()>;
+
+/*!
+ * \brief Event loop that serves file descriptors, timers and wakeup events from one thread
+ *
+ * Every source gets an id on registration. Handlers run one after another in the reactor thread
+ * and must not block, as they hold up all other sources. Sources can be added and removed from
+ * any thread. Once remove() returned, the handler of the source is not running and will not run
+ * again, so its owner may be destroyed. A reactor can be shared by several hands.
+ */
+class DRIVER_SVH_IMPORT_EXPORT SVHReactor
+{
+public:
+  /*!
+   * \brief Creates the event loop and starts the reactor thread
+   * \param settings scheduling settings of the reactor thread, named "svh_reactor" by default
+   */
+  explicit SVHReactor(const SVHThreadSettings& settings = SVHThreadSettings());
+
+  //! Stops the reactor thread and releases all sources
+  ~SVHReactor();
+
+  //! true if the reactor thread is running
+  bool isRunning() const { return m_running; }
+
+  //! true if called from a handler, i.e. the reactor thread
+  bool inReactorThread() const { return std::this_thread::get_id() == m_thread.get_id(); }
+
+  /*!
+   * \brief addReader calls the handler whenever the file descriptor has data to read
+   *
+   * The reactor does not take ownership of the descriptor. A descriptor that reports an error or
+   * hang up without data is disabled, so it does not keep the loop spinning.
+   * \param fd file descriptor to watch
+   * \param handler called if data is available, must read it to stop being called
+   * \return id of the source, -1 on failure
+   */
+  int addReader(int fd, const ReactorHandler& handler);
+
+  /*!
+   * \brief addTimer creates a timer that is disarmed until armTimer() is called
+   * \param handler called whenever the timer expires, once for several missed expirations
+   * \return id of the source, -1 on failure
+   */
+  int addTimer(const ReactorHandler& handler);
+
+  /*!
+   * \brief armTimer lets a timer expire at an absolute time and optionally periodically after that
+   * \param id timer returned by addTimer()
+   * \param expiry time of the first expiration, times in the past expire right away
+   * \param period period of following expirations, 0 for a single expiration
+   * \return true if the timer was armed
+   */
+  bool armTimer(int id,
+                const std::chrono::steady_clock::time_point& expiry,
+                const std::chrono::microseconds& period = std::chrono::microseconds(0));
+
+  //! stops a timer without removing it, true on success
+  bool disarmTimer(int id);
+
+  /*!
+   * \brief addEvent creates a wakeup event that other threads can signal with notify()
+   * \param handler called once after one or several notify() calls
+   * \return id of the source, -1 on failure
+   */
+  int addEvent(const ReactorHandler& handler);
+
+  //! signals a wakeup event, lock-free and safe to call from any thread
+  bool notify(int id);
+
+  /*!
+   * \brief addPeriodic calls the handler periodically, starting right away
+   *
+   * All periodic handlers with the same period share one timer, so they cause a single wakeup
+   * per period no matter how many hands poll at that rate.
+   * \param period time between two calls
+   * \param handler called once per period, once for several missed periods
+   * \return id of the handler, -1 on failure
+   */
+  int addPeriodic(const std::chrono::microseconds& period, const ReactorHandler& handler);
+
+  /*!
+   * \brief remove unregisters a source
+   *
+   * If the handler of the source is running in another thread, this waits until it returned.
+   * Called from a handler it returns right away.
+   * \param id source to remove, negative ids are ignored
+   */
+  void remove(int id);
+
+  //! number of handler calls since construction
+  uint64_t dispatchCount() const { return m_dispatch_count; }
+
+  //! number of registered file descriptors, timers and events
+  size_t sourceCount();
+
+  //! settings of the reactor thread that could not be applied
+  std::vector<SVHThreadSetupFailure> threadSetupFailures() const
+  {
+    return m_thread_setup.failures();
+  }
+
+private:
+  //! kinds of sources
+  enum SourceKind
+  {
+    SOURCE_READER,
+    SOURCE_TIMER,
+    SOURCE_EVENT
+  };
+
+  //! one registered source
+  struct Source
+  {
+    int fd;
+    SourceKind kind;
+    ReactorHandler handler;
+  };
+
+  //! registers a descriptor with the event loop, owned descriptors are closed on removal
+  int addSource(int fd, SourceKind kind, const ReactorHandler& handler);
+
+  //! file descriptor of a source, -1 if it is not of the given kind
+  int sourceFd(int id, SourceKind kind);
+
+  //! main loop of the reactor thread
+  void run();
+
+  //! runs the handler of a ready source
+  void dispatch(int id, std::uint32_t events);
+
+  //! waits until the handler of the source is not running, returns at once in a handler
+  void waitForDispatch(int id);
+
+  //! removes a periodic handler, false if the id belongs to no periodic handler
+  bool removePeriodic(int id);
+
+  //! removes a file descriptor, timer or event, see remove()
+  void removeSource(int id);
+
+  //! calls all periodic handlers of a period
+  void runPeriodic(int64_t period);
+
+  //! periodic handlers sharing one timer
+  struct PeriodicGroup
+  {
+    int timer;
+    std::map<int, ReactorHandler> handlers;
+    //! copy of the handlers that runPeriodic() calls without copying them on every tick
+    std::shared_ptr<const std::vector<ReactorHandler> > snapshot;
+  };
+
+  //! rebuilds the snapshot of a group after its handlers changed
+  static void updateSnapshot(PeriodicGroup& group);
+
+  //! groups of periodic handlers by their period in microseconds
+  std::map<int64_t, PeriodicGroup> m_periodic_groups;
+
+  //! period of every periodic handler by id
+  std::map<int, int64_t> m_periodic_periods;
+
+  //! guards the periodic handlers, never held while waiting for a handler
+  std::mutex m_periodic_mutex;
+
+  //! epoll instance, -1 if unavailable
+  int m_epoll_fd;
+
+  //! eventfd that stops the reactor thread
+  int m_stop_fd;
+
+  //! false requests the reactor thread to finish
+  std::atomic<bool> m_running;
+
+  //! handler calls since construction
+  std::atomic<uint64_t> m_dispatch_count;
+
+  //! registered sources by id
+  std::map<int, std::shared_ptr<Source> > m_sources;
+
+  //! id of the next source
+  int m_next_id;
+
+  //! source whose handler is running right now, -1 if none
+  int m_dispatching;
+
+  //! guards the sources and m_dispatching
+  std::mutex m_mutex;
+
+  //! signals the end of a handler call to remove()
+  std::condition_variable m_dispatch_condition;
+
+  //! applies the settings of the reactor thread
+  SVHThreadSetup m_thread_setup;
+
+  //! the reactor thread
+  std::thread m_thread;
+};
+
+/*!
+ * \brief A fixed number of reactors that are shared by many hands
+ *
+ * One reactor serves any number of hands, more reactors spread the load over several threads and
+ * cores. Hands get the reactor that currently serves the fewest hands.
+ */
+class DRIVER_SVH_IMPORT_EXPORT SVHReactorPool
+{
+public:
+  /*!
+   * \brief Starts the reactors of the pool
+   * \param size number of reactors, at least one
+   * \param settings scheduling settings of all reactor threads. They are named
+   * "svh_reactor_<n>" unless a name is given.
+   */
+  explicit SVHReactorPool(size_t size                       = 1,
+                          const SVHThreadSettings& settings = SVHThreadSettings());
+
+  //! number of reactors in the pool
+  size_t size() const { return m_reactors.size(); }
+
+  //! the reactor that serves the fewest hands, hands release it by dropping the pointer
+  std::shared_ptr<SVHReactor> acquire();
+
+  //! reactor by index, e.g. to query its thread setup failures
+  std::shared_ptr<SVHReactor> reactor(size_t index) const { return m_reactors.at(index); }
+
+private:
+  //! the reactors, each also referenced by the hands it serves
+  std::vector<std::shared_ptr<SVHReactor> > m_reactors;
+
+  //! guards the assignment of reactors
+  std::mutex m_mutex;
+};
+
+} // namespace driver_svh
+
+#endif
@@ -31,10 +31,11 @@
  * to receive packages independently from the sending direction, instantiate
  * this class in client code and call its run() method in a separate thread.
  *
- * This class will then poll the serial interface periodically for new data. If
- * data is present, a statemachine will evaluate the right packet structure and
- * send the data via callback to the caller for further parsing once a complete
- * serial packaged is received.
+ * This class will then either block on the serial interface until new data
+ * arrives or poll it periodically for new data. If data is present, a
+ * statemachine will evaluate the right packet structure and send the data via
+ * callback to the caller for further parsing once a complete serial packaged
+ * is received.
  */
 //----------------------------------------------------------------------
 #ifndef DRIVER_SVH_SVH_RECEIVE_THREAD_H_INCLUDED
@@ -45,6 +46,7 @@
 
 #include <schunk_svh_library/serial/SVHSerialPacket.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -55,6 +57,9 @@ using driver_svh::serial::Serial;
 
 namespace driver_svh {
 
+//! Size of the buffer that is filled with all available bytes in one read call
+const size_t C_RECEIVE_BUFFER_SIZE = 1024;
+
 //! definition of function callback for received packages
 using ReceivedPacketCallback =
   std::function<void(const SVHSerialPacket& packet, unsigned int packet_count)>;
@@ -78,18 +83,41 @@ public:
                    std::shared_ptr<Serial> device,
                    ReceivedPacketCallback const& received_callback);
 
-  //! Default DTOR
-  ~SVHReceiveThread() {}
+  /*!
+   * \brief SVHReceiveThread Constructs a new Receivethread that blocks on the serial device until
+   * data arrives. Packets are dispatched as soon as their bytes land and the thread does not wake
+   * up while the line is idle. Platforms without poll() fall back to periodic polling.
+   * \param device handle of the serial device
+   * \param received_callback function to call uppon finished packet
+   */
+  SVHReceiveThread(std::shared_ptr<Serial> device, ReceivedPacketCallback const& received_callback);
+
+  //! DTOR, releases the wakeup handle
+  ~SVHReceiveThread();
 
   //! run method of the thread, executes the main program in an infinite loop
   void run();
 
-  //! stop the run() method
-  void stop() { m_continue = false; };
+  //! stop the run() method, also wakes up a run() method that is blocked waiting for data
+  void stop();
+
+  //! allows run() to be called again after stop()
+  void resume() { m_continue = true; }
+
+  /*!
+   * \brief receiveAvailable processes the bytes that were received so far and dispatches all
+   * completed packets. Replaces run() if the caller owns the thread. It never waits and reads at
+   * most C_RECEIVE_BUFFER_SIZE bytes, anything beyond is left for the next call.
+   * \return number of bytes processed
+   */
+  size_t receiveAvailable();
 
   //! return the count of received packets
   unsigned int receivedPacketCount() { return m_packets_received; }
 
+  //! return the count of packets that were dropped for a payload length beyond C_PACKET_DATA_SIZE
+  unsigned int skippedPacketCount() { return m_packets_skipped; }
+
   /*!
    * \brief resetReceivedPackageCount Resets the received package count to zero. This can be usefull
    * to set all communication variables to the initial state
@@ -103,6 +131,12 @@ private:
   //! sleep time during run() if idle
   std::chrono::microseconds m_idle_sleep;
 
+  //! block on the device until data arrives instead of sleeping m_idle_sleep
+  bool m_wait_for_data;
+
+  //! eventfd used to wake up a blocked run() method on stop(), -1 if unavailable
+  int m_wakeup_fd;
+
   //! pointer to serial device object
   std::shared_ptr<Serial> m_serial_device;
 
@@ -126,25 +160,37 @@ private:
   //! length of received serial data
   uint16_t m_length;
 
-  //! Checksum of packet
+  //! Checksum of packet, accumulated while the payload is received
   std::uint8_t m_checksum1;
   std::uint8_t m_checksum2;
 
-  //! length of received serial data
-  std::vector<std::uint8_t> m_data;
-
-  //! pointer to array builder object for packet receive
-  driver_svh::ArrayBuilder m_ab;
+  //! packet that is filled by the state machine, reused for every frame to avoid allocations
+  SVHSerialPacket m_received_packet;
 
   //! packets counter
   std::atomic<unsigned int> m_packets_received;
 
+  //! counter for packets with an invalid payload length
+  std::atomic<unsigned int> m_packets_skipped;
+
   //! counter for skipped bytes in case no packet is detected
   unsigned int m_skipped_bytes;
 
-  //! state machine processing received data
+  //! buffer holding the bytes of the last read call that are fed into the state machine
+  std::array<std::uint8_t, C_RECEIVE_BUFFER_SIZE> m_read_buffer;
+
+  //! time at which the bytes in m_read_buffer were read, stamped onto packets completed by them
+  std::chrono::steady_clock::time_point m_read_timestamp;
+
+  //! event driven variant of run() that blocks in poll() until data or a stop request arrives
+  void waitForData();
+
+  //! reads all available bytes from the device and processes them, false if nothing was read
   bool receiveData();
 
+  //! state machine processing one received byte
+  void processByte(std::uint8_t data_byte);
+
   //! function callback for received packages
   ReceivedPacketCallback m_received_callback;
 };
@@ -41,16 +41,77 @@
 // Windows declarations
 #include <schunk_svh_library/ImportExport.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <schunk_svh_library/serial/SVHReactor.h>
 #include <schunk_svh_library/serial/SVHReceiveThread.h>
 #include <schunk_svh_library/serial/SVHSerialPacket.h>
+#include <schunk_svh_library/serial/SVHThreadConfig.h>
+#include <schunk_svh_library/serial/SVHTransmitQueue.h>
 #include <schunk_svh_library/serial/Serial.h>
 #include <thread>
+#include <vector>
 
 using driver_svh::serial::Serial;
 
 namespace driver_svh {
 
+//! Largest number of packets that can be tracked in flight (packet indices wrap at 255)
+const unsigned int C_MAX_TRANSMIT_WINDOW = 128;
+
+//! Number of packets the transmit queue holds before submitPacket() rejects new ones
+const size_t C_TRANSMIT_QUEUE_SIZE = 64;
+
+//! Bytes per second the link carries at 921600 baud with 8N1 framing
+const double C_LINK_BYTES_PER_SECOND = 92160.0;
+
+//! Frames a priority class may send back to back before its link budget throttles it
+const double C_LINK_BUDGET_BURST = 4.0;
+
+//! Completion callback of a submitted packet, success is false if it could not be written
+using TransmitCallback = std::function<void(bool success)>;
+
+/*!
+ * \brief Priority classes of the transmit scheduler, lower values are sent first
+ */
+enum SVHTransmitPriority
+{
+  //! all writes, i.e. controller states, settings, encoder values and position targets, so that
+  //! they keep the order they were given in
+  SVH_PRIORITY_COMMAND = 0,
+  //! feedback requests
+  SVH_PRIORITY_FEEDBACK,
+  //! requests other than feedback, e.g. for settings, encoder values or the firmware info
+  SVH_PRIORITY_BACKGROUND,
+  //! number of priority classes
+  SVH_PRIORITY_CLASSES
+};
+
+/*!
+ * \brief Fill level and throughput of the asynchronous transmit queue
+ */
+struct SVHTransmitQueueStatistics
+{
+  //! packets written per priority class since connect
+  std::array<unsigned int, SVH_PRIORITY_CLASSES> written;
+  //! packets currently waiting for the writer thread
+  size_t depth;
+  //! highest depth observed since the interface was connected
+  size_t max_depth;
+  //! packets accepted by submitPacket()
+  unsigned int submitted;
+  //! packets rejected because the queue was full
+  unsigned int rejected;
+  //! queued packets discarded because an emergency packet overtook them
+  unsigned int flushed;
+};
+
 /*!
  *  \brief Basic communication handler for the SCHUNK five finger hand.
  */
@@ -69,9 +130,12 @@ public:
   //!
   //! \brief connecting to serial device and starting receive thread
   //! \param dev_name Filehandle of the device i.e. dev/ttyUSB0
+  //! \param thread_config settings of the receive and writer threads. Settings that cannot be
+  //! applied do not fail the connect, see threadSetupFailures().
   //! \return bool true if connection was succesfull
   //!
-  bool connect(const std::string& dev_name);
+  bool connect(const std::string& dev_name,
+               const SVHThreadConfig& thread_config = SVHThreadConfig());
 
   //!
   //! \brief canceling receive thread and closing connection to serial port
@@ -86,11 +150,76 @@ public:
 
   //!
   //! \brief function for sending packets via serial device to the SVH
-  //! \param packet the prepared Serial Packet
+  //!
+  //! Safe to call from several threads at once. While connected the packet is handed to the
+  //! writer thread, which shares the device only with sendEmergencyPacket(), and the call returns
+  //! once the packet was written. Frames of different callers therefore never interleave on the
+  //! wire. In pump mode the packet is only queued and its index is not known on return.
+  //! \param packet the prepared Serial Packet, holds the index it was sent with afterwards
   //! \return true if successful
   //!
   bool sendPacket(SVHSerialPacket& packet);
 
+  //!
+  //! \brief allocation free variant of sendPacket() for fixed size packets
+  //! \param packet the prepared Serial Packet
+  //! \return true if successful
+  //!
+  bool sendPacket(SVHFixedSerialPacket& packet);
+
+  //!
+  //! \brief queues a packet for the writer thread and returns immediately. Lock-free, so any
+  //! number of threads may submit at full rate.
+  //! \param packet the prepared Serial Packet, index and padding are set once it is written
+  //! \param callback called from the writer thread after the packet was written or discarded
+  //! \param hold_off time the writer waits after this packet before it sends the next one
+  //! \return false if the queue is full or the interface is not connected
+  //!
+  bool submitPacket(const SVHSerialPacket& packet,
+                    const TransmitCallback& callback         = TransmitCallback(),
+                    const std::chrono::microseconds& hold_off = std::chrono::microseconds(0));
+
+  //! \brief allocation free variant of submitPacket() for fixed size packets
+  bool submitPacket(const SVHFixedSerialPacket& packet,
+                    const TransmitCallback& callback         = TransmitCallback(),
+                    const std::chrono::microseconds& hold_off = std::chrono::microseconds(0));
+
+  //!
+  //! \brief queues a packet like submitPacket() but reports the completion through a future
+  //! \param packet the prepared Serial Packet
+  //! \return future that turns true once the packet was written, false if it was rejected
+  //!
+  std::future<bool> submitPacketAsync(const SVHSerialPacket& packet);
+
+  //!
+  //! \brief writes a packet ahead of all other traffic from the calling thread
+  //!
+  //! Meant for stopping the hand. All packets that are still queued or waiting for room in the
+  //! transmit window are discarded and their callbacks report false. The packet neither waits
+  //! for the queue, the transmit window nor the pacing delay, only for a frame that is being
+  //! written at this moment.
+  //! \param packet the prepared Serial Packet, holds the index it was sent with afterwards
+  //! \return true if the frame was handed to the serial device
+  //!
+  bool sendEmergencyPacket(SVHFixedSerialPacket& packet);
+
+  //! \brief current statistics of the asynchronous transmit queue
+  SVHTransmitQueueStatistics transmitQueueStatistics();
+
+  /*!
+   * \brief setPriorityBudget limits the share of the link byte time a priority class may use.
+   *
+   * The writer always sends the most urgent queued packet. A class that used up its budget is
+   * skipped until the budget has recovered, so lower classes can only use the capacity that is
+   * left and bursts of them cannot fill the link or the transmit window.
+   * \param priority priority class to limit
+   * \param share fraction of the link byte time in (0, 1], 1 does not limit the class at all
+   */
+  void setPriorityBudget(SVHTransmitPriority priority, double share);
+
+  //! \brief priority class a packet for the given address is scheduled with
+  static SVHTransmitPriority transmitPriority(std::uint8_t address);
+
   //!
   //! \brief get number of transmitted packets
   //! \return number of successfully sent packets
@@ -102,6 +231,83 @@ public:
    */
   void resetTransmitPackageCount();
 
+  /*!
+   * \brief setTransmitWindow Selects how consecutive packets are paced.
+   *
+   * With a window of 0 (default) every packet is followed by a fixed delay of 782us which is the
+   * time 72 bytes need on the line. With a window of N the delay is dropped and every packet is
+   * tracked by its index until the hardware echoes it back. sendPacket() only blocks if N packets
+   * are still unacknowledged, so the throughput follows the actual round trip time of the hand.
+   * \param window number of unacknowledged packets allowed in flight, at most
+   * C_MAX_TRANSMIT_WINDOW
+   * \param acknowledge_timeout time after which an unacknowledged packet is considered lost and
+   * no longer occupies the window
+   */
+  void setTransmitWindow(unsigned int window,
+                         const std::chrono::microseconds& acknowledge_timeout =
+                           std::chrono::milliseconds(10));
+
+  //! \brief number of packets that were not acknowledged within the acknowledge timeout
+  unsigned int unacknowledgedPacketCount();
+
+  /*!
+   * \brief setPumpMode hands the receive and transmit work to the caller instead of the own
+   * threads.
+   *
+   * In pump mode connect() starts no threads and the caller drives the communication from its
+   * own loop by calling read() and write() once per cycle. Both never wait, do not allocate and
+   * do a bounded amount of work. sendPacket() only queues the packet then. Switching while
+   * connected stops or restarts the threads, packets queued by then are written by the writer
+   * thread before pump mode starts. It must not be switched while other threads send.
+   * \param enable true to pump from the caller's thread, false to use the own threads (default)
+   */
+  void setPumpMode(bool enable);
+
+  //! \brief true if the caller pumps the communication, see setPumpMode()
+  bool isPumped() const { return m_pumped; }
+
+  /*!
+   * \brief read processes the bytes received so far and dispatches all completed packets. Only
+   * does something in pump mode.
+   * \return number of bytes processed, at most C_RECEIVE_BUFFER_SIZE
+   */
+  size_t read();
+
+  /*!
+   * \brief write sends the queued packets that are due. Only does something in pump mode.
+   *
+   * Instead of sleeping, the pacing delay and the hold off times of the packets postpone the next
+   * frame to a later call. Without a transmit window this is one frame per call at most, with a
+   * window as many as the window has room for.
+   * \return number of packets written
+   */
+  size_t write();
+
+  /*!
+   * \brief setReactor lets a reactor serve the interface instead of the own threads.
+   *
+   * With a reactor connect() starts no threads. The reactor thread parses the received bytes as
+   * they arrive and writes the queued packets, a timer replaces the pacing sleeps of the writer
+   * thread. Several interfaces may share one reactor. Takes effect with the next connect() and is
+   * ignored in pump mode.
+   * \param reactor reactor to register with, NULL to use the own threads (default)
+   * \return false if the interface is connected, the reactor can only be changed before
+   */
+  bool setReactor(const std::shared_ptr<SVHReactor>& reactor);
+
+  //! \brief thread settings of the last connect() that could not be applied
+  std::vector<SVHThreadSetupFailure> threadSetupFailures() const
+  {
+    return m_thread_setup.failures();
+  }
+
+  //! \brief true while a reactor serves the interface, see setReactor()
+  bool usesReactor() const { return m_reactor_driven; }
+
+  //! \brief true if called from a handler of the reactor that serves the interface, which must
+  //! not wait for a packet to be written
+  bool inReactorThread() const { return m_reactor_driven && m_reactor->inReactorThread(); }
+
   /*!
    * \brief printPacketOnConsole is a pure helper function to show what raw data is actually sent.
    * This is not meant for any productive use other than understand whats going on. \param packet
@@ -134,10 +340,204 @@ private:
   ReceivedPacketCallback m_received_packet_callback;
 
   //! packet counters
-  unsigned int m_packets_transmitted;
+  std::atomic<unsigned int> m_packets_transmitted;
 
   //! packet counter simulation for pure showing purposes
   unsigned int m_dummy_packets_printed;
+
+  //! index and send time of a packet that waits for its acknowledgement
+  struct InFlightPacket
+  {
+    std::uint8_t index;
+    std::chrono::steady_clock::time_point sent;
+  };
+
+  //! waits until the transmit window has room
+  void waitForTransmitSlot();
+
+  //! true if the transmit window has room right now
+  bool hasTransmitSlot();
+
+  //! drops in flight packets whose acknowledgement timed out, needs m_transmit_window_mutex
+  void expireTransmitSlots(const std::chrono::steady_clock::time_point& now);
+
+  //! registers a packet that is about to be written as in flight
+  void registerTransmitSlot(std::uint8_t index);
+
+  //! removes an acknowledged packet from the transmit window
+  void releaseTransmitSlot(std::uint8_t index);
+
+  //! number of packets allowed in flight, 0 for fixed delay pacing
+  unsigned int m_transmit_window;
+
+  //! time after which an in flight packet is considered lost
+  std::chrono::microseconds m_acknowledge_timeout;
+
+  //! packets in flight ordered by send time. Capacity is reserved up front.
+  std::vector<InFlightPacket> m_in_flight;
+
+  //! number of packets that timed out without acknowledgement
+  unsigned int m_packets_unacknowledged;
+
+  //! guards the transmit window
+  std::mutex m_transmit_window_mutex;
+
+  //! signals acknowledgements to a sender waiting for room in the window
+  std::condition_variable m_transmit_window_condition;
+
+  //! packet submitted for asynchronous transmission
+  struct TransmitRequest
+  {
+    SVHFixedSerialPacket packet;
+    TransmitCallback callback;
+    std::chrono::microseconds hold_off;
+    //! receives the index the packet was sent with before the callback is called, may be NULL
+    std::uint8_t* sent_index;
+    //! emergency generation at submission, the packet is discarded once it is outdated
+    unsigned int generation;
+  };
+
+  //! queues a packet for the writer thread, see submitPacket()
+  bool enqueuePacket(const SVHFixedSerialPacket& packet,
+                     const TransmitCallback& callback,
+                     const std::chrono::microseconds& hold_off,
+                     std::uint8_t* sent_index);
+
+  //! main loop of the writer thread, returns once stopped and all queued packets are written
+  void writeQueuedPackets();
+
+  //! encodes the packet and writes it to the device, only called by one thread at a time
+  bool writePacket(SVHFixedSerialPacket& packet);
+
+  //! like writePacket() but discards the packet if an emergency packet was sent after generation
+  bool writePacket(SVHFixedSerialPacket& packet, unsigned int generation);
+
+  //! encodes the packet into frame and writes it to the device, needs m_device_mutex
+  bool writeFrame(const SVHFixedSerialPacket& packet, SVHSerialFrame& frame);
+
+  //! assigns the index, registers the packet in the transmit window and writes it, false if the
+  //! packet is outdated by an emergency packet
+  bool writeCurrentPacket(SVHFixedSerialPacket& packet, unsigned int generation);
+
+  //! starts the receive and writer threads
+  void startThreads();
+
+  //! stops the receive and writer threads after everything queued was written
+  void stopThreads();
+
+  //! thread settings of the current connection
+  SVHThreadConfig m_thread_config;
+
+  //! starts the threads with their settings and collects the failures
+  SVHThreadSetup m_thread_setup;
+
+  //! the caller pumps the communication, no threads are running
+  std::atomic<bool> m_pumped;
+
+  //! earliest time write() may send the next frame in pump mode
+  std::chrono::steady_clock::time_point m_pump_next_write;
+
+  //! writes the queued packets that are due, shared by pump and reactor mode
+  size_t writeDuePackets();
+
+  //! time at which the next queued packet may be written, max() if the queues are empty
+  std::chrono::steady_clock::time_point nextWriteTime();
+
+  //! earliest time a throttled class with queued packets has its budget back, max() if none
+  std::chrono::steady_clock::time_point budgetRecoveryTime() const;
+
+  //! registers the device, the pacing timer and the submit event with the reactor
+  bool registerWithReactor();
+
+  //! removes all sources from the reactor, their handlers are not running afterwards
+  void unregisterFromReactor();
+
+  //! reactor handler for received data
+  void reactorRead();
+
+  //! reactor handler for due packets, arms the pacing timer for the ones that are left
+  void reactorWrite();
+
+  //! reactor used by the next connect(), may be NULL
+  std::shared_ptr<SVHReactor> m_reactor;
+
+  //! true while the reactor serves the interface
+  std::atomic<bool> m_reactor_driven;
+
+  //! reactor source ids of the device, the pacing timer and the submit event
+  int m_reactor_reader;
+  int m_reactor_timer;
+  int m_reactor_event;
+
+  //! frame buffer the writer encodes every packet into
+  SVHSerialFrame m_transmit_frame;
+
+  //! frame buffer for emergency packets, which do not go through the writer thread
+  SVHSerialFrame m_emergency_frame;
+
+  //! serializes the frames of the writer thread and emergency packets on the device
+  std::mutex m_device_mutex;
+
+  //! incremented by every emergency packet, queued packets of older generations are discarded
+  std::atomic<unsigned int> m_emergency_generation;
+
+  //! packets discarded because of an emergency packet since connect
+  std::atomic<unsigned int> m_packets_flushed;
+
+  //! thread writing the submitted packets
+  std::thread m_transmit_thread;
+
+  //! packets waiting for the writer thread, one queue per priority class
+  std::array<std::unique_ptr<SVHTransmitQueue<TransmitRequest> >, SVH_PRIORITY_CLASSES>
+    m_transmit_queues;
+
+  //! link share of each priority class, 1 if unlimited
+  std::array<std::atomic<double>, SVH_PRIORITY_CLASSES> m_budget_shares;
+
+  //! byte time in microseconds each class may still use, only touched by the writer thread
+  std::array<double, SVH_PRIORITY_CLASSES> m_budget_tokens;
+
+  //! time the budgets were last refilled, only touched by the writer thread
+  std::chrono::steady_clock::time_point m_budget_refill;
+
+  //! packets written per priority class
+  std::array<std::atomic<unsigned int>, SVH_PRIORITY_CLASSES> m_packets_written;
+
+  //! refills the budgets of all classes for the time passed since the last refill
+  void refillBudgets(const std::chrono::steady_clock::time_point& now);
+
+  //! true if the class may send a frame now
+  bool hasBudget(size_t priority) const;
+
+  //! priority class of the next packet the writer may send, SVH_PRIORITY_CLASSES if none
+  size_t nextWritablePriority() const;
+
+  //! true if no queue holds a packet
+  bool transmitQueuesEmpty() const;
+
+  //! false requests the writer thread to finish
+  std::atomic<bool> m_transmit_running;
+
+  //! number of producers currently inside submitPacket(), close() waits for them
+  std::atomic<unsigned int> m_active_submitters;
+
+  //! true while the writer thread sleeps on m_transmit_wakeup_condition
+  std::atomic<bool> m_writer_waiting;
+
+  //! packets accepted by submitPacket() since connect
+  std::atomic<unsigned int> m_packets_submitted;
+
+  //! packets rejected by submitPacket() since connect
+  std::atomic<unsigned int> m_packets_rejected;
+
+  //! highest queue depth seen since connect
+  std::atomic<size_t> m_max_queue_depth;
+
+  //! only used to put the idle writer thread to sleep, producers never wait on it
+  std::mutex m_transmit_wakeup_mutex;
+
+  //! wakes up the idle writer thread
+  std::condition_variable m_transmit_wakeup_condition;
 };
 
 } // namespace driver_svh
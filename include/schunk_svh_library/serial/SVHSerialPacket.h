@@ -36,8 +36,11 @@
 #ifndef SVHSERIALPACKET_H
 #define SVHSERIALPACKET_H
 
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <schunk_svh_library/serial/ByteOrderConversion.h>
+#include <type_traits>
 
 namespace driver_svh {
 
@@ -48,6 +51,8 @@ namespace driver_svh {
 // packet sizes
 const size_t C_PACKET_APPENDIX_SIZE = 8;  //!< The packet overhead size in bytes
 const size_t C_DEFAULT_PACKET_SIZE  = 48; //!< Default packet payload size in bytes
+const size_t C_PACKET_DATA_SIZE     = 64; //!< Payload size on the wire, shorter data is zero padded
+const size_t C_FRAME_SIZE = C_PACKET_DATA_SIZE + C_PACKET_APPENDIX_SIZE; //!< Complete frame size
 
 // packet headers
 const std::uint8_t PACKET_HEADER1 = 0x4C; //!< Header sync byte 1
@@ -91,6 +96,8 @@ struct SVHSerialPacket
   std::uint8_t address;
   //! Payload of the package
   std::vector<std::uint8_t> data;
+  //! Monotonic time at which the package was received, set by the receive thread
+  std::chrono::steady_clock::time_point timestamp;
 
   /*!
    * \brief SVHSerialPacket contains the send and received data in raw format (bytewise)
@@ -110,6 +117,58 @@ struct SVHSerialPacket
   }
 };
 
+/*!
+ * \brief Fixed size variant of the SVHSerialPacket that never touches the heap.
+ *
+ * The payload always has the padded wire size, so copying the packet into a transmit queue and
+ * encoding it into a frame does not allocate. Used on the command hot path.
+ */
+struct SVHFixedSerialPacket
+{
+  //! Continuosly incremented counter per package, set by the serial interface
+  std::uint8_t index;
+  //! Adress denotes the actual function of the package
+  std::uint8_t address;
+  //! Payload of the package, zero padded
+  std::array<std::uint8_t, C_PACKET_DATA_SIZE> data;
+
+  //! Constructs a packet with an all zero payload
+  explicit SVHFixedSerialPacket(std::uint8_t address = SVH_GET_CONTROL_FEEDBACK)
+    : index(0)
+    , address(address)
+    , data()
+  {
+  }
+
+  //! Copies a dynamic packet, data beyond C_PACKET_DATA_SIZE bytes is cut off like on the wire
+  explicit SVHFixedSerialPacket(const SVHSerialPacket& packet);
+
+  /*!
+   * \brief write puts an integral value into the payload in little endian byte order
+   * \param offset byte position in the payload
+   * \param value value to write
+   * \return offset behind the written value, so calls can be chained
+   */
+  template <typename T>
+  size_t write(size_t offset, const T& value)
+  {
+    static_assert(std::is_integral<T>::value, "Only integral types can be written directly");
+    assert(offset + sizeof(T) <= data.size());
+    writeLittleEndian(value, &data[offset]);
+    return offset + sizeof(T);
+  }
+};
+
+//! A complete frame as it is sent over the wire: header, index, address, length, data, checksums
+using SVHSerialFrame = std::array<std::uint8_t, C_FRAME_SIZE>;
+
+/*!
+ * \brief encodeFrame writes header, packet and checksums straight into a preallocated frame
+ * \param packet packet to encode, index has to be set already
+ * \param frame target buffer
+ */
+void encodeFrame(const SVHFixedSerialPacket& packet, SVHSerialFrame& frame);
+
 //! overload stream operator to easily serialize raw packet data
 driver_svh::ArrayBuilder& operator<<(driver_svh::ArrayBuilder& ab, const SVHSerialPacket& data);
 
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains the scheduling settings of the driver threads. They are
+ * passed on connect and applied by every thread to itself right after it was
+ * started. Settings that cannot be applied, typically because of missing
+ * privileges, are logged and reported back instead of aborting the connect.
+ */
+//----------------------------------------------------------------------
+#ifndef DRIVER_SVH_SVH_THREAD_CONFIG_H_INCLUDED
+#define DRIVER_SVH_SVH_THREAD_CONFIG_H_INCLUDED
+
+#include <schunk_svh_library/ImportExport.h>
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace driver_svh {
+
+//! Policy value that keeps the scheduling policy and priority the thread inherited
+const int C_THREAD_POLICY_INHERIT = -1;
+
+//! Largest amount of stack that is prefaulted, well below the default thread stack size
+const size_t C_MAX_STACK_PREFAULT = 1024 * 1024;
+
+/*!
+ * \brief Scheduling settings of one thread
+ */
+struct SVHThreadSettings
+{
+  SVHThreadSettings()
+    : policy(C_THREAD_POLICY_INHERIT)
+    , priority(0)
+  {
+  }
+
+  //! scheduling policy, e.g. SCHED_FIFO or SCHED_RR, C_THREAD_POLICY_INHERIT to keep it
+  int policy;
+  //! priority within the policy, e.g. 1 to 99 for SCHED_FIFO
+  int priority;
+  //! cores the thread may run on, empty for all cores
+  std::vector<int> cpus;
+  //! name shown by ps and top, cut to 15 characters, empty to keep it
+  std::string name;
+};
+
+/*!
+ * \brief Settings of all threads of the driver, passed on connect
+ */
+struct SVHThreadConfig
+{
+  SVHThreadConfig()
+    : lock_memory(false)
+    , stack_prefault(0)
+  {
+    receive.name    = "svh_receive";
+    transmit.name   = "svh_transmit";
+    feedback.name   = "svh_feedback";
+    trajectory.name = "svh_trajectory";
+    command.name    = "svh_command";
+  }
+
+  //! thread dispatching the received packets
+  SVHThreadSettings receive;
+  //! thread writing the queued packets
+  SVHThreadSettings transmit;
+  //! thread polling the feedback periodically
+  SVHThreadSettings feedback;
+  //! thread streaming trajectories
+  SVHThreadSettings trajectory;
+  //! thread sending the collected targets, see SVHController::setCommandCoalescing()
+  SVHThreadSettings command;
+  //! locks all current and future memory of the process in RAM, so it is never paged out
+  bool lock_memory;
+  //! bytes of stack every thread touches on start, so it does not page fault later. At most
+  //! C_MAX_STACK_PREFAULT, only useful together with lock_memory.
+  size_t stack_prefault;
+};
+
+/*!
+ * \brief A setting that could not be applied
+ */
+struct SVHThreadSetupFailure
+{
+  //! name of the thread, empty for settings of the process
+  std::string thread;
+  //! the setting, i.e. "policy", "affinity", "name", "lock_memory" or "stack_prefault"
+  std::string setting;
+  //! errno describing why it failed
+  int error;
+};
+
+/*!
+ * \brief Starts threads with their settings and collects what could not be applied
+ *
+ * Every failure is logged once and kept until clear() is called, also if a thread is restarted
+ * and fails again.
+ */
+class DRIVER_SVH_IMPORT_EXPORT SVHThreadSetup
+{
+public:
+  SVHThreadSetup();
+
+  //! sets the stack size that threads started afterwards prefault
+  void setStackPrefault(size_t bytes) { m_stack_prefault = bytes; }
+
+  /*!
+   * \brief start starts a thread that applies the settings to itself before running body
+   * \param settings settings of the new thread
+   * \param body function the thread runs
+   * \return the thread, the settings are applied once this returns
+   */
+  std::thread start(const SVHThreadSettings& settings, const std::function<void()>& body);
+
+  //! applies the settings to the calling thread
+  void apply(const SVHThreadSettings& settings);
+
+  //! locks all current and future pages of the process in RAM, false on failure
+  bool lockMemory();
+
+  //! settings that could not be applied so far
+  std::vector<SVHThreadSetupFailure> failures() const;
+
+  //! forgets all failures, e.g. before connecting again
+  void clear();
+
+private:
+  //! logs and records a failure unless it is already known
+  void fail(const std::string& thread, const std::string& setting, int error);
+
+  //! bytes of stack touched by threads that are started
+  size_t m_stack_prefault;
+
+  //! settings that could not be applied
+  std::vector<SVHThreadSetupFailure> m_failures;
+
+  //! guards m_failures, threads apply their settings concurrently
+  mutable std::mutex m_mutex;
+};
+
+} // namespace driver_svh
+
+#endif
@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains a bounded multi-producer, single-consumer ring buffer.
+ * Any number of threads can push transmit requests without taking a lock while
+ * a single writer thread pops them and owns the serial device. As every
+ * element is written by exactly one consumer, frames can never interleave on
+ * the wire.
+ */
+//----------------------------------------------------------------------
+#ifndef DRIVER_SVH_SVH_TRANSMIT_QUEUE_H_INCLUDED
+#define DRIVER_SVH_SVH_TRANSMIT_QUEUE_H_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace driver_svh {
+
+/*!
+ * \brief Lock-free bounded queue for many producers and one consumer.
+ *
+ * Every cell carries a sequence number that tells producers whether it is free and the consumer
+ * whether it has been published (see D. Vyukov's bounded MPMC queue). Producers claim a cell with
+ * a single compare and swap on the enqueue position, the consumer needs no atomic read-modify-write
+ * at all. The capacity is rounded up to the next power of two.
+ */
+template <typename T>
+class SVHTransmitQueue
+{
+public:
+  /*!
+   * \brief SVHTransmitQueue allocates all cells up front, push() and pop() never allocate
+   * \param capacity minimum number of elements the queue can hold
+   */
+  explicit SVHTransmitQueue(size_t capacity)
+    : m_capacity(roundUpToPowerOfTwo(capacity))
+    , m_mask(m_capacity - 1)
+    , m_cells(new Cell[m_capacity])
+    , m_enqueue_pos(0)
+    , m_dequeue_pos(0)
+  {
+    for (size_t i = 0; i < m_capacity; ++i)
+    {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /*!
+   * \brief push adds an element, may be called from any thread
+   * \param value element to move into the queue, left untouched if the queue is full
+   * \return false if the queue is full
+   */
+  bool push(T& value)
+  {
+    Cell* cell;
+    size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      cell            = &m_cells[pos & m_mask];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      std::ptrdiff_t diff =
+        static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0)
+      {
+        // The cell is free, try to claim it
+        if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        // The consumer has not freed this cell yet
+        return false;
+      }
+      else
+      {
+        // Another producer was faster
+        pos = m_enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * \brief pop removes the oldest published element, must only be called from the consumer thread
+   * \param value receives the element
+   * \return false if no element is available
+   */
+  bool pop(T& value)
+  {
+    size_t pos      = m_dequeue_pos.load(std::memory_order_relaxed);
+    Cell* cell      = &m_cells[pos & m_mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    if (sequence != pos + 1)
+    {
+      // Empty or the producer of this cell is still writing it
+      return false;
+    }
+
+    value = std::move(cell->value);
+    // Leave no moved-from resources behind in the cell
+    cell->value = T();
+    m_dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+    cell->sequence.store(pos + m_capacity, std::memory_order_release);
+    return true;
+  }
+
+  //! number of claimed cells, exact only if no producer or consumer is active
+  size_t size() const
+  {
+    size_t dequeue_pos = m_dequeue_pos.load();
+    size_t enqueue_pos = m_enqueue_pos.load();
+    return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+  }
+
+  //! true if no cell is claimed
+  bool empty() const { return size() == 0; }
+
+  //! maximum number of elements the queue can hold
+  size_t capacity() const { return m_capacity; }
+
+private:
+  //! storage cell of one element
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  static size_t roundUpToPowerOfTwo(size_t value)
+  {
+    size_t result = 1;
+    while (result < value)
+    {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  //! number of cells, a power of two
+  const size_t m_capacity;
+
+  //! mask to map a position to its cell
+  const size_t m_mask;
+
+  //! storage of all cells
+  std::unique_ptr<Cell[]> m_cells;
+
+  //! position of the next element to be pushed
+  std::atomic<size_t> m_enqueue_pos;
+
+  //! position of the next element to be popped
+  std::atomic<size_t> m_dequeue_pos;
+};
+
+} // namespace driver_svh
+
+#endif
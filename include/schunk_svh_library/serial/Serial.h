@@ -156,6 +156,11 @@ public:
     \param size bytes are available.
    */
   ssize_t read(void* data, ssize_t size, unsigned long time = 100, bool return_on_less_data = true);
+  /*!
+    Read the bytes that are available right now. Never waits, returns 0
+    if nothing was received. Reads at most \param size bytes into \param data.
+   */
+  ssize_t readAvailable(void* data, ssize_t size);
   /*!
     All routines return a negavtiv number on error. Then the global errno is
     stored into a private variable. Use this funtion to ask for this value.
@@ -45,13 +45,15 @@
 //----------------------------------------------------------------------
 #include "schunk_svh_library/control/SVHController.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <functional>
 #include <schunk_svh_library/Logger.h>
+#include <schunk_svh_library/control/SVHProtocolCodec.h>
 #include <schunk_svh_library/serial/ByteOrderConversion.h>
 #include <thread>
 
-using driver_svh::ArrayBuilder;
 
 namespace driver_svh {
 
@@ -95,11 +97,25 @@ SVHController::SVHController()
   : m_current_settings(SVH_DIMENSION)
   , // Vectors have to be filled with objects for correct deserialization
   m_position_settings(SVH_DIMENSION)
-  , m_controller_feedback(SVH_DIMENSION)
+  , m_received_feedback(SVH_DIMENSION)
+  , m_firmware_info_received(false)
   , m_serial_interface(new SVHSerialInterface(std::bind(
       &SVHController::receivedPacketCallback, this, std::placeholders::_1, std::placeholders::_2)))
   , m_enable_mask(0)
   , m_received_package_count(0)
+  , m_asynchronous_transmit(false)
+  , m_emergency_stop_latency(0)
+  , m_command_targets(SVH_DIMENSION, 0)
+  , m_command_known_mask(0)
+  , m_command_pending_mask(0)
+  , m_command_window(0)
+  , m_command_batch_depth(0)
+  , m_coalesced_commands(0)
+  , m_command_tolerance(-1)
+  , m_command_keepalive(std::chrono::milliseconds(100))
+  , m_command_sent_times(SVH_DIMENSION)
+  , m_suppressed_commands(SVH_DIMENSION, 0)
+  , m_command_flusher_running(false)
 {
   SVH_LOG_DEBUG_STREAM("SVHController", "SVH Controller started");
   m_firmware_info.version_major = 0;
@@ -108,6 +124,8 @@ SVHController::SVHController()
 
 SVHController::~SVHController()
 {
+  stopCommandFlusher();
+
   if (m_serial_interface != NULL)
   {
     disconnect();
@@ -118,12 +136,18 @@ SVHController::~SVHController()
   SVH_LOG_DEBUG_STREAM("SVHController", "SVH Controller terminated");
 }
 
-bool SVHController::connect(const std::string& dev_name)
+bool SVHController::connect(const std::string& dev_name, const SVHThreadConfig& thread_config)
 {
   SVH_LOG_DEBUG_STREAM("SVHController", "Connect was called, starting the serial interface...");
   if (m_serial_interface != NULL)
   {
-    bool success = m_serial_interface->connect(dev_name);
+    {
+      std::lock_guard<std::mutex> lock(m_command_mutex);
+      m_thread_config = thread_config;
+      m_thread_setup.clear();
+      m_thread_setup.setStackPrefault(thread_config.stack_prefault);
+    }
+    bool success = m_serial_interface->connect(dev_name, thread_config);
     SVH_LOG_DEBUG_STREAM("SVHController",
                          "Connect finished " << ((success) ? "succesfully" : "with an error"));
     return success;
@@ -135,10 +159,26 @@ bool SVHController::connect(const std::string& dev_name)
   }
 }
 
+std::vector<SVHThreadSetupFailure> SVHController::getThreadSetupFailures() const
+{
+  std::vector<SVHThreadSetupFailure> failures = m_serial_interface->threadSetupFailures();
+  std::vector<SVHThreadSetupFailure> own      = m_thread_setup.failures();
+  failures.insert(failures.end(), own.begin(), own.end());
+  return failures;
+}
+
 void SVHController::disconnect()
 {
   SVH_LOG_DEBUG_STREAM("SVHController",
                        "Disconnect called, disabling all channels and closing interface...");
+  {
+    // Targets that were collected for the old connection must not be sent on the next one
+    std::lock_guard<std::mutex> lock(m_command_mutex);
+    m_command_pending_mask = 0;
+    m_command_known_mask   = 0;
+    m_command_batch_depth  = 0;
+  }
+
   if (m_serial_interface != NULL && m_serial_interface->isConnected())
   {
     // Disable all channels
@@ -147,27 +187,60 @@ void SVHController::disconnect()
   }
   // Reset the Firmware version, so we get always the current version on a reconnect or 0.0 on
   // failure
+  std::lock_guard<std::mutex> lock(m_firmware_info_mutex);
   m_firmware_info.version_major = 0;
   m_firmware_info.version_minor = 0;
+  m_firmware_info_received      = false;
 
   SVH_LOG_DEBUG_STREAM("SVHController", "Disconnect finished");
 }
 
-void SVHController::setControllerTarget(const SVHChannel& channel, const int32_t& position)
+void SVHController::setControllerTarget(const SVHChannel& channel,
+                                        const int32_t& position,
+                                        bool force)
 {
   // No Sanity Checks for out of bounds positions at this point as the finger manager has already
   // handled these
   if ((channel != SVH_ALL) && (channel >= 0 && channel < SVH_DIMENSION))
   {
-    // The channel is encoded in the index byte
-    SVHSerialPacket serial_packet(0, SVH_SET_CONTROL_COMMAND | static_cast<uint8_t>(channel << 4));
-    SVHControlCommand control_command(position);
-    // Note the 40 byte ArrayBuilder initialization -> this is needed to get a zero padding in the
-    // serialpacket. Otherwise it would be shorter
-    ArrayBuilder ab(40);
-    ab << control_command;
-    serial_packet.data = ab.array;
-    m_serial_interface->sendPacket(serial_packet);
+    std::unique_lock<std::mutex> transmit_lock;
+    {
+      std::lock_guard<std::mutex> lock(m_command_mutex);
+      const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      if (!force && isRedundantCommand(channel, position, now))
+      {
+        m_suppressed_commands[channel]++;
+        return;
+      }
+
+      m_command_targets[channel] = position;
+      m_command_known_mask |= static_cast<uint16_t>(1 << channel);
+      if (force)
+      {
+        // Sent right away, a collected older target of this channel is superseded
+        m_command_pending_mask &= static_cast<uint16_t>(~(1 << channel));
+      }
+      else if (m_command_batch_depth > 0 || m_command_window.count() > 0)
+      {
+        // Collected and sent together with the targets of other channels
+        if (m_command_pending_mask == 0)
+        {
+          m_command_pending_since = std::chrono::steady_clock::now();
+          m_command_condition.notify_all();
+        }
+        m_command_pending_mask |= static_cast<uint16_t>(1 << channel);
+        return;
+      }
+      m_command_sent_times[channel] = now;
+      // Taken before the targets are released so that a frame of older targets cannot overtake
+      transmit_lock = std::unique_lock<std::mutex>(m_command_transmit_mutex);
+    }
+
+    // The channel is encoded in the address byte. The fixed size packet is already zero padded and
+    // keeps this hot path free of allocations
+    SVHFixedSerialPacket serial_packet = encodeRequest<SVH_SET_CONTROL_COMMAND>(
+      SVHControlCommand(position), static_cast<uint8_t>(channel));
+    transmitPacket(serial_packet);
 
     // Debug Disabled as it is way to noisy
     SVH_LOG_DEBUG_STREAM("SVHController",
@@ -182,16 +255,44 @@ void SVHController::setControllerTarget(const SVHChannel& channel, const int32_t
   }
 }
 
-void SVHController::setControllerTargetAllChannels(const std::vector<int32_t>& positions)
+void SVHController::setControllerTargetAllChannels(const std::vector<int32_t>& positions,
+                                                   bool force)
 {
   if (positions.size() >= SVH_DIMENSION)
   {
-    SVHSerialPacket serial_packet(0, SVH_SET_CONTROL_COMMAND_ALL);
-    SVHControlCommandAllChannels control_command(positions);
-    ArrayBuilder ab(40);
-    ab << control_command;
-    serial_packet.data = ab.array;
-    m_serial_interface->sendPacket(serial_packet);
+    // Supersedes all collected targets
+    std::unique_lock<std::mutex> lock(m_command_mutex);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    bool redundant                                  = !force && (m_command_pending_mask == 0);
+    for (size_t i = 0; i < SVH_DIMENSION && redundant; ++i)
+    {
+      redundant = isRedundantCommand(i, positions[i], now);
+    }
+    if (redundant)
+    {
+      for (size_t i = 0; i < SVH_DIMENSION; ++i)
+      {
+        m_suppressed_commands[i]++;
+      }
+      return;
+    }
+
+    std::copy(positions.begin(), positions.begin() + SVH_DIMENSION, m_command_targets.begin());
+    std::fill(m_command_sent_times.begin(), m_command_sent_times.end(), now);
+    m_command_known_mask   = static_cast<uint16_t>((1 << SVH_DIMENSION) - 1);
+    m_command_pending_mask = 0;
+
+    // Same layout as SVHControlCommandAllChannels, written directly to avoid allocations
+    SVHFixedSerialPacket serial_packet(SVH_SET_CONTROL_COMMAND_ALL);
+    size_t offset = 0;
+    for (size_t i = 0; i < SVH_DIMENSION; ++i)
+    {
+      offset = serial_packet.write(offset, positions[i]);
+    }
+    // Taken before the targets are released so that a frame of older targets cannot overtake
+    std::lock_guard<std::mutex> transmit_lock(m_command_transmit_mutex);
+    lock.unlock();
+    transmitPacket(serial_packet);
 
     // Debug Disabled as it is way to noisy
     SVH_LOG_DEBUG_STREAM("SVHController",
@@ -215,11 +316,227 @@ void SVHController::setControllerTargetAllChannels(const std::vector<int32_t>& p
   }
 }
 
+void SVHController::setCommandCoalescing(const std::chrono::microseconds& window)
+{
+  std::unique_lock<std::mutex> lock(m_command_mutex);
+  m_command_window = std::max(window, std::chrono::microseconds(0));
+  if (m_command_window.count() > 0)
+  {
+    if (!m_command_flusher_running)
+    {
+      m_command_flusher_running = true;
+      m_command_flusher =
+        m_thread_setup.start(m_thread_config.command, [this] { runCommandFlusher(); });
+    }
+    m_command_condition.notify_all();
+  }
+  else
+  {
+    lock.unlock();
+    stopCommandFlusher();
+  }
+}
+
+void SVHController::beginCommandBatch()
+{
+  std::lock_guard<std::mutex> lock(m_command_mutex);
+  m_command_batch_depth++;
+}
+
+void SVHController::commitCommandBatch()
+{
+  std::unique_lock<std::mutex> lock(m_command_mutex);
+  if (m_command_batch_depth == 0)
+  {
+    SVH_LOG_WARN_STREAM("SVHController",
+                        "commitCommandBatch was called without beginCommandBatch - ignoring");
+    return;
+  }
+  if (--m_command_batch_depth == 0)
+  {
+    SVHCommandPackets packets;
+    const size_t count = flushPendingCommands(packets);
+    transmitCommandPackets(lock, packets, count);
+  }
+}
+
+uint64_t SVHController::getCoalescedCommandCount()
+{
+  std::lock_guard<std::mutex> lock(m_command_mutex);
+  return m_coalesced_commands;
+}
+
+void SVHController::setCommandDeadband(int32_t tolerance,
+                                       const std::chrono::milliseconds& keepalive)
+{
+  std::lock_guard<std::mutex> lock(m_command_mutex);
+  m_command_tolerance = tolerance;
+  m_command_keepalive = keepalive;
+}
+
+uint64_t SVHController::getSuppressedCommandCount(const SVHChannel& channel)
+{
+  std::lock_guard<std::mutex> lock(m_command_mutex);
+  if (channel == SVH_ALL)
+  {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < SVH_DIMENSION; ++i)
+    {
+      sum += m_suppressed_commands[i];
+    }
+    return sum;
+  }
+  if (channel >= 0 && channel < SVH_DIMENSION)
+  {
+    return m_suppressed_commands[channel];
+  }
+  SVH_LOG_WARN_STREAM("SVHController",
+                      "Suppressed command count was requested for unknown channel: " << channel);
+  return 0;
+}
+
+bool SVHController::isRedundantCommand(size_t channel,
+                                       int32_t position,
+                                       const std::chrono::steady_clock::time_point& now) const
+{
+  // Only targets that were actually sent before can make a new one redundant
+  if (m_command_tolerance < 0 || !(m_command_known_mask & (1 << channel)) ||
+      (m_command_pending_mask & (1 << channel)))
+  {
+    return false;
+  }
+  const int64_t difference = static_cast<int64_t>(position) - m_command_targets[channel];
+  return std::abs(difference) <= m_command_tolerance &&
+         (now - m_command_sent_times[channel]) < m_command_keepalive;
+}
+
+size_t SVHController::flushPendingCommands(SVHCommandPackets& packets)
+{
+  if (m_command_pending_mask == 0)
+  {
+    return 0;
+  }
+
+  unsigned int count = 0;
+  for (int i = 0; i < SVH_DIMENSION; ++i)
+  {
+    if (m_command_pending_mask & (1 << i))
+    {
+      count++;
+    }
+  }
+  const uint16_t pending = m_command_pending_mask;
+  m_command_pending_mask = 0;
+
+  // Channels that never got a target are held at their current position. Before the first
+  // feedback of such a channel that position is unknown and the frame would drive it to tick 0.
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  SVHFixedSerialPacket serial_packet(SVH_SET_CONTROL_COMMAND_ALL);
+  size_t offset = 0;
+  bool merge    = (count > 1);
+  for (size_t i = 0; i < SVH_DIMENSION && merge; ++i)
+  {
+    int32_t target = m_command_targets[i];
+    if (!(m_command_known_mask & (1 << i)))
+    {
+      SVHFeedbackSample sample;
+      m_feedback_store.load(i, sample);
+      merge  = (sample.sequence > 0);
+      target = sample.feedback.position;
+    }
+    offset = serial_packet.write(offset, target);
+  }
+  if (merge)
+  {
+    packets[0] = serial_packet;
+    std::fill(m_command_sent_times.begin(), m_command_sent_times.end(), now);
+    m_coalesced_commands += count;
+    return 1;
+  }
+
+  // Single commands do not touch the other channels
+  size_t packet_count = 0;
+  for (int i = 0; i < SVH_DIMENSION; ++i)
+  {
+    if (pending & (1 << i))
+    {
+      packets[packet_count++] = encodeRequest<SVH_SET_CONTROL_COMMAND>(
+        SVHControlCommand(m_command_targets[i]), static_cast<uint8_t>(i));
+      m_command_sent_times[i] = now;
+    }
+  }
+  return packet_count;
+}
+
+void SVHController::transmitCommandPackets(std::unique_lock<std::mutex>& lock,
+                                           SVHCommandPackets& packets,
+                                           size_t count)
+{
+  if (count == 0)
+  {
+    lock.unlock();
+    return;
+  }
+
+  // Taken before the targets are released so that a frame of older targets cannot overtake
+  std::lock_guard<std::mutex> transmit_lock(m_command_transmit_mutex);
+  lock.unlock();
+  for (size_t i = 0; i < count; ++i)
+  {
+    transmitPacket(packets[i]);
+  }
+}
+
+void SVHController::runCommandFlusher()
+{
+  std::unique_lock<std::mutex> lock(m_command_mutex);
+  while (m_command_flusher_running)
+  {
+    if (m_command_pending_mask == 0 || m_command_batch_depth > 0)
+    {
+      m_command_condition.wait(lock);
+      continue;
+    }
+
+    const std::chrono::steady_clock::time_point deadline =
+      m_command_pending_since + m_command_window;
+    if (std::chrono::steady_clock::now() < deadline)
+    {
+      m_command_condition.wait_until(lock, deadline);
+      continue;
+    }
+    SVHCommandPackets packets;
+    const size_t count = flushPendingCommands(packets);
+    transmitCommandPackets(lock, packets, count);
+    lock.lock();
+  }
+}
+
+void SVHController::stopCommandFlusher()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_command_mutex);
+    m_command_flusher_running = false;
+    m_command_condition.notify_all();
+  }
+  if (m_command_flusher.joinable())
+  {
+    m_command_flusher.join();
+  }
+
+  std::unique_lock<std::mutex> lock(m_command_mutex);
+  if (m_command_batch_depth == 0)
+  {
+    SVHCommandPackets packets;
+    const size_t count = flushPendingCommands(packets);
+    transmitCommandPackets(lock, packets, count);
+  }
+}
+
 void SVHController::enableChannel(const SVHChannel& channel)
 {
-  SVHSerialPacket serial_packet(0, SVH_SET_CONTROLLER_STATE);
+  SVHFixedSerialPacket serial_packet(SVH_SET_CONTROLLER_STATE);
   SVHControllerState controller_state;
-  ArrayBuilder ab(40);
 
   SVH_LOG_DEBUG_STREAM("SVHController", "Enable of channel " << channel << " requested.");
 
@@ -234,37 +551,25 @@ void SVHController::enableChannel(const SVHChannel& channel)
     // Reset faults and overtemperature warnings saved in the controller
     controller_state.pwm_fault = 0x001F;
     controller_state.pwm_otw   = 0x001F;
-    ab << controller_state;
-    serial_packet.data = ab.array;
-    m_serial_interface->sendPacket(serial_packet);
-    ab.reset(40);
-
+    serial_packet = encodeRequest<SVH_SET_CONTROLLER_STATE>(controller_state);
     // Small delays seem to make communication at this point more reliable although they SHOULD NOT
     // be necessary
-    std::this_thread::sleep_for(std::chrono::microseconds(2000));
+    transmitPacket(serial_packet, std::chrono::microseconds(2000));
 
     SVH_LOG_DEBUG_STREAM("SVHController",
                          "Enabling 12V Driver (pwm_reset and pwm_active = 0x0200)...");
     // enable +12v supply driver
     controller_state.pwm_reset  = 0x0200;
     controller_state.pwm_active = 0x0200;
-    ab << controller_state;
-    serial_packet.data = ab.array;
-    m_serial_interface->sendPacket(serial_packet);
-    ab.reset(40);
-
-    std::this_thread::sleep_for(std::chrono::microseconds(2000));
+    serial_packet = encodeRequest<SVH_SET_CONTROLLER_STATE>(controller_state);
+    transmitPacket(serial_packet, std::chrono::microseconds(2000));
 
     SVH_LOG_DEBUG_STREAM("SVHController", "Enabling pos_ctrl and cur_ctrl...");
     // enable controller
     controller_state.pos_ctrl = 0x0001;
     controller_state.cur_ctrl = 0x0001;
-    ab << controller_state;
-    serial_packet.data = ab.array;
-    m_serial_interface->sendPacket(serial_packet);
-    ab.reset(40);
-
-    std::this_thread::sleep_for(std::chrono::microseconds(2000));
+    serial_packet = encodeRequest<SVH_SET_CONTROLLER_STATE>(controller_state);
+    transmitPacket(serial_packet, std::chrono::microseconds(2000));
 
     SVH_LOG_DEBUG_STREAM("SVHController", "...Done");
   }
@@ -280,25 +585,18 @@ void SVHController::enableChannel(const SVHChannel& channel)
     // Systems ---> this has to do with the initialization of the hardware controllers. If we split
     // it in two calls we will reset them first and then activate making sure that all values are
     // initialized properly effectively preventing any jumping behaviour
-    ab.reset(40);
     controller_state.pwm_fault  = 0x001F;
     controller_state.pwm_otw    = 0x001F;
     controller_state.pwm_reset  = (0x0200 | (m_enable_mask & 0x01FF));
     controller_state.pwm_active = (0x0200 | (m_enable_mask & 0x01FF));
-    ab << controller_state;
-    serial_packet.data = ab.array;
-    m_serial_interface->sendPacket(serial_packet);
-    ab.reset(40);
-
+    serial_packet = encodeRequest<SVH_SET_CONTROLLER_STATE>(controller_state);
     // WARNING: DO NOT ! REMOVE THESE DELAYS OR THE HARDWARE WILL! FREAK OUT! (see reason above)
-    std::this_thread::sleep_for(std::chrono::microseconds(500));
+    transmitPacket(serial_packet, std::chrono::microseconds(500));
 
     controller_state.pos_ctrl = 0x0001;
     controller_state.cur_ctrl = 0x0001;
-    ab << controller_state;
-    serial_packet.data = ab.array;
-    m_serial_interface->sendPacket(serial_packet);
-    ab.reset(40);
+    serial_packet = encodeRequest<SVH_SET_CONTROLLER_STATE>(controller_state);
+    transmitPacket(serial_packet);
 
     SVH_LOG_DEBUG_STREAM("SVHController", "Enabled channel: " << channel);
   }
@@ -317,23 +615,37 @@ void SVHController::disableChannel(const SVHChannel& channel)
   if (m_serial_interface != NULL && m_serial_interface->isConnected())
   {
     // prepare general packet
-    SVHSerialPacket serial_packet(0, SVH_SET_CONTROLLER_STATE);
+    SVHFixedSerialPacket serial_packet(SVH_SET_CONTROLLER_STATE);
     SVHControllerState controller_state;
-    ArrayBuilder ab(40);
 
     // we just accept it at this point because it makes no difference in the calls
     if (channel == SVH_ALL)
     {
-      m_enable_mask              = 0;
-      controller_state.pwm_fault = 0x001F;
-      controller_state.pwm_otw   = 0x001F;
-
-      // default initialization to zero -> controllers are deactivated
-      ab << controller_state;
-      serial_packet.data = ab.array;
-      m_serial_interface->sendPacket(serial_packet);
+      const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      m_enable_mask                                     = 0;
+      controller_state.pwm_fault                        = 0x001F;
+      controller_state.pwm_otw                          = 0x001F;
+
+      // default initialization to zero -> controllers are deactivated. Written right away instead
+      // of waiting behind queued packets, which are dropped.
+      serial_packet = encodeRequest<SVH_SET_CONTROLLER_STATE>(controller_state);
+      if (m_serial_interface->sendEmergencyPacket(serial_packet))
+      {
+        const std::chrono::microseconds latency =
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                start);
+        m_emergency_stop_latency = latency.count();
+        if (m_request_tracker.isActive())
+        {
+          m_request_tracker.track(serial_packet);
+        }
+        SVH_LOG_DEBUG_STREAM("SVHController",
+                             "Disabled all channels after " << latency.count() << " us");
+      }
 
-      SVH_LOG_DEBUG_STREAM("SVHController", "Disabled all channels");
+      // Collected targets must not move the fingers again once they are enabled
+      std::lock_guard<std::mutex> lock(m_command_mutex);
+      m_command_pending_mask = 0;
     }
     else if (channel >= 0 && channel < SVH_DIMENSION)
     {
@@ -350,9 +662,8 @@ void SVHController::disableChannel(const SVHChannel& channel)
         controller_state.cur_ctrl   = 0x0001;
       }
 
-      ab << controller_state;
-      serial_packet.data = ab.array;
-      m_serial_interface->sendPacket(serial_packet);
+      serial_packet = encodeRequest<SVH_SET_CONTROLLER_STATE>(controller_state);
+      transmitPacket(serial_packet);
 
       SVH_LOG_DEBUG_STREAM("SVHController", "Disabled channel: " << channel);
     }
@@ -370,20 +681,25 @@ void SVHController::disableChannel(const SVHChannel& channel)
   }
 }
 
+std::chrono::microseconds SVHController::getEmergencyStopLatency()
+{
+  return std::chrono::microseconds(m_emergency_stop_latency);
+}
+
 void SVHController::requestControllerState()
 {
   SVH_LOG_DEBUG_STREAM("SVHController", "Requesting ControllerStatefrom Hardware");
   SVHSerialPacket serial_packet(40, SVH_GET_CONTROLLER_STATE);
-  m_serial_interface->sendPacket(serial_packet);
+  transmitPacket(serial_packet);
 }
 
 void SVHController::requestControllerFeedback(const SVHChannel& channel)
 {
   if ((channel != SVH_ALL) && (channel >= 0 && channel < SVH_DIMENSION))
   {
-    SVHSerialPacket serial_packet(40,
-                                  SVH_GET_CONTROL_FEEDBACK | static_cast<uint8_t>(channel << 4));
-    m_serial_interface->sendPacket(serial_packet);
+    SVHFixedSerialPacket serial_packet(SVH_GET_CONTROL_FEEDBACK |
+                                       static_cast<uint8_t>(channel << 4));
+    transmitPacket(serial_packet);
 
     // Disabled as it spams the output to much
     SVH_LOG_DEBUG_STREAM("SVHController",
@@ -391,8 +707,8 @@ void SVHController::requestControllerFeedback(const SVHChannel& channel)
   }
   else if (channel == SVH_ALL)
   {
-    SVHSerialPacket serial_packet(40, SVH_GET_CONTROL_FEEDBACK_ALL);
-    m_serial_interface->sendPacket(serial_packet);
+    SVHFixedSerialPacket serial_packet(SVH_GET_CONTROL_FEEDBACK_ALL);
+    transmitPacket(serial_packet);
 
     // Disabled as it spams the output to much
     SVH_LOG_DEBUG_STREAM("SVHController", "Controller feedback was requested for all channels ");
@@ -411,7 +727,7 @@ void SVHController::requestPositionSettings(const SVHChannel& channel)
                        "Requesting PositionSettings from Hardware for channel: " << channel);
   SVHSerialPacket serial_packet(40,
                                 (SVH_GET_POSITION_SETTINGS | static_cast<uint8_t>(channel << 4)));
-  m_serial_interface->sendPacket(serial_packet);
+  transmitPacket(serial_packet);
 }
 
 void SVHController::setPositionSettings(const SVHChannel& channel,
@@ -419,12 +735,9 @@ void SVHController::setPositionSettings(const SVHChannel& channel,
 {
   if ((channel != SVH_ALL) && (channel >= 0 && channel < SVH_DIMENSION))
   {
-    SVHSerialPacket serial_packet(0,
-                                  SVH_SET_POSITION_SETTINGS | static_cast<uint8_t>(channel << 4));
-    ArrayBuilder ab;
-    ab << position_settings;
-    serial_packet.data = ab.array;
-    m_serial_interface->sendPacket(serial_packet);
+    SVHFixedSerialPacket serial_packet =
+      encodeRequest<SVH_SET_POSITION_SETTINGS>(position_settings, static_cast<uint8_t>(channel));
+    transmitPacket(serial_packet);
 
     // Save already in case we dont get immediate response
     m_position_settings[channel] = position_settings;
@@ -460,7 +773,7 @@ void SVHController::requestCurrentSettings(const SVHChannel& channel)
   {
     SVHSerialPacket serial_packet(40,
                                   (SVH_GET_CURRENT_SETTINGS | static_cast<uint8_t>(channel << 4)));
-    m_serial_interface->sendPacket(serial_packet);
+    transmitPacket(serial_packet);
   }
   else
   {
@@ -476,11 +789,9 @@ void SVHController::setCurrentSettings(const SVHChannel& channel,
 {
   if ((channel != SVH_ALL) && (channel >= 0 && channel < SVH_DIMENSION))
   {
-    SVHSerialPacket serial_packet(0, SVH_SET_CURRENT_SETTINGS | static_cast<uint8_t>(channel << 4));
-    ArrayBuilder ab;
-    ab << current_settings;
-    serial_packet.data = ab.array;
-    m_serial_interface->sendPacket(serial_packet);
+    SVHFixedSerialPacket serial_packet =
+      encodeRequest<SVH_SET_CURRENT_SETTINGS>(current_settings, static_cast<uint8_t>(channel));
+    transmitPacket(serial_packet);
 
     // Save already in case we dont get immediate response
     m_current_settings[channel] = current_settings;
@@ -512,7 +823,7 @@ void SVHController::requestEncoderValues()
 {
   SVH_LOG_DEBUG_STREAM("SVHController", "Requesting EncoderValues from hardware");
   SVHSerialPacket serial_packet(40, SVH_GET_ENCODER_VALUES);
-  m_serial_interface->sendPacket(serial_packet);
+  transmitPacket(serial_packet);
 }
 
 void SVHController::setEncoderValues(const SVHEncoderSettings& encoder_settings)
@@ -526,11 +837,8 @@ void SVHController::setEncoderValues(const SVHEncoderSettings& encoder_settings)
                              << ": " << encoder_settings.scalings[i] << " ");
   }
 
-  SVHSerialPacket serial_packet(0, SVH_SET_ENCODER_VALUES);
-  ArrayBuilder ab;
-  ab << encoder_settings;
-  serial_packet.data = ab.array;
-  m_serial_interface->sendPacket(serial_packet);
+  SVHFixedSerialPacket serial_packet = encodeRequest<SVH_SET_ENCODER_VALUES>(encoder_settings);
+  transmitPacket(serial_packet);
 
   // Save already in case we dont get imediate response
   m_encoder_settings = encoder_settings;
@@ -541,36 +849,48 @@ void SVHController::requestFirmwareInfo()
   SVH_LOG_DEBUG_STREAM("SVHController", "Requesting firmware Information from hardware");
 
   SVHSerialPacket serial_packet(40, SVH_GET_FIRMWARE_INFO);
-  m_serial_interface->sendPacket(serial_packet);
+  transmitPacket(serial_packet);
 }
 
 void SVHController::receivedPacketCallback(const SVHSerialPacket& packet, unsigned int packet_count)
 {
   // Extract Channel
   uint8_t channel = (packet.address >> 4) & 0x0F;
-  // Prepare Data for conversion
-  ArrayBuilder ab;
-  ab.appendWithoutConversion(packet.data);
-
-  SVHControllerFeedbackAllChannels feedback_all;
+  // Packet meaning is encoded in the lower nibble of the adress byte
+  uint8_t command = packet.address & 0x0F;
 
+  // All payloads are decoded straight from the packet bytes by the protocol codec. A payload that
+  // is shorter than the wire layout of its address is rejected instead of being misparsed.
   m_received_package_count = packet_count;
 
-  // Packet meaning is encoded in the lower nibble of the adress byte
-  switch (packet.address & 0x0F)
+  // The hand echoes index and address of the request it answers
+  m_request_tracker.acknowledge(packet.index, packet.address);
+
+  // Packets that did not pass the receive thread (e.g. injected ones) carry no receive time
+  const std::chrono::steady_clock::time_point timestamp =
+    (packet.timestamp == std::chrono::steady_clock::time_point()) ? std::chrono::steady_clock::now()
+                                                                  : packet.timestamp;
+
+  switch (command)
   {
     case SVH_GET_CONTROL_FEEDBACK:
     case SVH_SET_CONTROL_COMMAND:
       if (channel >= 0 && channel < SVH_DIMENSION)
       {
-        // std::cout << "Recieved: Controllerfeedback RAW Data: " << ab;
-        ab >> m_controller_feedback[channel];
+        SVHControllerFeedback feedback;
+        if (!decodeResponse<SVH_GET_CONTROL_FEEDBACK>(packet.data, feedback))
+        {
+          SVH_LOG_ERROR_STREAM("SVHController",
+                               "Received a truncated Control Feedback packet for channel "
+                                 << channel << "- packet ignored!");
+          break;
+        }
+        m_feedback_store.store(channel, feedback, timestamp);
         // Disabled as this is spamming the output to much
         SVH_LOG_DEBUG_STREAM("SVHController",
                              "Received a Control Feedback/Control Command packet for channel "
-                               << channel
-                               << " Position: " << (int)m_controller_feedback[channel].position
-                               << " Current: " << (int)m_controller_feedback[channel].current);
+                               << channel << " Position: " << (int)feedback.position
+                               << " Current: " << (int)feedback.current);
       }
       else
       {
@@ -582,11 +902,17 @@ void SVHController::receivedPacketCallback(const SVHSerialPacket& packet, unsign
       break;
     case SVH_GET_CONTROL_FEEDBACK_ALL:
     case SVH_SET_CONTROL_COMMAND_ALL:
-      // We cannot just read them all into the vector (which would have been nice) because the
-      // feedback of all channels is structured different from the feedback of one channel. So the
-      // SVHControllerFeedbackAllChannels is used as an intermediary ( handles the deserialization)
-      ab >> feedback_all;
-      m_controller_feedback = feedback_all.feedbacks;
+      // The feedback of all channels is structured different from the feedback of one channel
+      // (positions first, currents afterwards). It is decoded into a preallocated buffer and
+      // published to the readers as one update.
+      if (!decodeResponse<SVH_GET_CONTROL_FEEDBACK_ALL>(packet.data, m_received_feedback))
+      {
+        SVH_LOG_ERROR_STREAM("SVHController",
+                             "Received a truncated Control Feedback packet for all channels "
+                             "- packet ignored!");
+        break;
+      }
+      m_feedback_store.storeAll(m_received_feedback, timestamp);
       // Disabled as this is spannimg the output to much
       SVH_LOG_DEBUG_STREAM(
         "SVHController",
@@ -596,9 +922,13 @@ void SVHController::receivedPacketCallback(const SVHSerialPacket& packet, unsign
     case SVH_SET_POSITION_SETTINGS:
       if (channel >= 0 && channel < SVH_DIMENSION)
       {
-        // std::cout << "Recieved: Postitionsettings RAW Data: " << ab; // for really intensive
-        // debugging
-        ab >> m_position_settings[channel];
+        if (!decodeResponse<SVH_GET_POSITION_SETTINGS>(packet.data, m_position_settings[channel]))
+        {
+          SVH_LOG_ERROR_STREAM("SVHController",
+                               "Received a truncated position setting packet for channel "
+                                 << channel << "- packet ignored!");
+          break;
+        }
         SVH_LOG_DEBUG_STREAM("SVHController",
                              "Received a get/set position setting packet for channel " << channel);
         SVH_LOG_DEBUG_STREAM("SVHController",
@@ -624,9 +954,13 @@ void SVHController::receivedPacketCallback(const SVHSerialPacket& packet, unsign
     case SVH_SET_CURRENT_SETTINGS:
       if (channel >= 0 && channel < SVH_DIMENSION)
       {
-        // std::cout << "Recieved: Current Settings RAW Data: " << ab; // for really intensive
-        // debugging
-        ab >> m_current_settings[channel];
+        if (!decodeResponse<SVH_GET_CURRENT_SETTINGS>(packet.data, m_current_settings[channel]))
+        {
+          SVH_LOG_ERROR_STREAM("SVHController",
+                               "Received a truncated current setting packet for channel "
+                                 << channel << "- packet ignored!");
+          break;
+        }
         SVH_LOG_DEBUG_STREAM("SVHController",
                              "Received a get/set current setting packet for channel " << channel);
         SVH_LOG_DEBUG_STREAM("SVHController",
@@ -650,9 +984,12 @@ void SVHController::receivedPacketCallback(const SVHSerialPacket& packet, unsign
       break;
     case SVH_GET_CONTROLLER_STATE:
     case SVH_SET_CONTROLLER_STATE:
-      // std::cout << "Recieved: Controller State RAW Data: " << ab; // for really intensive
-      // debugging
-      ab >> m_controller_state;
+      if (!decodeResponse<SVH_GET_CONTROLLER_STATE>(packet.data, m_controller_state))
+      {
+        SVH_LOG_ERROR_STREAM("SVHController",
+                             "Received a truncated controller state packet - packet ignored!");
+        break;
+      }
       // std::cout << "Received controllerState interpreded data: "<< m_controller_state <<
       // std::endl; // for really intensive debugging
       SVH_LOG_DEBUG_STREAM("SVHController", "Received a get/set controler state packet ");
@@ -674,18 +1011,32 @@ void SVHController::receivedPacketCallback(const SVHSerialPacket& packet, unsign
     case SVH_GET_ENCODER_VALUES:
     case SVH_SET_ENCODER_VALUES:
       SVH_LOG_DEBUG_STREAM("SVHController", "Received a get/set encoder settings packet ");
-      ab >> m_encoder_settings;
+      if (!decodeResponse<SVH_GET_ENCODER_VALUES>(packet.data, m_encoder_settings))
+      {
+        SVH_LOG_ERROR_STREAM("SVHController",
+                             "Received a truncated encoder settings packet - packet ignored!");
+      }
       break;
     case SVH_GET_FIRMWARE_INFO:
-      // std::cout << "Recieved: Firmware Settings RAW Data: " << ab; // for really intensive
-      // debugging
-      ab >> m_firmware_info;
+    {
+      SVHFirmwareInfo firmware_info;
+      if (!decodeResponse<SVH_GET_FIRMWARE_INFO>(packet.data, firmware_info))
+      {
+        SVH_LOG_ERROR_STREAM("SVHController",
+                             "Received a truncated firmware info packet - packet ignored!");
+        break;
+      }
       SVH_LOG_INFO_STREAM("SVHController",
                           "Hardware is using the following Firmware: "
-                            << m_firmware_info.svh << " Version: " << m_firmware_info.version_major
-                            << "." << m_firmware_info.version_minor << " : "
-                            << m_firmware_info.text);
+                            << firmware_info.svh << " Version: " << firmware_info.version_major
+                            << "." << firmware_info.version_minor << " : "
+                            << firmware_info.text);
+      std::lock_guard<std::mutex> lock(m_firmware_info_mutex);
+      m_firmware_info          = firmware_info;
+      m_firmware_info_received = true;
+      m_firmware_info_condition.notify_all();
       break;
+    }
     default:
       SVH_LOG_ERROR_STREAM("SVHController",
                            "Received a Packet with unknown address: " << (packet.address & 0x0F)
@@ -697,9 +1048,8 @@ void SVHController::receivedPacketCallback(const SVHSerialPacket& packet, unsign
 bool SVHController::getControllerFeedback(const SVHChannel& channel,
                                           SVHControllerFeedback& controller_feedback)
 {
-  if (channel >= 0 && static_cast<uint8_t>(channel) < m_controller_feedback.size())
+  if (channel >= 0 && m_feedback_store.load(static_cast<size_t>(channel), controller_feedback))
   {
-    controller_feedback = m_controller_feedback[channel];
     return true;
   }
   else
@@ -714,7 +1064,93 @@ bool SVHController::getControllerFeedback(const SVHChannel& channel,
 void SVHController::getControllerFeedbackAllChannels(
   SVHControllerFeedbackAllChannels& controller_feedback)
 {
-  controller_feedback.feedbacks = m_controller_feedback;
+  m_feedback_store.loadAll(controller_feedback.feedbacks);
+}
+
+SVHFeedbackSnapshot SVHController::getControllerFeedbackSnapshot()
+{
+  return m_feedback_store.snapshot();
+}
+
+bool SVHController::getControllerFeedbackSample(const SVHChannel& channel,
+                                                SVHFeedbackSample& sample)
+{
+  if (channel >= 0 && m_feedback_store.load(static_cast<size_t>(channel), sample))
+  {
+    return true;
+  }
+  SVH_LOG_WARN_STREAM("SVHController",
+                      "Feedback sample was requested for unknown channel: "
+                        << channel << "- ignoring request");
+  return false;
+}
+
+bool SVHController::getControllerFeedbackAge(const SVHChannel& channel,
+                                             std::chrono::nanoseconds& age)
+{
+  SVHFeedbackSample sample;
+  if (!getControllerFeedbackSample(channel, sample) || sample.sequence == 0)
+  {
+    return false;
+  }
+  age = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                             sample.timestamp);
+  return true;
+}
+
+uint64_t SVHController::getControllerFeedbackSequence(const SVHChannel& channel)
+{
+  return (channel >= 0) ? m_feedback_store.sequence(static_cast<size_t>(channel)) : 0;
+}
+
+SVHFeedbackSequences SVHController::getControllerFeedbackSequences()
+{
+  return m_feedback_store.sequences();
+}
+
+bool SVHController::controllerFeedbackChangedSince(const SVHChannel& channel, uint64_t sequence)
+{
+  return (channel >= 0) && m_feedback_store.changedSince(static_cast<size_t>(channel), sequence);
+}
+
+bool SVHController::waitForControllerFeedback(const SVHChannel& channel,
+                                              const std::chrono::microseconds& timeout)
+{
+  const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+  if (channel == SVH_ALL)
+  {
+    return m_feedback_store.waitForAll(m_feedback_store.sequences(), deadline);
+  }
+  if (channel >= 0 && channel < SVH_DIMENSION)
+  {
+    return m_feedback_store.waitForUpdate(
+      static_cast<size_t>(channel), m_feedback_store.sequence(channel), deadline);
+  }
+  SVH_LOG_WARN_STREAM("SVHController",
+                      "Wait for feedback was requested for unknown channel: "
+                        << channel << "- ignoring request");
+  return false;
+}
+
+bool SVHController::waitForControllerFeedbackAfter(const SVHChannel& channel,
+                                                   uint64_t sequence,
+                                                   const std::chrono::microseconds& timeout)
+{
+  if (channel >= 0 && channel < SVH_DIMENSION)
+  {
+    return m_feedback_store.waitForUpdate(
+      static_cast<size_t>(channel), sequence, std::chrono::steady_clock::now() + timeout);
+  }
+  SVH_LOG_WARN_STREAM("SVHController",
+                      "Wait for feedback was requested for unknown channel: "
+                        << channel << "- ignoring request");
+  return false;
+}
+
+bool SVHController::waitForControllerFeedbackAfter(const SVHFeedbackSequences& sequences,
+                                                   const std::chrono::microseconds& timeout)
+{
+  return m_feedback_store.waitForAll(sequences, std::chrono::steady_clock::now() + timeout);
 }
 
 bool SVHController::getPositionSettings(const SVHChannel& channel,
@@ -753,9 +1189,17 @@ bool SVHController::getCurrentSettings(const SVHChannel& channel,
 
 SVHFirmwareInfo SVHController::getFirmwareInfo()
 {
+  std::lock_guard<std::mutex> lock(m_firmware_info_mutex);
   return m_firmware_info;
 }
 
+bool SVHController::waitForFirmwareInfo(const std::chrono::microseconds& timeout)
+{
+  std::unique_lock<std::mutex> lock(m_firmware_info_mutex);
+  return m_firmware_info_condition.wait_for(
+    lock, timeout, [this] { return m_firmware_info_received; });
+}
+
 void SVHController::resetPackageCounts()
 {
   m_received_package_count = 0;
@@ -764,6 +1208,145 @@ void SVHController::resetPackageCounts()
   SVH_LOG_DEBUG_STREAM("SVHController", "Received package count resetted");
 }
 
+void SVHController::setTransmitWindow(unsigned int window,
+                                      const std::chrono::microseconds& acknowledge_timeout)
+{
+  m_serial_interface->setTransmitWindow(window, acknowledge_timeout);
+  SVH_LOG_DEBUG_STREAM("SVHController", "Transmit window set to " << window << " packets");
+}
+
+void SVHController::setAsynchronousTransmit(bool enable)
+{
+  m_asynchronous_transmit = enable;
+  SVH_LOG_DEBUG_STREAM("SVHController",
+                       "Packets are "
+                         << (enable ? "queued for the writer thread" : "sent directly"));
+}
+
+SVHTransmitQueueStatistics SVHController::getTransmitQueueStatistics()
+{
+  return m_serial_interface->transmitQueueStatistics();
+}
+
+void SVHController::setPriorityBudget(SVHTransmitPriority priority, double share)
+{
+  m_serial_interface->setPriorityBudget(priority, share);
+}
+
+void SVHController::setPumpMode(bool enable)
+{
+  m_serial_interface->setPumpMode(enable);
+}
+
+bool SVHController::isPumped() const
+{
+  return m_serial_interface->isPumped();
+}
+
+size_t SVHController::read()
+{
+  return m_serial_interface->read();
+}
+
+size_t SVHController::write()
+{
+  return m_serial_interface->write();
+}
+
+bool SVHController::setReactor(const std::shared_ptr<SVHReactor>& reactor)
+{
+  return m_serial_interface->setReactor(reactor);
+}
+
+bool SVHController::usesReactor() const
+{
+  return m_serial_interface->usesReactor();
+}
+
+void SVHController::transmitPacket(SVHSerialPacket& packet,
+                                   const std::chrono::microseconds& hold_off)
+{
+  SVHFixedSerialPacket fixed_packet(packet);
+  transmitPacket(fixed_packet, hold_off);
+}
+
+void SVHController::transmitPacket(SVHFixedSerialPacket& packet,
+                                   const std::chrono::microseconds& hold_off)
+{
+  // Neither the pumping thread nor a reactor handler may wait for the packet to be written
+  const bool pumped = m_serial_interface->isPumped() || m_serial_interface->inReactorThread();
+  if (m_request_tracker.isActive() && !pumped)
+  {
+    // Tracked requests are matched by their index, which is only known once they are written.
+    // Sending does not wait for the response, so the requests are still pipelined.
+    if (m_serial_interface->sendPacket(packet))
+    {
+      m_request_tracker.track(packet);
+    }
+    if (hold_off.count() > 0)
+    {
+      std::this_thread::sleep_for(hold_off);
+    }
+  }
+  else if (m_asynchronous_transmit || pumped)
+  {
+    // The writer keeps the order of all writes, only requests may be overtaken by them. It also
+    // waits the hold off time instead of the caller.
+    if (!m_serial_interface->submitPacket(packet, TransmitCallback(), hold_off))
+    {
+      SVH_LOG_WARN_STREAM("SVHController",
+                          "Packet for address " << static_cast<int>(packet.address)
+                                                << " could not be queued - dropping it");
+    }
+  }
+  else
+  {
+    m_serial_interface->sendPacket(packet);
+    if (hold_off.count() > 0)
+    {
+      std::this_thread::sleep_for(hold_off);
+    }
+  }
+}
+
+void SVHController::startRequestTracking()
+{
+  m_request_tracker.start();
+}
+
+void SVHController::stopRequestTracking()
+{
+  m_request_tracker.stop();
+}
+
+bool SVHController::waitForTrackedRequests(const std::chrono::microseconds& timeout)
+{
+  return m_request_tracker.waitForAll(timeout);
+}
+
+size_t SVHController::retransmitUnacknowledgedRequests()
+{
+  std::vector<SVHFixedSerialPacket> packets = m_request_tracker.takeUnacknowledged();
+  for (size_t i = 0; i < packets.size(); ++i)
+  {
+    SVH_LOG_DEBUG_STREAM("SVHController",
+                         "Retransmitting request for address "
+                           << static_cast<int>(packets[i].address) << " without response");
+    transmitPacket(packets[i]);
+  }
+  return packets.size();
+}
+
+size_t SVHController::getAcknowledgedRequestCount()
+{
+  return m_request_tracker.acknowledgedCount();
+}
+
+size_t SVHController::getPendingRequestCount()
+{
+  return m_request_tracker.pendingCount();
+}
+
 unsigned int SVHController::getSentPackageCount()
 {
   if (m_serial_interface != NULL)
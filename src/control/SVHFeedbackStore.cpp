@@ -0,0 +1,259 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains the sequence lock of the feedback store.
+ */
+//----------------------------------------------------------------------
+#include <schunk_svh_library/control/SVHFeedbackStore.h>
+
+#include <algorithm>
+
+namespace driver_svh {
+
+SVHFeedbackStore::SVHFeedbackStore()
+  : m_version(0)
+  , m_waiters(0)
+{
+  for (size_t i = 0; i < C_FEEDBACK_CHANNELS; ++i)
+  {
+    m_positions[i].store(0, std::memory_order_relaxed);
+    m_currents[i].store(0, std::memory_order_relaxed);
+    m_sequences[i].store(0, std::memory_order_relaxed);
+    m_timestamps[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void SVHFeedbackStore::beginWrite()
+{
+  const std::uint32_t version = m_version.load(std::memory_order_relaxed);
+  m_version.store(version + 1, std::memory_order_relaxed);
+  // Keeps the value stores below from being reordered before the odd version
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void SVHFeedbackStore::endWrite()
+{
+  m_version.store(m_version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void SVHFeedbackStore::write(size_t channel,
+                             const SVHControllerFeedback& feedback,
+                             std::int64_t timestamp)
+{
+  m_positions[channel].store(feedback.position, std::memory_order_relaxed);
+  m_currents[channel].store(feedback.current, std::memory_order_relaxed);
+  m_timestamps[channel].store(timestamp, std::memory_order_relaxed);
+  // There is only one writer, so the increment does not need to be atomic. Stored last, so a
+  // reader that sees the new sequence number also sees the values written above.
+  m_sequences[channel].store(m_sequences[channel].load(std::memory_order_relaxed) + 1,
+                             std::memory_order_release);
+}
+
+void SVHFeedbackStore::store(size_t channel,
+                             const SVHControllerFeedback& feedback,
+                             const std::chrono::steady_clock::time_point& timestamp)
+{
+  if (channel >= C_FEEDBACK_CHANNELS)
+  {
+    return;
+  }
+  beginWrite();
+  write(channel, feedback, timestamp.time_since_epoch().count());
+  endWrite();
+  notifyWaiters();
+}
+
+void SVHFeedbackStore::storeAll(const std::vector<SVHControllerFeedback>& feedbacks,
+                                const std::chrono::steady_clock::time_point& timestamp)
+{
+  const size_t channels = std::min(feedbacks.size(), C_FEEDBACK_CHANNELS);
+  beginWrite();
+  for (size_t i = 0; i < channels; ++i)
+  {
+    write(i, feedbacks[i], timestamp.time_since_epoch().count());
+  }
+  endWrite();
+  notifyWaiters();
+}
+
+void SVHFeedbackStore::notifyWaiters()
+{
+  // Pairs with the fence in waitUntil(): either the reader sees the new sequence numbers or this
+  // sees the reader, a wakeup can not get lost in between.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_waiters.load(std::memory_order_relaxed) == 0)
+  {
+    return;
+  }
+  {
+    // Taking the mutex makes sure a reader that just checked its predicate is already waiting
+    std::lock_guard<std::mutex> lock(m_wait_mutex);
+  }
+  m_wait_condition.notify_all();
+}
+
+template <typename Predicate>
+bool SVHFeedbackStore::waitUntil(const std::chrono::steady_clock::time_point& deadline,
+                                 Predicate predicate) const
+{
+  m_waiters.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  bool result;
+  {
+    std::unique_lock<std::mutex> lock(m_wait_mutex);
+    result = m_wait_condition.wait_until(lock, deadline, predicate);
+  }
+  m_waiters.fetch_sub(1, std::memory_order_relaxed);
+  return result;
+}
+
+bool SVHFeedbackStore::waitForUpdate(size_t channel,
+                                     std::uint64_t sequence,
+                                     const std::chrono::steady_clock::time_point& deadline) const
+{
+  if (channel >= C_FEEDBACK_CHANNELS)
+  {
+    return false;
+  }
+  if (changedSince(channel, sequence))
+  {
+    return true;
+  }
+  return waitUntil(deadline, [this, channel, sequence] { return changedSince(channel, sequence); });
+}
+
+bool SVHFeedbackStore::waitForAll(const SVHFeedbackSequences& sequences,
+                                  const std::chrono::steady_clock::time_point& deadline) const
+{
+  auto all_changed = [this, &sequences] {
+    for (size_t i = 0; i < C_FEEDBACK_CHANNELS; ++i)
+    {
+      if (!changedSince(i, sequences[i]))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (all_changed())
+  {
+    return true;
+  }
+  return waitUntil(deadline, all_changed);
+}
+
+bool SVHFeedbackStore::load(size_t channel, SVHControllerFeedback& feedback) const
+{
+  if (channel >= C_FEEDBACK_CHANNELS)
+  {
+    return false;
+  }
+  std::uint32_t before;
+  std::uint32_t after;
+  do
+  {
+    before            = m_version.load(std::memory_order_acquire);
+    feedback.position = m_positions[channel].load(std::memory_order_relaxed);
+    feedback.current  = m_currents[channel].load(std::memory_order_relaxed);
+    // Keeps the value loads above from being reordered after the second version load
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = m_version.load(std::memory_order_relaxed);
+  } while ((before & 1) != 0 || before != after);
+  return true;
+}
+
+bool SVHFeedbackStore::load(size_t channel, SVHFeedbackSample& sample) const
+{
+  if (channel >= C_FEEDBACK_CHANNELS)
+  {
+    return false;
+  }
+  std::uint32_t before;
+  std::uint32_t after;
+  std::int64_t timestamp;
+  do
+  {
+    before                   = m_version.load(std::memory_order_acquire);
+    sample.feedback.position = m_positions[channel].load(std::memory_order_relaxed);
+    sample.feedback.current  = m_currents[channel].load(std::memory_order_relaxed);
+    sample.sequence          = m_sequences[channel].load(std::memory_order_relaxed);
+    timestamp                = m_timestamps[channel].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = m_version.load(std::memory_order_relaxed);
+  } while ((before & 1) != 0 || before != after);
+  sample.timestamp =
+    std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(timestamp));
+  return true;
+}
+
+std::uint64_t SVHFeedbackStore::sequence(size_t channel) const
+{
+  if (channel >= C_FEEDBACK_CHANNELS)
+  {
+    return 0;
+  }
+  return m_sequences[channel].load(std::memory_order_acquire);
+}
+
+SVHFeedbackSequences SVHFeedbackStore::sequences() const
+{
+  SVHFeedbackSequences sequences;
+  for (size_t i = 0; i < C_FEEDBACK_CHANNELS; ++i)
+  {
+    sequences[i] = m_sequences[i].load(std::memory_order_acquire);
+  }
+  return sequences;
+}
+
+SVHFeedbackSnapshot SVHFeedbackStore::snapshot() const
+{
+  SVHFeedbackSnapshot feedbacks;
+  std::uint32_t before;
+  std::uint32_t after;
+  do
+  {
+    before = m_version.load(std::memory_order_acquire);
+    for (size_t i = 0; i < C_FEEDBACK_CHANNELS; ++i)
+    {
+      feedbacks[i].position = m_positions[i].load(std::memory_order_relaxed);
+      feedbacks[i].current  = m_currents[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = m_version.load(std::memory_order_relaxed);
+  } while ((before & 1) != 0 || before != after);
+  return feedbacks;
+}
+
+void SVHFeedbackStore::loadAll(std::vector<SVHControllerFeedback>& feedbacks) const
+{
+  const SVHFeedbackSnapshot current = snapshot();
+  feedbacks.assign(current.begin(), current.end());
+}
+
+} // namespace driver_svh
@@ -40,19 +40,50 @@
 #include <schunk_svh_library/Logger.h>
 #include <schunk_svh_library/control/SVHFingerManager.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <thread>
 
 
 namespace driver_svh {
 
+//! Time to wait for the answer to a command during reset before sending the next one
+const std::chrono::milliseconds C_RESET_FEEDBACK_TIMEOUT(10);
+
+//! Identifies a homing calibration file ("SVHC" in little endian)
+const uint32_t C_CALIBRATION_MAGIC = 0x43485653;
+
+//! Layout version of the homing calibration file
+const uint16_t C_CALIBRATION_FORMAT_VERSION = 2;
+
+//! Encoder ticks a finger may have moved since the calibration was saved for it to be used
+const int32_t C_CALIBRATION_POSITION_TOLERANCE = 1000;
+
+//! Time to wait for each answer that identifies the hand and its positions for a calibration
+const std::chrono::milliseconds C_CALIBRATION_ANSWER_TIMEOUT(1000);
+
+//! Rate at which trajectories are streamed by default
+const double C_TRAJECTORY_DEFAULT_RATE = 100.0;
+
+//! Rate at which the feedback of all channels is polled by default
+const double C_FEEDBACK_POLLING_DEFAULT_RATE = 10.0;
+
 SVHFingerManager::SVHFingerManager(const std::vector<bool>& disable_mask,
                                    const uint32_t& reset_timeout)
   : m_controller(new SVHController())
   , m_feedback_thread()
+  , m_feedback_period(static_cast<int64_t>(1.0e6 / C_FEEDBACK_POLLING_DEFAULT_RATE))
+  , m_adaptive_feedback(false)
+  , m_skipped_feedback_polls(0)
+  , m_poll_sequences()
+  , m_poll_sent(false)
+  , m_feedback_timer(-1)
   , m_connected(false)
   , m_connection_feedback_given(false)
   , m_homing_timeout(10)
@@ -77,6 +108,12 @@ SVHFingerManager::SVHFingerManager(const std::vector<bool>& disable_mask,
   , m_position_settings_given(SVH_DIMENSION, false)
   , m_home_settings(SVH_DIMENSION)
   , m_serial_device("/dev/ttyUSB0")
+  , m_trajectory_active(false)
+  , m_trajectory_period(static_cast<int64_t>(1.0e6 / C_TRAJECTORY_DEFAULT_RATE))
+  , m_trajectory_min(SVH_DIMENSION, 0.0)
+  , m_trajectory_max(SVH_DIMENSION, 0.0)
+  , m_trajectory_max_velocity(SVH_DIMENSION, 0.0)
+  , m_trajectory_deadline_misses(0)
 {
   // load home position default parameters
   setDefaultHomeSettings();
@@ -119,6 +156,8 @@ SVHFingerManager::SVHFingerManager(const std::vector<bool>& disable_mask,
 
 SVHFingerManager::~SVHFingerManager()
 {
+  stopTrajectory();
+
   if (m_connected)
   {
     disconnect();
@@ -131,7 +170,9 @@ SVHFingerManager::~SVHFingerManager()
   }
 }
 
-bool SVHFingerManager::connect(const std::string& dev_name, const unsigned int& retry_count)
+bool SVHFingerManager::connect(const std::string& dev_name,
+                               const unsigned int& retry_count,
+                               const SVHThreadConfig& thread_config)
 {
   SVH_LOG_DEBUG_STREAM("SVHFingerManager",
                        "Finger manager is trying to connect to the Hardware...");
@@ -145,101 +186,89 @@ bool SVHFingerManager::connect(const std::string& dev_name, const unsigned int&
     disconnect();
   }
 
+  // Process wide settings like memory locking are applied by the serial interface
+  m_thread_config = thread_config;
+  m_thread_setup.clear();
+  m_thread_setup.setStackPrefault(thread_config.stack_prefault);
+
   if (m_controller != NULL)
   {
-    if (m_controller->connect(dev_name))
+    if (m_controller->connect(dev_name, m_thread_config))
     {
-      unsigned int num_retries = retry_count;
-      do
-      {
-        // Reset the package counts (in case a previous attempt was made)
-        m_controller->resetPackageCounts();
+      // Reset the package counts (in case a previous attempt was made)
+      m_controller->resetPackageCounts();
 
-        // load default position settings before the fingers are resetted
-        std::vector<SVHPositionSettings> position_settings = getDefaultPositionSettings(true);
+      // load default position settings before the fingers are resetted
+      std::vector<SVHPositionSettings> position_settings = getDefaultPositionSettings(true);
 
-        // load default current settings
-        std::vector<SVHCurrentSettings> current_settings = getDefaultCurrentSettings();
+      // load default current settings
+      std::vector<SVHCurrentSettings> current_settings = getDefaultCurrentSettings();
 
-        m_controller->disableChannel(SVH_ALL);
+      // All requests of the handshake are written back to back and matched with their responses
+      // by index and address, so the handshake only takes as long as the hand needs to answer
+      m_controller->startRequestTracking();
 
-        // initialize all channels
-        for (size_t i = 0; i < SVH_DIMENSION; ++i)
-        {
-          // request controller feedback to have a valid starting point
-          m_controller->requestControllerFeedback(static_cast<SVHChannel>(i));
+      m_controller->disableChannel(SVH_ALL);
 
-          // Actually set the new position settings
-          m_controller->setPositionSettings(static_cast<SVHChannel>(i), position_settings[i]);
+      // initialize all channels
+      for (size_t i = 0; i < SVH_DIMENSION; ++i)
+      {
+        // request controller feedback to have a valid starting point
+        m_controller->requestControllerFeedback(static_cast<SVHChannel>(i));
 
-          // set current settings
-          m_controller->setCurrentSettings(static_cast<SVHChannel>(i), current_settings[i]);
-        }
+        // Actually set the new position settings
+        m_controller->setPositionSettings(static_cast<SVHChannel>(i), position_settings[i]);
 
-        // check for correct response from hardware controller
-        auto start_time             = std::chrono::high_resolution_clock::now();
-        bool timeout                = false;
-        unsigned int received_count = 0;
-        unsigned int send_count     = 0;
-        while (!timeout && !m_connected)
-        {
-          send_count     = m_controller->getSentPackageCount();
-          received_count = m_controller->getReceivedPackageCount();
-          if (send_count == received_count)
-          {
-            m_connected = true;
-            SVH_LOG_INFO_STREAM("SVHFingerManager",
-                                "Successfully established connection to SCHUNK five finger hand."
-                                  << "Send packages = " << send_count
-                                  << ", received packages = " << received_count);
-          }
-          SVH_LOG_DEBUG_STREAM("SVHFingerManager",
-                               "Try to connect to SCHUNK five finger hand: Send packages = "
-                                 << send_count << ", received packages = " << received_count);
+        // set current settings
+        m_controller->setCurrentSettings(static_cast<SVHChannel>(i), current_settings[i]);
+      }
 
-          // check for timeout
-          if ((std::chrono::high_resolution_clock::now() - start_time) > m_reset_timeout)
-          {
-            timeout = true;
-            SVH_LOG_ERROR_STREAM("SVHFingerManager",
-                                 "Connection timeout! Could not connect to SCHUNK five finger hand."
-                                   << "Send packages = " << send_count
-                                   << ", received packages = " << received_count);
-          }
-          std::this_thread::sleep_for(std::chrono::microseconds(50000));
+      // check for correct response from hardware controller
+      unsigned int num_retries = retry_count;
+      while (!m_connected)
+      {
+        if (m_controller->waitForTrackedRequests(m_reset_timeout))
+        {
+          m_connected = true;
+          SVH_LOG_INFO_STREAM("SVHFingerManager",
+                              "Successfully established connection to SCHUNK five finger hand."
+                                << "Send packages = " << m_controller->getSentPackageCount()
+                                << ", received packages = "
+                                << m_controller->getReceivedPackageCount());
+          break;
         }
 
+        size_t acknowledged = m_controller->getAcknowledgedRequestCount();
+        size_t pending      = m_controller->getPendingRequestCount();
+
         // Try again, but ONLY if we at least got one package back, otherwise its futil
-        if (!m_connected)
+        if (acknowledged == 0 || num_retries == 0)
         {
-          if (received_count > 0 && num_retries >= 0)
-          {
-            num_retries--;
-            SVH_LOG_ERROR_STREAM("SVHFingerManager",
-                                 "Connection Failed! Send packages = "
-                                   << send_count << ", received packages = " << received_count
-                                   << ". Retrying, count: " << num_retries);
-          }
-          else
+          SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                               "Connection timeout! Could not connect to SCHUNK five finger hand."
+                                 << "Answered requests = " << acknowledged
+                                 << ", unanswered requests = " << pending
+                                 << ". Not Retrying anymore.");
+          if (acknowledged > 0)
           {
-            num_retries = 0;
             SVH_LOG_ERROR_STREAM("SVHFingerManager",
-                                 "Connection Failed! Send packages = "
-                                   << send_count << ", received packages = " << received_count
-                                   << ". Not Retrying anymore.");
+                                 "A Stable connection could NOT be made, however some packages "
+                                 "where received. Please check the hardware!");
           }
+          break;
         }
-        // Keep trying to reconnect several times because the brainbox often makes problems
-      } while (!m_connected && num_retries > 0);
 
-
-      if (!m_connected && num_retries <= 0)
-      {
+        // Keep trying several times because the brainbox often makes problems. Only the requests
+        // that were not answered are sent again.
+        num_retries--;
+        size_t retransmitted = m_controller->retransmitUnacknowledgedRequests();
         SVH_LOG_ERROR_STREAM("SVHFingerManager",
-                             "A Stable connection could NOT be made, however some packages where "
-                             "received. Please check the hardware!");
+                             "Connection Failed! Answered requests = "
+                               << acknowledged << ", retransmitted requests = " << retransmitted
+                               << ". Retrying, count: " << num_retries);
       }
 
+      m_controller->stopRequestTracking();
 
       if (m_connected)
       {
@@ -247,13 +276,7 @@ bool SVHFingerManager::connect(const std::string& dev_name, const unsigned int&
         m_controller->requestFirmwareInfo();
 
         // initialize feedback polling thread
-        if (m_feedback_thread.joinable()) // clean reset
-        {
-          m_poll_feedback = false;
-          m_feedback_thread.join();
-        }
-        m_poll_feedback   = true;
-        m_feedback_thread = std::thread(&SVHFingerManager::pollFeedback, this);
+        startFeedbackPolling();
         SVH_LOG_DEBUG_STREAM("SVHFingerManager",
                              "Finger manager is starting the fedback polling thread");
       }
@@ -276,21 +299,30 @@ void SVHFingerManager::disconnect()
 {
   SVH_LOG_DEBUG_STREAM("SVHFingerManager",
                        "Finger manager is trying to discoconnect to the Hardware...");
+  // Nothing may be streamed to a closed device
+  stopTrajectory();
+
+  // The encoders only keep their reference while the hand stays powered. The positions at the
+  // disconnect let the next connect tell whether that was the case.
+  if (m_connected && !m_homing_calibration_cache.empty() &&
+      std::find(m_is_homed.begin(), m_is_homed.end(), false) == m_is_homed.end())
+  {
+    saveHomingCalibration(m_homing_calibration_cache);
+  }
+
   m_connected                 = false;
   m_connection_feedback_given = false;
 
   // Disable Polling
-  m_poll_feedback = false;
-  if (m_feedback_thread.joinable())
-  {
-    m_feedback_thread.join();
-    SVH_LOG_DEBUG_STREAM("SVHFingerManager", "Feedback thread terminated");
-  }
+  stopFeedbackPolling();
+  SVH_LOG_DEBUG_STREAM("SVHFingerManager", "Feedback thread terminated");
 
   // Tell the Controller to terminate the rest
   if (m_controller != NULL)
   {
     m_controller->disconnect();
+    // The next connect needs the threads again
+    m_controller->setPumpMode(false);
   }
 }
 
@@ -302,24 +334,29 @@ bool SVHFingerManager::resetChannel(const SVHChannel& channel)
     // reset all channels
     if (channel == SVH_ALL)
     {
+      if (!m_homing_calibration_cache.empty() &&
+          loadHomingCalibration(m_homing_calibration_cache))
+      {
+        return true;
+      }
+
       bool reset_all_success = true;
-      for (size_t i = 0; i < SVH_DIMENSION; ++i)
+      if (!m_reset_groups.empty())
       {
-        // try three times to reset each finger
-        size_t max_reset_counter = 3;
-        bool reset_success       = false;
-        while (!reset_success && max_reset_counter > 0)
+        reset_all_success = resetChannelGroups();
+      }
+      else
+      {
+        for (size_t i = 0; i < SVH_DIMENSION; ++i)
         {
-          SVHChannel channel = static_cast<SVHChannel>(m_reset_order[i]);
-          reset_success      = resetChannel(channel);
-          max_reset_counter--;
+          // set all reset flag
+          reset_all_success = resetChannelWithRetries(m_reset_order[i]) && reset_all_success;
         }
+      }
 
-        SVH_LOG_DEBUG_STREAM(
-          "resetChannel", "Channel " << m_reset_order[i] << " reset success = " << reset_success);
-
-        // set all reset flag
-        reset_all_success = reset_all_success && reset_success;
+      if (reset_all_success && !m_homing_calibration_cache.empty())
+      {
+        saveHomingCalibration(m_homing_calibration_cache);
       }
 
       return reset_all_success;
@@ -367,7 +404,7 @@ bool SVHFingerManager::resetChannel(const SVHChannel& channel)
                               << home.reset_current_factor * cur_set.wmn
                               << "mA MAX: " << home.reset_current_factor * cur_set.wmx << "mA");
 
-        m_controller->setControllerTarget(channel, position);
+        m_controller->setControllerTarget(channel, position, true);
         m_controller->enableChannel(channel);
 
         SVHControllerFeedback control_feedback_previous;
@@ -381,10 +418,29 @@ bool SVHFingerManager::resetChannel(const SVHChannel& channel)
 
         for (size_t hit_count = 0; hit_count < 10;)
         {
-          m_controller->setControllerTarget(channel, position);
-          // m_controller->requestControllerFeedback(channel);
+          const uint64_t sequence = m_controller->getControllerFeedbackSequence(channel);
+          m_controller->setControllerTarget(channel, position, true);
+          // The hand answers every command with its feedback. Block until it arrived instead of
+          // spinning on the same stale value.
+          const bool fresh = m_controller->waitForControllerFeedbackAfter(
+            channel, sequence, C_RESET_FEEDBACK_TIMEOUT);
+
+          // check for time out: Abort, if position does not change after homing timeout.
+          if ((std::chrono::high_resolution_clock::now() - start_time) > m_homing_timeout)
+          {
+            m_controller->disableChannel(SVH_ALL);
+            SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                                 "Timeout: Aborted finding home position for channel " << channel);
+            // Timeout could mean serious hardware issues or just plain wrong settings
+            return false;
+          }
+
+          // Without an answer only the previous sample is known, it must not be counted twice
+          if (!fresh)
+          {
+            continue;
+          }
           m_controller->getControllerFeedback(channel, control_feedback);
-          // Timeout while no encoder ticks changed
 
           // Quite extensive Current output!
           if (std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -398,45 +454,7 @@ bool SVHFingerManager::resetChannel(const SVHChannel& channel)
             start_time_log = std::chrono::high_resolution_clock::now();
           }
 
-          double threshold = 80;
-          // have a look for deadlocks
-          if (home.direction == +1)
-          {
-            double delta =
-              control_feedback.current -
-              m_diagnostic_current_maximum[channel]; // without deadlocks delta should be positiv
-            if (delta <= -threshold)
-            {
-              if (std::abs(delta) > m_diagnostic_deadlock[channel])
-              {
-                m_diagnostic_deadlock[channel] = std::abs(delta);
-              }
-            }
-          }
-          else
-          {
-            double delta = control_feedback.current - m_diagnostic_current_minimum[channel];
-            if (delta >= threshold)
-            {
-              if (std::abs(delta) > m_diagnostic_deadlock[channel])
-              {
-                m_diagnostic_deadlock[channel] = std::abs(delta);
-              }
-            }
-          }
-
-          // save the maximal/minimal current of the motor
-          if (control_feedback.current > m_diagnostic_current_maximum[channel])
-          {
-            m_diagnostic_current_maximum[channel] = control_feedback.current;
-          }
-          else
-          {
-            if (control_feedback.current < m_diagnostic_current_minimum[channel])
-            {
-              m_diagnostic_current_minimum[channel] = control_feedback.current;
-            }
-          }
+          updateResetDiagnostics(channel, home, control_feedback);
 
           if ((home.reset_current_factor * cur_set.wmn >= control_feedback.current) ||
               (control_feedback.current >= home.reset_current_factor * cur_set.wmx))
@@ -459,16 +477,6 @@ bool SVHFingerManager::resetChannel(const SVHChannel& channel)
                                    << " Hit Count Decreased: " << hit_count);
           }
 
-          // check for time out: Abort, if position does not change after homing timeout.
-          if ((std::chrono::high_resolution_clock::now() - start_time) > m_homing_timeout)
-          {
-            m_controller->disableChannel(SVH_ALL);
-            SVH_LOG_ERROR_STREAM("SVHFingerManager",
-                                 "Timeout: Aborted finding home position for channel " << channel);
-            // Timeout could mean serious hardware issues or just plain wrong settings
-            return false;
-          }
-
           // reset time if position changes
           if (control_feedback.position != control_feedback_previous.position)
           {
@@ -517,17 +525,7 @@ bool SVHFingerManager::resetChannel(const SVHChannel& channel)
 
 
         // set reference values
-        m_position_min[channel] = static_cast<int32_t>(
-          control_feedback.position + std::min(home.minimum_offset, home.maximum_offset));
-        m_position_max[channel] = static_cast<int32_t>(
-          control_feedback.position + std::max(home.minimum_offset, home.maximum_offset));
-        m_position_home[channel] =
-          static_cast<int32_t>(control_feedback.position + home.direction * home.idle_position);
-        SVH_LOG_DEBUG_STREAM("SVHFingerManager",
-                             "Setting soft stops for Channel "
-                               << channel << " min pos = " << m_position_min[channel]
-                               << " max pos = " << m_position_max[channel]
-                               << " home pos = " << m_position_home[channel]);
+        setHomeReference(channel, home, control_feedback);
 
         // position will now be reached to release the motor and go into soft stops
         position = m_position_home[channel];
@@ -537,8 +535,30 @@ bool SVHFingerManager::resetChannel(const SVHChannel& channel)
         start_time = std::chrono::high_resolution_clock::now();
         while (true)
         {
-          m_controller->setControllerTarget(channel, position);
-          // m_controller->requestControllerFeedback(channel);
+          const uint64_t sequence = m_controller->getControllerFeedbackSequence(channel);
+          m_controller->setControllerTarget(channel, position, true);
+          // The hand answers every command with its feedback. Block until it arrived instead of
+          // spinning on the same stale value.
+          const bool fresh = m_controller->waitForControllerFeedbackAfter(
+            channel, sequence, C_RESET_FEEDBACK_TIMEOUT);
+
+          // if the finger hasn't reached the home position after m_homing_timeout there is an
+          // hardware error
+          if ((std::chrono::high_resolution_clock::now() - start_time) > m_homing_timeout)
+          {
+            m_is_homed[channel] = false;
+            SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                                 "Channel " << channel << " home position is not reachable after "
+                                            << m_homing_timeout.count()
+                                            << "s! There could be an hardware error!");
+            break;
+          }
+
+          // The previous sample may still be from the way to the hard stop
+          if (!fresh)
+          {
+            continue;
+          }
           m_controller->getControllerFeedback(channel, control_feedback);
 
           SVH_LOG_DEBUG_STREAM("SVHFingerManager",
@@ -552,18 +572,6 @@ bool SVHFingerManager::resetChannel(const SVHChannel& channel)
             m_is_homed[channel] = true;
             break;
           }
-
-          // if the finger hasn't reached the home position after m_homing_timeout there is an
-          // hardware error
-          if ((std::chrono::high_resolution_clock::now() - start_time) > m_homing_timeout)
-          {
-            m_is_homed[channel] = false;
-            SVH_LOG_ERROR_STREAM("SVHFingerManager",
-                                 "Channel " << channel << " home position is not reachable after "
-                                            << m_homing_timeout.count()
-                                            << "s! There could be an hardware error!");
-            break;
-          }
         }
 
         m_controller->disableChannel(SVH_ALL);
@@ -590,21 +598,554 @@ bool SVHFingerManager::resetChannel(const SVHChannel& channel)
 
       SVH_LOG_INFO_STREAM("SVHFingerManager", "Successfully homed channel " << channel);
 
-      return true;
+      return true;
+    }
+    else
+    {
+      SVH_LOG_ERROR_STREAM("SVHFingerManager", "Channel " << channel << " is out of bounds!");
+      return false;
+    }
+  }
+  else
+  {
+    SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                         "Could not reset channel "
+                           << channel << ": No connection to SCHUNK five finger hand!");
+    return false;
+  }
+}
+
+void SVHFingerManager::updateResetDiagnostics(const SVHChannel& channel,
+                                              const SVHHomeSettings& home,
+                                              const SVHControllerFeedback& feedback)
+{
+  double threshold = 80;
+  // have a look for deadlocks
+  if (home.direction == +1)
+  {
+    double delta =
+      feedback.current -
+      m_diagnostic_current_maximum[channel]; // without deadlocks delta should be positiv
+    if (delta <= -threshold)
+    {
+      if (std::abs(delta) > m_diagnostic_deadlock[channel])
+      {
+        m_diagnostic_deadlock[channel] = std::abs(delta);
+      }
+    }
+  }
+  else
+  {
+    double delta = feedback.current - m_diagnostic_current_minimum[channel];
+    if (delta >= threshold)
+    {
+      if (std::abs(delta) > m_diagnostic_deadlock[channel])
+      {
+        m_diagnostic_deadlock[channel] = std::abs(delta);
+      }
+    }
+  }
+
+  // save the maximal/minimal current of the motor
+  if (feedback.current > m_diagnostic_current_maximum[channel])
+  {
+    m_diagnostic_current_maximum[channel] = feedback.current;
+  }
+  else
+  {
+    if (feedback.current < m_diagnostic_current_minimum[channel])
+    {
+      m_diagnostic_current_minimum[channel] = feedback.current;
+    }
+  }
+}
+
+void SVHFingerManager::setHomeReference(const SVHChannel& channel,
+                                        const SVHHomeSettings& home,
+                                        const SVHControllerFeedback& feedback)
+{
+  m_position_min[channel] =
+    static_cast<int32_t>(feedback.position + std::min(home.minimum_offset, home.maximum_offset));
+  m_position_max[channel] =
+    static_cast<int32_t>(feedback.position + std::max(home.minimum_offset, home.maximum_offset));
+  m_position_home[channel] =
+    static_cast<int32_t>(feedback.position + home.direction * home.idle_position);
+  SVH_LOG_DEBUG_STREAM("SVHFingerManager",
+                       "Setting soft stops for Channel "
+                         << channel << " min pos = " << m_position_min[channel]
+                         << " max pos = " << m_position_max[channel]
+                         << " home pos = " << m_position_home[channel]);
+}
+
+bool SVHFingerManager::setResetGroups(const std::vector<std::vector<SVHChannel> >& groups)
+{
+  std::vector<bool> listed(SVH_DIMENSION, false);
+  for (size_t g = 0; g < groups.size(); ++g)
+  {
+    for (size_t i = 0; i < groups[g].size(); ++i)
+    {
+      const SVHChannel channel = groups[g][i];
+      if (channel < 0 || channel >= SVH_DIMENSION || listed[channel])
+      {
+        SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                             "Reset groups rejected: channel "
+                               << channel << " is unknown or part of more than one group");
+        return false;
+      }
+      listed[channel] = true;
+    }
+  }
+
+  m_reset_groups = groups;
+  SVH_LOG_DEBUG_STREAM("SVHFingerManager",
+                       "Homing " << groups.size() << " groups of channels concurrently");
+  return true;
+}
+
+bool SVHFingerManager::resetChannelWithRetries(const SVHChannel& channel)
+{
+  // try three times to reset each finger
+  size_t max_reset_counter = 3;
+  bool reset_success       = false;
+  while (!reset_success && max_reset_counter > 0)
+  {
+    reset_success = resetChannel(channel);
+    max_reset_counter--;
+  }
+
+  SVH_LOG_DEBUG_STREAM("resetChannel",
+                       "Channel " << channel << " reset success = " << reset_success);
+  return reset_success;
+}
+
+bool SVHFingerManager::resetChannelGroups()
+{
+  bool reset_all_success = true;
+  std::vector<bool> grouped(SVH_DIMENSION, false);
+
+  for (size_t g = 0; g < m_reset_groups.size(); ++g)
+  {
+    // try three times to reset each finger, only the failed ones of a group are repeated
+    std::vector<SVHChannel> channels = m_reset_groups[g];
+    for (size_t attempt = 0; attempt < 3 && !channels.empty(); ++attempt)
+    {
+      std::vector<SVHChannel> failed;
+      resetChannelGroup(channels, failed);
+      channels.swap(failed);
+    }
+
+    for (size_t i = 0; i < m_reset_groups[g].size(); ++i)
+    {
+      grouped[m_reset_groups[g][i]] = true;
+    }
+    SVH_LOG_DEBUG_STREAM("resetChannel", "Reset group " << g << " success = " << channels.empty());
+    reset_all_success = reset_all_success && channels.empty();
+  }
+
+  // Channels that are not part of any group are homed afterwards one by one
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    if (!grouped[m_reset_order[i]])
+    {
+      reset_all_success = resetChannelWithRetries(m_reset_order[i]) && reset_all_success;
+    }
+  }
+
+  return reset_all_success;
+}
+
+bool SVHFingerManager::resetChannelGroup(const std::vector<SVHChannel>& channels,
+                                         std::vector<SVHChannel>& failed)
+{
+  //! Progress of one channel of the group
+  enum HomingPhase
+  {
+    HP_HARD_STOP, // driving towards the hard stop and counting current hits
+    HP_IDLE,      // driving back to the idle position
+    HP_DONE,
+    HP_FAILED
+  };
+
+  struct HomingState
+  {
+    SVHChannel channel;
+    SVHHomeSettings home;
+    SVHCurrentSettings current_settings;
+    HomingPhase phase;
+    size_t hit_count;
+    SVHControllerFeedback previous_feedback;
+    std::chrono::steady_clock::time_point start_time;
+  };
+
+  failed.clear();
+
+  // Channels that are not part of the group keep their current position as target
+  const SVHFeedbackSnapshot initial_feedback = m_controller->getControllerFeedbackSnapshot();
+  std::vector<int32_t> targets(SVH_DIMENSION);
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    targets[i] = initial_feedback[i].position;
+  }
+
+  std::vector<HomingState> states;
+  for (size_t i = 0; i < channels.size(); ++i)
+  {
+    const SVHChannel channel            = channels[i];
+    m_diagnostic_encoder_state[channel] = false;
+    m_diagnostic_current_state[channel] = false;
+
+    if (m_is_switched_off[channel])
+    {
+      SVH_LOG_INFO_STREAM("SVHFingerManager",
+                          "Channel " << channel
+                                     << "switched of by user, homing is set to finished");
+      m_is_homed[channel] = true;
+      continue;
+    }
+
+    SVH_LOG_DEBUG_STREAM("SVHFingerManager", "Start homing channel " << channel);
+    m_controller->setPositionSettings(channel, getDefaultPositionSettings(true)[channel]);
+    m_is_homed[channel] = false;
+
+    HomingState state;
+    state.channel   = channel;
+    state.home      = m_home_settings[channel];
+    state.phase     = HP_HARD_STOP;
+    state.hit_count = 0;
+    SVHPositionSettings position_settings;
+    m_controller->getPositionSettings(channel, position_settings);
+    m_controller->getCurrentSettings(channel, state.current_settings);
+    state.previous_feedback = initial_feedback[channel];
+    targets[channel]        = static_cast<int32_t>(
+      state.home.direction > 0 ? position_settings.wmx : position_settings.wmn);
+    states.push_back(state);
+  }
+
+  if (states.empty())
+  {
+    return true;
+  }
+
+  m_controller->setControllerTargetAllChannels(targets, true);
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < states.size(); ++i)
+  {
+    m_controller->enableChannel(states[i].channel);
+    states[i].start_time = now;
+  }
+
+  size_t active = states.size();
+  while (active > 0)
+  {
+    // The hand answers the command for all channels with the feedback of all channels, every
+    // channel of the group is evaluated on that one shared answer
+    const SVHFeedbackSequences sequences = m_controller->getControllerFeedbackSequences();
+    m_controller->setControllerTargetAllChannels(targets, true);
+    const bool fresh =
+      m_controller->waitForControllerFeedbackAfter(sequences, C_RESET_FEEDBACK_TIMEOUT);
+    const SVHFeedbackSnapshot feedback = m_controller->getControllerFeedbackSnapshot();
+
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+      HomingState& state                            = states[i];
+      const SVHChannel channel                      = state.channel;
+      const SVHControllerFeedback& control_feedback = feedback[channel];
+
+      if (state.phase == HP_HARD_STOP)
+      {
+        // Without an answer only the timeout is checked, old samples must not be counted twice
+        if (fresh)
+        {
+          updateResetDiagnostics(channel, state.home, control_feedback);
+
+          if ((state.home.reset_current_factor * state.current_settings.wmn >=
+               control_feedback.current) ||
+              (control_feedback.current >=
+               state.home.reset_current_factor * state.current_settings.wmx))
+          {
+            // when in maximum the current controller is ok
+            m_diagnostic_current_state[channel] = true;
+            state.hit_count++;
+          }
+          else if (state.hit_count > 0)
+          {
+            state.hit_count--;
+          }
+
+          // reset time if position changes
+          if (control_feedback.position != state.previous_feedback.position)
+          {
+            m_diagnostic_encoder_state[channel] = true;
+            // save the maximal/minimal position the channel can reach
+            if (control_feedback.position > m_diagnostic_position_maximum[channel])
+              m_diagnostic_position_maximum[channel] = control_feedback.position;
+            else if (control_feedback.position < m_diagnostic_position_minimum[channel])
+              m_diagnostic_position_minimum[channel] = control_feedback.position;
+
+            state.start_time = std::chrono::steady_clock::now();
+          }
+          state.previous_feedback = control_feedback;
+        }
+
+        if (state.hit_count >= 10)
+        {
+          SVH_LOG_INFO_STREAM("SVHFingerManager",
+                              "Resetting Channel "
+                                << channel << ":" << m_controller->m_channel_description[channel]
+                                << " current: " << control_feedback.current << " mA");
+          setHomeReference(channel, state.home, control_feedback);
+
+          // position will now be reached to release the motor and go into soft stops
+          targets[channel] = m_position_home[channel];
+          state.phase      = HP_IDLE;
+          state.start_time = std::chrono::steady_clock::now();
+        }
+        else if ((std::chrono::steady_clock::now() - state.start_time) > m_homing_timeout)
+        {
+          // Timeout could mean serious hardware issues or just plain wrong settings. The other
+          // channels of the group are not affected.
+          SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                               "Timeout: Aborted finding home position for channel " << channel);
+          m_controller->disableChannel(channel);
+          targets[channel] = control_feedback.position;
+          state.phase      = HP_FAILED;
+          failed.push_back(channel);
+          active--;
+        }
+      }
+      else if (state.phase == HP_IDLE)
+      {
+        if (fresh && abs(targets[channel] - control_feedback.position) < 1000)
+        {
+          m_is_homed[channel] = true;
+          state.phase         = HP_DONE;
+          active--;
+          SVH_LOG_INFO_STREAM("SVHFingerManager", "Successfully homed channel " << channel);
+        }
+        else if ((std::chrono::steady_clock::now() - state.start_time) > m_homing_timeout)
+        {
+          // if the finger hasn't reached the home position after m_homing_timeout there is an
+          // hardware error
+          SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                               "Channel " << channel << " home position is not reachable after "
+                                          << m_homing_timeout.count()
+                                          << "s! There could be an hardware error!");
+          state.phase = HP_DONE;
+          active--;
+        }
+      }
+    }
+  }
+
+  m_controller->disableChannel(SVH_ALL);
+  for (size_t i = 0; i < states.size(); ++i)
+  {
+    SVH_LOG_DEBUG_STREAM("SVHFingerManager",
+                         "Restoring default position values for controller of channel "
+                           << states[i].channel);
+    m_controller->setPositionSettings(states[i].channel,
+                                      getDefaultPositionSettings(false)[states[i].channel]);
+  }
+
+  return failed.empty();
+}
+
+bool SVHFingerManager::saveHomingCalibration(const std::string& file_name)
+{
+  if (m_controller->isPumped())
+  {
+    SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                         "Could not save homing calibration: The current positions are not "
+                         "requested in pump mode!");
+    return false;
+  }
+
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    if (!m_is_homed[i])
+    {
+      SVH_LOG_WARN_STREAM("SVHFingerManager",
+                          "Homing calibration not saved, channel " << i << " is not homed");
+      return false;
+    }
+  }
+
+  const SVHFirmwareInfo firmware = m_controller->getFirmwareInfo();
+  if (firmware.version_major == 0 && firmware.version_minor == 0)
+  {
+    SVH_LOG_WARN_STREAM("SVHFingerManager",
+                        "Homing calibration not saved, the firmware of the hand is unknown");
+    return false;
+  }
+  SVHFeedbackSnapshot feedback;
+  if (!requestFeedbackSnapshot(feedback))
+  {
+    SVH_LOG_WARN_STREAM("SVHFingerManager",
+                        "Homing calibration not saved, the positions of the fingers are unknown");
+    return false;
+  }
+  std::vector<uint8_t> device(m_serial_device.begin(), m_serial_device.end());
+  std::vector<uint8_t> svh(4, 0);
+  const size_t svh_size = std::min<size_t>(firmware.svh.size(), svh.size());
+  std::copy(firmware.svh.begin(), firmware.svh.begin() + svh_size, svh.begin());
+
+  ArrayBuilder ab(0);
+  ab << C_CALIBRATION_MAGIC << C_CALIBRATION_FORMAT_VERSION << static_cast<uint16_t>(device.size());
+  ab.appendWithoutConversion(device);
+  ab.appendWithoutConversion(svh);
+  ab << firmware.version_major << firmware.version_minor;
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    ab << m_position_min[i] << m_position_max[i] << m_position_home[i] << feedback[i].position;
+  }
+
+  std::ofstream file(file_name.c_str(), std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(ab.array.data()), ab.array.size());
+  if (!file)
+  {
+    SVH_LOG_ERROR_STREAM("SVHFingerManager", "Could not write homing calibration to " << file_name);
+    return false;
+  }
+
+  SVH_LOG_INFO_STREAM("SVHFingerManager", "Saved homing calibration to " << file_name);
+  return true;
+}
+
+bool SVHFingerManager::loadHomingCalibration(const std::string& file_name)
+{
+  if (!m_connected)
+  {
+    SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                         "Could not load homing calibration: No connection to SCHUNK five finger "
+                         "hand!");
+    return false;
+  }
+  if (m_controller->isPumped())
+  {
+    // Nobody reads the answers to the requests below while this call blocks the pumping loop
+    SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                         "Could not load homing calibration: The hand can not be identified in "
+                         "pump mode!");
+    return false;
+  }
+
+  std::ifstream file(file_name.c_str(), std::ios::binary);
+  if (!file)
+  {
+    SVH_LOG_DEBUG_STREAM("SVHFingerManager", "No homing calibration found at " << file_name);
+    return false;
+  }
+  ArrayBuilder ab(0);
+  ab.array.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+  // Fixed part: magic, format version and device name length
+  const size_t header_size = sizeof(uint32_t) + 2 * sizeof(uint16_t);
+  uint32_t magic           = 0;
+  uint16_t format_version  = 0;
+  uint16_t device_size     = 0;
+  ab >> magic >> format_version >> device_size;
+  const size_t expected_size = header_size + device_size + 4 + 2 * sizeof(uint16_t) +
+                               SVH_DIMENSION * 4 * sizeof(int32_t);
+  if (magic != C_CALIBRATION_MAGIC || format_version != C_CALIBRATION_FORMAT_VERSION ||
+      ab.array.size() != expected_size)
+  {
+    SVH_LOG_WARN_STREAM("SVHFingerManager",
+                        "Homing calibration " << file_name << " is invalid, homing is required");
+    return false;
+  }
+
+  std::vector<uint8_t> device(device_size);
+  std::vector<uint8_t> svh(4);
+  SVHFirmwareInfo cached_firmware;
+  ab >> device >> svh >> cached_firmware.version_major >> cached_firmware.version_minor;
+  std::vector<int32_t> position_min(SVH_DIMENSION);
+  std::vector<int32_t> position_max(SVH_DIMENSION);
+  std::vector<int32_t> position_home(SVH_DIMENSION);
+  std::vector<int32_t> position_last(SVH_DIMENSION);
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    ab >> position_min[i] >> position_max[i] >> position_home[i] >> position_last[i];
+  }
+
+  // The calibration is only valid for the same hand, identified by its device and firmware
+  if (!m_controller->waitForFirmwareInfo(std::chrono::microseconds(0)))
+  {
+    m_controller->requestFirmwareInfo();
+    if (!m_controller->waitForFirmwareInfo(C_CALIBRATION_ANSWER_TIMEOUT))
+    {
+      SVH_LOG_WARN_STREAM("SVHFingerManager",
+                          "No firmware info to verify the homing calibration, homing is required");
+      return false;
+    }
+  }
+  const SVHFirmwareInfo firmware = m_controller->getFirmwareInfo();
+  if (std::string(device.begin(), device.end()) != m_serial_device ||
+      firmware.svh.compare(0, 4, std::string(svh.begin(), svh.end())) != 0 ||
+      !(firmware == cached_firmware))
+  {
+    SVH_LOG_INFO_STREAM("SVHFingerManager",
+                        "Homing calibration " << file_name
+                                              << " belongs to another device or firmware");
+    return false;
+  }
+
+  // After a power cycle of the hand the encoders restart at zero. Zero usually lies within the
+  // soft limits, so only the positions at the time of saving prove that the reference is intact.
+  SVHFeedbackSnapshot feedback;
+  if (!requestFeedbackSnapshot(feedback))
+  {
+    SVH_LOG_WARN_STREAM("SVHFingerManager",
+                        "No feedback to verify the homing calibration, homing is required");
+    return false;
+  }
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    if (m_is_switched_off[i])
+    {
+      continue;
     }
-    else
+    const int64_t moved = static_cast<int64_t>(feedback[i].position) - position_last[i];
+    if (std::abs(moved) > C_CALIBRATION_POSITION_TOLERANCE)
     {
-      SVH_LOG_ERROR_STREAM("SVHFingerManager", "Channel " << channel << " is out of bounds!");
+      SVH_LOG_INFO_STREAM("SVHFingerManager",
+                          "Homing calibration is outdated, channel "
+                            << i << " is at " << feedback[i].position << " instead of "
+                            << position_last[i]);
       return false;
     }
   }
-  else
+
+  const std::vector<SVHPositionSettings> position_settings = getDefaultPositionSettings(false);
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    m_position_min[i]  = position_min[i];
+    m_position_max[i]  = position_max[i];
+    m_position_home[i] = position_home[i];
+    m_is_homed[i]      = true;
+    // The settings with reduced speed from connect() are replaced as after a regular reset
+    m_controller->setPositionSettings(static_cast<SVHChannel>(i), position_settings[i]);
+  }
+
+  SVH_LOG_INFO_STREAM("SVHFingerManager",
+                      "Loaded homing calibration from " << file_name << ", homing skipped");
+  return true;
+}
+
+bool SVHFingerManager::requestFeedbackSnapshot(SVHFeedbackSnapshot& feedback)
+{
+  const SVHFeedbackSequences sequences = m_controller->getControllerFeedbackSequences();
+  m_controller->requestControllerFeedback(SVH_ALL);
+  if (!m_controller->waitForControllerFeedbackAfter(sequences, C_CALIBRATION_ANSWER_TIMEOUT))
   {
-    SVH_LOG_ERROR_STREAM("SVHFingerManager",
-                         "Could not reset channel "
-                           << channel << ": No connection to SCHUNK five finger hand!");
     return false;
   }
+  feedback = m_controller->getControllerFeedbackSnapshot();
+  return true;
+}
+
+void SVHFingerManager::setHomingCalibrationCache(const std::string& file_name)
+{
+  m_homing_calibration_cache = file_name;
 }
 
 bool SVHFingerManager::getDiagnosticStatus(const SVHChannel& channel,
@@ -673,10 +1214,16 @@ void SVHFingerManager::disableChannel(const SVHChannel& channel)
 {
   if (channel == SVH_ALL)
   {
-    for (size_t i = 0; i < SVH_DIMENSION; ++i)
+    // A running trajectory must not send another target after the emergency frame. Ending it
+    // waits for a target that is being sent right now.
     {
-      disableChannel(static_cast<SVHChannel>(i));
+      std::lock_guard<std::mutex> lock(m_trajectory_mutex);
+      m_trajectory_active = false;
+      m_trajectory_condition.notify_all();
     }
+    // A single emergency frame that overtakes everything queued instead of one frame per channel
+    m_controller->disableChannel(SVH_ALL);
+    stopTrajectory();
   }
   else
   {
@@ -834,6 +1381,254 @@ bool SVHFingerManager::setAllTargetPositions(const std::vector<double>& position
   }
 }
 
+void SVHFingerManager::setCommandCoalescing(const std::chrono::microseconds& window)
+{
+  m_controller->setCommandCoalescing(window);
+}
+
+void SVHFingerManager::beginCommandBatch()
+{
+  m_controller->beginCommandBatch();
+}
+
+void SVHFingerManager::commitCommandBatch()
+{
+  m_controller->commitCommandBatch();
+}
+
+void SVHFingerManager::setCommandDeadband(int32_t tolerance,
+                                          const std::chrono::milliseconds& keepalive)
+{
+  m_controller->setCommandDeadband(tolerance, keepalive);
+}
+
+uint64_t SVHFingerManager::getSuppressedCommandCount(const SVHChannel& channel)
+{
+  return m_controller->getSuppressedCommandCount(channel);
+}
+
+std::chrono::microseconds SVHFingerManager::getEmergencyStopLatency()
+{
+  return m_controller->getEmergencyStopLatency();
+}
+
+bool SVHFingerManager::executeTrajectory(const std::vector<SVHTrajectoryWaypoint>& waypoints,
+                                         SVHInterpolation interpolation)
+{
+  if (!isConnected())
+  {
+    SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                         "Could not execute trajectory: No connection to SCHUNK five finger hand!");
+    return false;
+  }
+
+  stopTrajectory();
+
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    if (!m_is_switched_off[i] && !isHomed(static_cast<SVHChannel>(i)))
+    {
+      SVH_LOG_WARN_STREAM("SVHFingerManager",
+                          "Could not execute trajectory: Channel "
+                            << i << " : " << SVHController::m_channel_description[i]
+                            << " is not homed");
+      return false;
+    }
+  }
+
+  // The trajectory is interpolated in ticks, so it can be sent without further conversion
+  std::vector<SVHTrajectoryWaypoint> waypoints_ticks;
+  waypoints_ticks.reserve(waypoints.size() + 1);
+  if (waypoints.empty() || waypoints.front().time.count() > 0)
+  {
+    SVHTrajectoryWaypoint start;
+    for (size_t i = 0; i < SVH_DIMENSION; ++i)
+    {
+      SVHControllerFeedback feedback;
+      m_controller->getControllerFeedback(static_cast<SVHChannel>(i), feedback);
+      start.positions[i] = feedback.position;
+    }
+    waypoints_ticks.push_back(start);
+  }
+
+  for (size_t w = 0; w < waypoints.size(); ++w)
+  {
+    if (waypoints[w].positions.size() != SVH_DIMENSION)
+    {
+      SVH_LOG_WARN_STREAM("SVHFingerManager",
+                          "Could not execute trajectory: Waypoint "
+                            << w << " has " << waypoints[w].positions.size()
+                            << " positions, expected " << (int)SVH_DIMENSION);
+      return false;
+    }
+
+    SVHTrajectoryWaypoint waypoint(waypoints[w].time, waypoints[w].positions);
+    for (size_t i = 0; i < SVH_DIMENSION; ++i)
+    {
+      SVHChannel channel = static_cast<SVHChannel>(i);
+      int32_t ticks      = convertRad2Ticks(channel, waypoints[w].positions[i]);
+      if (!isInsideBounds(channel, ticks))
+      {
+        SVH_LOG_WARN_STREAM("SVHFingerManager",
+                            "Could not execute trajectory: Waypoint " << w << " is out of bounds!");
+        return false;
+      }
+      waypoint.positions[i] = ticks;
+    }
+    waypoints_ticks.push_back(waypoint);
+  }
+
+  if (!m_trajectory.setWaypoints(waypoints_ticks, interpolation))
+  {
+    SVH_LOG_WARN_STREAM("SVHFingerManager",
+                        "Could not execute trajectory: Waypoints have to be strictly increasing "
+                        "in time");
+    return false;
+  }
+
+  // Limits of the position controllers as they are currently active on the hand
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    SVHChannel channel = static_cast<SVHChannel>(i);
+    SVHPositionSettings position_settings;
+    m_controller->getPositionSettings(channel, position_settings);
+
+    m_trajectory_min[i] = m_position_min[i];
+    m_trajectory_max[i] = m_position_max[i];
+    if (position_settings.wmn < position_settings.wmx)
+    {
+      m_trajectory_min[i] = std::max<double>(m_trajectory_min[i], position_settings.wmn);
+      m_trajectory_max[i] = std::min<double>(m_trajectory_max[i], position_settings.wmx);
+    }
+    m_trajectory_max_velocity[i] = std::max(0.0, static_cast<double>(position_settings.dwmx));
+
+    // enable all homed and disabled channels.. except its switched of
+    if (!m_is_switched_off[channel] && !isEnabled(channel))
+    {
+      enableChannel(channel);
+    }
+  }
+
+  SVH_LOG_DEBUG_STREAM("SVHFingerManager",
+                       "Executing trajectory of " << waypoints_ticks.size() << " waypoints over "
+                                                  << m_trajectory.duration().count() << " us");
+
+  m_trajectory_deadline_misses = 0;
+  m_trajectory_active          = true;
+  m_trajectory_thread          =
+    m_thread_setup.start(m_thread_config.trajectory, [this] { streamTrajectory(); });
+  return true;
+}
+
+void SVHFingerManager::stopTrajectory()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_trajectory_mutex);
+    m_trajectory_active = false;
+    m_trajectory_condition.notify_all();
+  }
+  if (m_trajectory_thread.joinable() && m_trajectory_thread.get_id() != std::this_thread::get_id())
+  {
+    m_trajectory_thread.join();
+  }
+}
+
+bool SVHFingerManager::waitForTrajectory(const std::chrono::milliseconds& timeout)
+{
+  std::unique_lock<std::mutex> lock(m_trajectory_mutex);
+  return m_trajectory_condition.wait_for(lock, timeout, [this] { return !m_trajectory_active; });
+}
+
+bool SVHFingerManager::setTrajectoryRate(double rate)
+{
+  if (rate > 0.0 && rate <= C_TRAJECTORY_MAX_RATE)
+  {
+    m_trajectory_period = std::chrono::microseconds(static_cast<int64_t>(1.0e6 / rate));
+    return true;
+  }
+  SVH_LOG_WARN_STREAM("SVHFingerManager",
+                      "Trajectory rate " << rate << " Hz is not within (0, "
+                                         << C_TRAJECTORY_MAX_RATE << "] Hz - ignoring request");
+  return false;
+}
+
+void SVHFingerManager::streamTrajectory()
+{
+  const std::chrono::microseconds period   = m_trajectory_period;
+  const std::chrono::microseconds duration = m_trajectory.duration();
+  const double period_seconds              = std::chrono::duration<double>(period).count();
+
+  std::vector<double> samples(SVH_DIMENSION, 0.0);
+  std::vector<double> commanded(SVH_DIMENSION, 0.0);
+  std::vector<int32_t> targets(SVH_DIMENSION, 0);
+  m_trajectory.sample(std::chrono::microseconds(0), commanded);
+
+  // All deadlines are derived from the start time, so the stream does not drift with the time
+  // that sending and scheduling take
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  uint64_t cycle                                    = 0;
+  uint64_t last_cycle                               = 0;
+
+  std::unique_lock<std::mutex> lock(m_trajectory_mutex);
+  while (m_trajectory_active)
+  {
+    const std::chrono::microseconds elapsed = period * static_cast<int64_t>(cycle);
+    if (m_trajectory_condition.wait_until(
+          lock, start + elapsed, [this] { return !m_trajectory_active; }))
+    {
+      break;
+    }
+    lock.unlock();
+
+    // Sample on the nominal time grid and keep every channel within its limits
+    m_trajectory.sample(elapsed, samples);
+    const double max_step = period_seconds * static_cast<double>(cycle - last_cycle);
+    bool reached          = true;
+    for (size_t i = 0; i < SVH_DIMENSION; ++i)
+    {
+      const double limited =
+        std::min(std::max(samples[i], m_trajectory_min[i]), m_trajectory_max[i]);
+      double target = limited;
+      if (m_trajectory_max_velocity[i] > 0.0 && cycle > 0)
+      {
+        const double step = m_trajectory_max_velocity[i] * max_step;
+        target            = std::min(std::max(target, commanded[i] - step), commanded[i] + step);
+      }
+      // A channel that is held back by its velocity limit has not reached the trajectory yet
+      reached      = reached && std::abs(target - limited) < 0.5;
+      commanded[i] = target;
+      targets[i]   = static_cast<int32_t>(std::lround(target));
+    }
+
+    // Sent under the lock, so that no target follows once the trajectory was ended
+    lock.lock();
+    if (!m_trajectory_active)
+    {
+      break;
+    }
+    m_controller->setControllerTargetAllChannels(targets);
+    last_cycle = cycle;
+    if (elapsed >= duration && reached)
+    {
+      break;
+    }
+
+    // Cycles whose deadline already passed are skipped instead of being sent in a burst
+    ++cycle;
+    const std::chrono::steady_clock::duration late =
+      std::chrono::steady_clock::now() - (start + period * static_cast<int64_t>(cycle));
+    if (late > period)
+    {
+      const uint64_t missed = static_cast<uint64_t>(late / period);
+      cycle += missed;
+      m_trajectory_deadline_misses += missed;
+    }
+  }
+
+  m_trajectory_active = false;
+  m_trajectory_condition.notify_all();
+}
+
 bool SVHFingerManager::setTargetPosition(const SVHChannel& channel, double position, double current)
 {
   if (isConnected())
@@ -1523,6 +2318,12 @@ void SVHFingerManager::setResetTimeout(const int& reset_timeout)
     (reset_timeout > 0) ? std::chrono::seconds(reset_timeout) : std::chrono::seconds(0);
 }
 
+void SVHFingerManager::setHomingTimeout(const int& homing_timeout)
+{
+  m_homing_timeout =
+    (homing_timeout > 1) ? std::chrono::seconds(homing_timeout) : std::chrono::seconds(1);
+}
+
 bool SVHFingerManager::setMaxForce(float max_force)
 {
   if (max_force > 0 && max_force <= 1)
@@ -1573,7 +2374,7 @@ SVHFirmwareInfo SVHFingerManager::getFirmwareInfo(const std::string& dev_name,
     if (!m_connected)
     {
       was_connected = false;
-      if (!m_controller->connect(dev_name))
+      if (!m_controller->connect(dev_name, m_thread_config))
       {
         SVH_LOG_ERROR_STREAM("SVHFingerManager", "Connection FAILED! Device could NOT be opened");
         m_firmware_info.version_major = 0;
@@ -1584,11 +2385,7 @@ SVHFirmwareInfo SVHFingerManager::getFirmwareInfo(const std::string& dev_name,
 
     // As the firmware info takes longer we need to disable the polling during the request of the
     // firmware information
-    m_poll_feedback = false;
-    if (m_feedback_thread.joinable())
-    {
-      m_feedback_thread.join();
-    }
+    stopFeedbackPolling();
 
     unsigned int num_retries = retry_count;
     do
@@ -1610,8 +2407,7 @@ SVHFirmwareInfo SVHFingerManager::getFirmwareInfo(const std::string& dev_name,
              m_firmware_info.version_major == 0);
 
     // Start the feedback process aggain
-    m_poll_feedback   = true;
-    m_feedback_thread = std::thread(&SVHFingerManager::pollFeedback, this);
+    startFeedbackPolling();
 
     if (!was_connected)
     {
@@ -1626,18 +2422,222 @@ SVHFirmwareInfo SVHFingerManager::getFirmwareInfo(const std::string& dev_name,
 
 void SVHFingerManager::pollFeedback()
 {
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(m_feedback_mutex);
   while (m_poll_feedback)
   {
+    lock.unlock();
+    const std::chrono::microseconds period(m_feedback_period);
     if (isConnected())
     {
-      requestControllerFeedback(SVH_ALL);
+      requestFeedbackPoll(period);
     }
     else
     {
       SVH_LOG_WARN_STREAM("SVHFeedbackPollingThread", "SCHUNK five finger hand is not connected!");
     }
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // Absolute deadlines keep the time spent sending from adding up. Polls that are overdue are
+    // not sent in a burst, the grid starts over instead.
+    deadline += period;
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (deadline < now)
+    {
+      deadline = now;
+    }
+
+    lock.lock();
+    m_feedback_condition.wait_until(lock, deadline, [this] { return !m_poll_feedback; });
+  }
+}
+
+void SVHFingerManager::requestFeedbackPoll(const std::chrono::microseconds& period)
+{
+  const SVHFeedbackSequences sequences = m_controller->getControllerFeedbackSequences();
+  if (m_adaptive_feedback && isFeedbackFresh(period, sequences))
+  {
+    // The replies to the streamed targets already carry the feedback
+    m_skipped_feedback_polls++;
+    m_poll_sent = false;
+  }
+  else
+  {
+    requestControllerFeedback(SVH_ALL);
+    m_poll_sent = true;
+  }
+  m_poll_sequences = sequences;
+}
+
+std::vector<SVHThreadSetupFailure> SVHFingerManager::getThreadSetupFailures() const
+{
+  std::vector<SVHThreadSetupFailure> failures = m_controller->getThreadSetupFailures();
+  std::vector<SVHThreadSetupFailure> own      = m_thread_setup.failures();
+  failures.insert(failures.end(), own.begin(), own.end());
+  return failures;
+}
+
+bool SVHFingerManager::setReactor(const std::shared_ptr<SVHReactor>& reactor)
+{
+  if (!m_controller->setReactor(reactor))
+  {
+    return false;
+  }
+  m_reactor = reactor;
+  return true;
+}
+
+bool SVHFingerManager::setPumpMode(bool enable)
+{
+  if (enable)
+  {
+    if (!isConnected())
+    {
+      SVH_LOG_ERROR_STREAM("SVHFingerManager",
+                           "Pump mode can only be entered with a connected hand.");
+      return false;
+    }
+    stopFeedbackPolling();
+    m_controller->setPumpMode(true);
+    m_pump_next_poll = std::chrono::steady_clock::now();
+  }
+  else if (m_controller->isPumped())
+  {
+    m_controller->setPumpMode(false);
+    if (isConnected())
+    {
+      startFeedbackPolling();
+    }
+  }
+  return true;
+}
+
+size_t SVHFingerManager::read()
+{
+  return m_controller->read();
+}
+
+size_t SVHFingerManager::write()
+{
+  if (!m_controller->isPumped())
+  {
+    return 0;
+  }
+
+  // Same absolute deadline grid as the feedback thread
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  if (now >= m_pump_next_poll)
+  {
+    const std::chrono::microseconds period(m_feedback_period);
+    requestFeedbackPoll(period);
+    m_pump_next_poll += period;
+    if (m_pump_next_poll < now)
+    {
+      m_pump_next_poll = now;
+    }
+  }
+  return m_controller->write();
+}
+
+void SVHFingerManager::startFeedbackPolling()
+{
+  // clean reset
+  stopFeedbackPolling();
+
+  if (m_reactor && m_controller->usesReactor())
+  {
+    if (startReactorFeedbackPolling())
+    {
+      return;
+    }
+    SVH_LOG_WARN_STREAM("SVHFingerManager",
+                        "Could not poll feedback with the reactor, starting feedback thread.");
+  }
+
+  m_poll_feedback   = true;
+  m_feedback_thread = m_thread_setup.start(m_thread_config.feedback, [this] { pollFeedback(); });
+}
+
+bool SVHFingerManager::startReactorFeedbackPolling()
+{
+  // Hands polling at the same rate share the timer of the reactor. The kernel keeps it on its
+  // grid and overdue expirations are merged into one poll.
+  const std::chrono::microseconds period(m_feedback_period);
+  const int timer = m_reactor->addPeriodic(period, [this, period] {
+    if (isConnected())
+    {
+      requestFeedbackPoll(period);
+    }
+  });
+  m_feedback_timer = timer;
+  return timer >= 0;
+}
+
+void SVHFingerManager::stopFeedbackPolling()
+{
+  const int timer = m_feedback_timer.exchange(-1);
+  if (timer >= 0)
+  {
+    m_reactor->remove(timer);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_feedback_mutex);
+    m_poll_feedback = false;
+    m_feedback_condition.notify_all();
+  }
+  if (m_feedback_thread.joinable())
+  {
+    m_feedback_thread.join();
+  }
+}
+
+bool SVHFingerManager::isFeedbackFresh(const std::chrono::microseconds& max_age,
+                                       const SVHFeedbackSequences& sequences)
+{
+  // The reply to the last own poll says nothing about other traffic. Counting it would make every
+  // poll skip the next one and an idle hand would only be polled every other period.
+  const uint64_t own_replies = m_poll_sent ? 1 : 0;
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    if (m_is_switched_off[i])
+    {
+      continue;
+    }
+    std::chrono::nanoseconds age;
+    if (!m_controller->getControllerFeedbackAge(static_cast<SVHChannel>(i), age) ||
+        age >= max_age || sequences[i] <= m_poll_sequences[i] + own_replies)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SVHFingerManager::setFeedbackPollingRate(double rate)
+{
+  if (rate > 0.0 && rate <= C_FEEDBACK_POLLING_MAX_RATE)
+  {
+    m_feedback_period = static_cast<int64_t>(1.0e6 / rate);
+
+    // The reactor groups handlers by their period, so the handler moves to another group
+    const int timer = m_feedback_timer.exchange(-1);
+    if (timer >= 0)
+    {
+      m_reactor->remove(timer);
+      startReactorFeedbackPolling();
+    }
+    return true;
   }
+  SVH_LOG_WARN_STREAM("SVHFingerManager",
+                      "Feedback polling rate " << rate << " Hz is not within (0, "
+                                               << C_FEEDBACK_POLLING_MAX_RATE
+                                               << "] Hz - ignoring request");
+  return false;
+}
+
+void SVHFingerManager::setAdaptiveFeedbackPolling(bool enable)
+{
+  m_adaptive_feedback = enable;
 }
 
 } // namespace driver_svh
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains the request tracker that matches requests and responses.
+ */
+//----------------------------------------------------------------------
+#include <schunk_svh_library/control/SVHRequestTracker.h>
+
+namespace driver_svh {
+
+SVHRequestTracker::SVHRequestTracker()
+  : m_active(false)
+  , m_acknowledged(0)
+  , m_pending(0)
+{
+}
+
+void SVHRequestTracker::start()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_requests.clear();
+  m_unmatched.clear();
+  m_acknowledged = 0;
+  m_pending      = 0;
+  m_active.store(true, std::memory_order_release);
+}
+
+void SVHRequestTracker::stop()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_active.store(false, std::memory_order_release);
+  m_unmatched.clear();
+  // Wake up waiters, there will be no more responses for them
+  m_condition.notify_all();
+}
+
+void SVHRequestTracker::track(const SVHFixedSerialPacket& packet)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_active.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+
+  Request request = {packet, false};
+
+  // The response may have overtaken the bookkeeping
+  for (std::deque<Response>::iterator it = m_unmatched.begin(); it != m_unmatched.end(); ++it)
+  {
+    if (it->index == packet.index && it->address == packet.address)
+    {
+      m_unmatched.erase(it);
+      request.acknowledged = true;
+      break;
+    }
+  }
+
+  m_requests.push_back(request);
+  if (request.acknowledged)
+  {
+    m_acknowledged++;
+  }
+  else
+  {
+    m_pending++;
+  }
+}
+
+bool SVHRequestTracker::acknowledge(std::uint8_t index, std::uint8_t address)
+{
+  if (!m_active.load(std::memory_order_acquire))
+  {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (std::vector<Request>::iterator it = m_requests.begin(); it != m_requests.end(); ++it)
+  {
+    if (!it->acknowledged && it->packet.index == index && it->packet.address == address)
+    {
+      it->acknowledged = true;
+      m_acknowledged++;
+      m_pending--;
+      if (m_pending == 0)
+      {
+        m_condition.notify_all();
+      }
+      return true;
+    }
+  }
+
+  // Keep the response until its request is recorded, old ones are dropped
+  Response response = {index, address};
+  m_unmatched.push_back(response);
+  if (m_unmatched.size() > C_TRACKER_UNMATCHED_RESPONSES)
+  {
+    m_unmatched.pop_front();
+  }
+  return false;
+}
+
+bool SVHRequestTracker::waitForAll(const std::chrono::microseconds& timeout)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  return m_condition.wait_for(lock, timeout, [this] {
+    return m_pending == 0 || !m_active.load(std::memory_order_relaxed);
+  }) && m_pending == 0;
+}
+
+std::vector<SVHFixedSerialPacket> SVHRequestTracker::takeUnacknowledged()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<SVHFixedSerialPacket> packets;
+  std::vector<Request> answered;
+  for (std::vector<Request>::const_iterator it = m_requests.begin(); it != m_requests.end(); ++it)
+  {
+    if (it->acknowledged)
+    {
+      answered.push_back(*it);
+    }
+    else
+    {
+      packets.push_back(it->packet);
+    }
+  }
+  m_requests.swap(answered);
+  m_pending = 0;
+  return packets;
+}
+
+size_t SVHRequestTracker::acknowledgedCount()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_acknowledged;
+}
+
+size_t SVHRequestTracker::pendingCount()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pending;
+}
+
+} // namespace driver_svh
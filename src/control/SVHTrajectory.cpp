@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains the interpolation of timed waypoints.
+ */
+//----------------------------------------------------------------------
+#include <schunk_svh_library/control/SVHTrajectory.h>
+
+#include <algorithm>
+
+namespace driver_svh {
+
+SVHTrajectory::SVHTrajectory()
+  : m_interpolation(SVH_INTERPOLATION_LINEAR)
+  , m_times()
+  , m_positions()
+  , m_velocities()
+{
+}
+
+bool SVHTrajectory::setWaypoints(const std::vector<SVHTrajectoryWaypoint>& waypoints,
+                                 SVHInterpolation interpolation)
+{
+  if (waypoints.empty() || waypoints.front().time.count() < 0)
+  {
+    return false;
+  }
+  for (size_t i = 0; i < waypoints.size(); ++i)
+  {
+    if (waypoints[i].positions.size() != C_TRAJECTORY_CHANNELS ||
+        (i > 0 && waypoints[i].time <= waypoints[i - 1].time))
+    {
+      return false;
+    }
+  }
+
+  const size_t count = waypoints.size();
+  m_interpolation    = interpolation;
+  m_times.resize(count);
+  m_positions.resize(count * C_TRAJECTORY_CHANNELS);
+  m_velocities.assign(count * C_TRAJECTORY_CHANNELS, 0.0);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    m_times[i] = std::chrono::duration<double>(waypoints[i].time).count();
+    std::copy(waypoints[i].positions.begin(),
+              waypoints[i].positions.end(),
+              m_positions.begin() + i * C_TRAJECTORY_CHANNELS);
+  }
+
+  // The trajectory starts and ends at rest. Inner velocities are the harmonic mean of the
+  // neighbouring slopes and zero at local extrema, which keeps every channel monotonic between
+  // its waypoints.
+  for (size_t i = 1; i + 1 < count; ++i)
+  {
+    for (size_t channel = 0; channel < C_TRAJECTORY_CHANNELS; ++channel)
+    {
+      const size_t current   = i * C_TRAJECTORY_CHANNELS + channel;
+      const size_t previous  = current - C_TRAJECTORY_CHANNELS;
+      const size_t next      = current + C_TRAJECTORY_CHANNELS;
+      const double slope_in  = (m_positions[current] - m_positions[previous]) /
+                              (m_times[i] - m_times[i - 1]);
+      const double slope_out = (m_positions[next] - m_positions[current]) /
+                              (m_times[i + 1] - m_times[i]);
+      if (slope_in * slope_out > 0.0)
+      {
+        m_velocities[current] = 2.0 * slope_in * slope_out / (slope_in + slope_out);
+      }
+    }
+  }
+  return true;
+}
+
+std::chrono::microseconds SVHTrajectory::duration() const
+{
+  if (m_times.empty())
+  {
+    return std::chrono::microseconds(0);
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::duration<double>(m_times.back()));
+}
+
+void SVHTrajectory::sample(const std::chrono::microseconds& time,
+                           std::vector<double>& positions) const
+{
+  positions.resize(C_TRAJECTORY_CHANNELS);
+  if (m_times.empty())
+  {
+    std::fill(positions.begin(), positions.end(), 0.0);
+    return;
+  }
+
+  const double t = std::chrono::duration<double>(time).count();
+
+  // Hold the first or last waypoint outside of the trajectory
+  size_t hold = m_times.size();
+  if (t <= m_times.front())
+  {
+    hold = 0;
+  }
+  else if (t >= m_times.back())
+  {
+    hold = m_times.size() - 1;
+  }
+  if (hold < m_times.size())
+  {
+    std::copy(m_positions.begin() + hold * C_TRAJECTORY_CHANNELS,
+              m_positions.begin() + (hold + 1) * C_TRAJECTORY_CHANNELS,
+              positions.begin());
+    return;
+  }
+
+  // Segment [begin, begin + 1] that contains t
+  const size_t end   = std::upper_bound(m_times.begin(), m_times.end(), t) - m_times.begin();
+  const size_t begin = end - 1;
+  const double h     = m_times[end] - m_times[begin];
+  const double s     = (t - m_times[begin]) / h;
+  const double s2    = s * s;
+  const double s3    = s2 * s;
+
+  // Hermite basis functions for the start and end position and velocity
+  double p0, v0, p1, v1;
+  switch (m_interpolation)
+  {
+    case SVH_INTERPOLATION_CUBIC: {
+      p0 = 2.0 * s3 - 3.0 * s2 + 1.0;
+      v0 = s3 - 2.0 * s2 + s;
+      p1 = -2.0 * s3 + 3.0 * s2;
+      v1 = s3 - s2;
+      break;
+    }
+    case SVH_INTERPOLATION_QUINTIC: {
+      // Accelerations at the waypoints are zero
+      const double s4 = s3 * s;
+      const double s5 = s4 * s;
+      p0              = 1.0 - 10.0 * s3 + 15.0 * s4 - 6.0 * s5;
+      v0              = s - 6.0 * s3 + 8.0 * s4 - 3.0 * s5;
+      p1              = 10.0 * s3 - 15.0 * s4 + 6.0 * s5;
+      v1              = -4.0 * s3 + 7.0 * s4 - 3.0 * s5;
+      break;
+    }
+    default: {
+      p0 = 1.0 - s;
+      v0 = 0.0;
+      p1 = s;
+      v1 = 0.0;
+      break;
+    }
+  }
+
+  for (size_t channel = 0; channel < C_TRAJECTORY_CHANNELS; ++channel)
+  {
+    const size_t first  = begin * C_TRAJECTORY_CHANNELS + channel;
+    const size_t second = end * C_TRAJECTORY_CHANNELS + channel;
+    positions[channel]  = p0 * m_positions[first] + v0 * h * m_velocities[first] +
+                         p1 * m_positions[second] + v1 * h * m_velocities[second];
+  }
+}
+
+} // namespace driver_svh
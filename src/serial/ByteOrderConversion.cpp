@@ -47,38 +47,6 @@ std::ostream& operator<<(std::ostream& o, const ArrayBuilder& ab)
   return o;
 }
 
-template <>
-size_t toLittleEndian<float>(const float& data, std::vector<uint8_t>& array, size_t& write_pos)
-{
-  //! As Bit Shifts for floats are dissallowed they have to be given as reinterpreted value to
-  //! currectly shift each byte individually
-  return toLittleEndian(*(reinterpret_cast<const uint32_t*>(&data)), array, write_pos);
-}
-
-template <>
-size_t toLittleEndian<double>(const double& data, std::vector<uint8_t>& array, size_t& write_pos)
-{
-  //! As Bit Shifts for doubles are dissallowed they have to be given as reinterpreted value to
-  //! currectly shift each byte individually
-  return toLittleEndian(*(reinterpret_cast<const uint64_t*>(&data)), array, write_pos);
-}
-
-template <>
-size_t fromLittleEndian<float>(float& data, std::vector<uint8_t>& array, size_t& read_pos)
-{
-  //! As Bit Shifts for floats are dissallowed they have to be given as reinterpreted value to
-  //! currectly shift each byte individually
-  return fromLittleEndian(*(reinterpret_cast<uint32_t*>(&data)), array, read_pos);
-}
-
-template <>
-size_t fromLittleEndian<double>(double& data, std::vector<uint8_t>& array, size_t& read_pos)
-{
-  //! As Bit Shifts for doubles are dissallowed they have to be given as reinterpreted value to
-  //! currectly shift each byte individually
-  return fromLittleEndian(*(reinterpret_cast<uint64_t*>(&data)), array, read_pos);
-}
-
 void ArrayBuilder::reset(size_t array_size)
 {
   array.clear();
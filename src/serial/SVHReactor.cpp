@@ -0,0 +1,567 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains the SVHReactor, an event loop that serves the serial
+ * devices, the timers and the wakeup events of the driver from one thread,
+ * and the SVHReactorPool sharing a few reactors between many hands.
+ */
+//----------------------------------------------------------------------
+#include <schunk_svh_library/Logger.h>
+#include <schunk_svh_library/serial/SVHReactor.h>
+
+#include <algorithm>
+#include <sstream>
+
+#ifdef _SYSTEM_LINUX_
+#  include <errno.h>
+#  include <string.h>
+#  include <sys/epoll.h>
+#  include <sys/eventfd.h>
+#  include <sys/timerfd.h>
+#  include <unistd.h>
+#endif
+
+namespace driver_svh {
+
+//! Number of ready sources fetched with one epoll_wait() call
+const int C_REACTOR_MAX_EVENTS = 16;
+
+//! Id the stop event is registered with, sources start at 0
+const int C_REACTOR_STOP_ID = -1;
+
+SVHReactor::SVHReactor(const SVHThreadSettings& settings)
+  : m_epoll_fd(-1)
+  , m_stop_fd(-1)
+  , m_running(false)
+  , m_dispatch_count(0)
+  , m_next_id(0)
+  , m_dispatching(-1)
+{
+#ifdef _SYSTEM_LINUX_
+  m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  m_stop_fd  = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (m_epoll_fd < 0 || m_stop_fd < 0)
+  {
+    SVH_LOG_ERROR_STREAM("SVHReactor", "Could not create the event loop: " << strerror(errno));
+    return;
+  }
+
+  epoll_event event;
+  event.events   = EPOLLIN;
+  event.data.u64 = static_cast<uint32_t>(C_REACTOR_STOP_ID);
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_stop_fd, &event) < 0)
+  {
+    SVH_LOG_ERROR_STREAM("SVHReactor", "Could not watch the stop event: " << strerror(errno));
+    return;
+  }
+
+  SVHThreadSettings thread_settings = settings;
+  if (thread_settings.name.empty())
+  {
+    thread_settings.name = "svh_reactor";
+  }
+  m_running = true;
+  m_thread  = m_thread_setup.start(thread_settings, [this] { run(); });
+#else
+  SVH_LOG_ERROR_STREAM("SVHReactor", "The reactor is only available on Linux.");
+#endif
+}
+
+SVHReactor::~SVHReactor()
+{
+#ifdef _SYSTEM_LINUX_
+  m_running = false;
+  if (m_thread.joinable())
+  {
+    uint64_t value = 1;
+    if (::write(m_stop_fd, &value, sizeof(value)) < 0)
+    {
+      SVH_LOG_DEBUG_STREAM("SVHReactor", "Could not signal the stop event: " << errno);
+    }
+    m_thread.join();
+  }
+
+  for (std::map<int, std::shared_ptr<Source> >::iterator it = m_sources.begin();
+       it != m_sources.end();
+       ++it)
+  {
+    if (it->second->kind != SOURCE_READER)
+    {
+      ::close(it->second->fd);
+    }
+  }
+  m_sources.clear();
+
+  if (m_stop_fd >= 0)
+  {
+    ::close(m_stop_fd);
+  }
+  if (m_epoll_fd >= 0)
+  {
+    ::close(m_epoll_fd);
+  }
+#endif
+}
+
+int SVHReactor::addReader(int fd, const ReactorHandler& handler)
+{
+  return addSource(fd, SOURCE_READER, handler);
+}
+
+int SVHReactor::addTimer(const ReactorHandler& handler)
+{
+#ifdef _SYSTEM_LINUX_
+  int fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+  if (fd < 0)
+  {
+    SVH_LOG_ERROR_STREAM("SVHReactor", "Could not create timer: " << strerror(errno));
+    return -1;
+  }
+  return addSource(fd, SOURCE_TIMER, handler);
+#else
+  return -1;
+#endif
+}
+
+int SVHReactor::addEvent(const ReactorHandler& handler)
+{
+#ifdef _SYSTEM_LINUX_
+  int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (fd < 0)
+  {
+    SVH_LOG_ERROR_STREAM("SVHReactor", "Could not create wakeup event: " << strerror(errno));
+    return -1;
+  }
+  return addSource(fd, SOURCE_EVENT, handler);
+#else
+  return -1;
+#endif
+}
+
+int SVHReactor::addSource(int fd, SourceKind kind, const ReactorHandler& handler)
+{
+#ifdef _SYSTEM_LINUX_
+  if (!m_running)
+  {
+    SVH_LOG_ERROR_STREAM("SVHReactor", "Cannot add a source, the reactor is not running.");
+    if (kind != SOURCE_READER)
+    {
+      ::close(fd);
+    }
+    return -1;
+  }
+
+  std::shared_ptr<Source> source = std::make_shared<Source>();
+  source->fd                     = fd;
+  source->kind                   = kind;
+  source->handler                = handler;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const int id = m_next_id++;
+  m_sources[id] = source;
+
+  epoll_event event;
+  event.events   = EPOLLIN;
+  event.data.u64 = static_cast<uint32_t>(id);
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0)
+  {
+    SVH_LOG_ERROR_STREAM("SVHReactor", "Could not watch file descriptor: " << strerror(errno));
+    m_sources.erase(id);
+    if (kind != SOURCE_READER)
+    {
+      ::close(fd);
+    }
+    return -1;
+  }
+  return id;
+#else
+  return -1;
+#endif
+}
+
+int SVHReactor::sourceFd(int id, SourceKind kind)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::map<int, std::shared_ptr<Source> >::const_iterator it = m_sources.find(id);
+  if (it == m_sources.end() || it->second->kind != kind)
+  {
+    return -1;
+  }
+  return it->second->fd;
+}
+
+bool SVHReactor::armTimer(int id,
+                          const std::chrono::steady_clock::time_point& expiry,
+                          const std::chrono::microseconds& period)
+{
+#ifdef _SYSTEM_LINUX_
+  const int fd = sourceFd(id, SOURCE_TIMER);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  // steady_clock is CLOCK_MONOTONIC, so its time points can be handed to the kernel as they are
+  const int64_t expiry_ns =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(expiry.time_since_epoch()).count();
+  const int64_t period_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(period).count();
+
+  itimerspec spec;
+  spec.it_value.tv_sec     = static_cast<time_t>(expiry_ns / 1000000000);
+  spec.it_value.tv_nsec    = static_cast<long>(expiry_ns % 1000000000);
+  spec.it_interval.tv_sec  = static_cast<time_t>(period_ns / 1000000000);
+  spec.it_interval.tv_nsec = static_cast<long>(period_ns % 1000000000);
+  if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+  {
+    // A zero expiry would disarm the timer
+    spec.it_value.tv_nsec = 1;
+  }
+  if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, NULL) < 0)
+  {
+    SVH_LOG_ERROR_STREAM("SVHReactor", "Could not arm timer: " << strerror(errno));
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool SVHReactor::disarmTimer(int id)
+{
+#ifdef _SYSTEM_LINUX_
+  const int fd = sourceFd(id, SOURCE_TIMER);
+  if (fd < 0)
+  {
+    return false;
+  }
+  itimerspec spec = {};
+  return timerfd_settime(fd, 0, &spec, NULL) == 0;
+#else
+  return false;
+#endif
+}
+
+bool SVHReactor::notify(int id)
+{
+#ifdef _SYSTEM_LINUX_
+  const int fd = sourceFd(id, SOURCE_EVENT);
+  if (fd < 0)
+  {
+    return false;
+  }
+  uint64_t value = 1;
+  return ::write(fd, &value, sizeof(value)) == sizeof(value);
+#else
+  return false;
+#endif
+}
+
+int SVHReactor::addPeriodic(const std::chrono::microseconds& period,
+                            const ReactorHandler& handler)
+{
+  if (period.count() <= 0)
+  {
+    SVH_LOG_ERROR_STREAM("SVHReactor", "Period of " << period.count() << " us is invalid.");
+    return -1;
+  }
+
+  std::lock_guard<std::mutex> periodic_lock(m_periodic_mutex);
+  std::map<int64_t, PeriodicGroup>::iterator group = m_periodic_groups.find(period.count());
+  if (group == m_periodic_groups.end())
+  {
+    // The first handler of this period brings the timer along
+    const int64_t key = period.count();
+    const int timer   = addTimer([this, key] { runPeriodic(key); });
+    if (timer < 0)
+    {
+      return -1;
+    }
+    if (!armTimer(timer, std::chrono::steady_clock::now(), period))
+    {
+      removeSource(timer);
+      return -1;
+    }
+    PeriodicGroup new_group;
+    new_group.timer = timer;
+    group           = m_periodic_groups.insert(std::make_pair(key, new_group)).first;
+  }
+
+  int id;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    id = m_next_id++;
+  }
+  group->second.handlers[id] = handler;
+  m_periodic_periods[id]     = period.count();
+  updateSnapshot(group->second);
+  return id;
+}
+
+bool SVHReactor::removePeriodic(int id)
+{
+  int timer   = -1;
+  bool unused = false;
+  {
+    std::lock_guard<std::mutex> periodic_lock(m_periodic_mutex);
+    std::map<int, int64_t>::iterator period = m_periodic_periods.find(id);
+    if (period == m_periodic_periods.end())
+    {
+      return false;
+    }
+    PeriodicGroup& group = m_periodic_groups[period->second];
+    group.handlers.erase(id);
+    timer  = group.timer;
+    unused = group.handlers.empty();
+    if (unused)
+    {
+      m_periodic_groups.erase(period->second);
+    }
+    else
+    {
+      updateSnapshot(group);
+    }
+    m_periodic_periods.erase(period);
+  }
+
+  // The handler may be running as part of its group, which needs the periodic lock
+  if (unused)
+  {
+    removeSource(timer);
+  }
+  else
+  {
+    waitForDispatch(timer);
+  }
+  return true;
+}
+
+void SVHReactor::updateSnapshot(PeriodicGroup& group)
+{
+  std::shared_ptr<std::vector<ReactorHandler> > snapshot(new std::vector<ReactorHandler>());
+  snapshot->reserve(group.handlers.size());
+  for (std::map<int, ReactorHandler>::const_iterator it = group.handlers.begin();
+       it != group.handlers.end();
+       ++it)
+  {
+    snapshot->push_back(it->second);
+  }
+  group.snapshot = snapshot;
+}
+
+void SVHReactor::runPeriodic(int64_t period)
+{
+  // Only the reference count of the snapshot changes on a tick, so nothing is allocated. A
+  // snapshot that is replaced meanwhile stays alive until its handlers returned.
+  std::shared_ptr<const std::vector<ReactorHandler> > handlers;
+  {
+    std::lock_guard<std::mutex> periodic_lock(m_periodic_mutex);
+    std::map<int64_t, PeriodicGroup>::const_iterator group = m_periodic_groups.find(period);
+    if (group == m_periodic_groups.end())
+    {
+      return;
+    }
+    handlers = group->second.snapshot;
+  }
+
+  for (size_t i = 0; i < handlers->size(); ++i)
+  {
+    (*handlers)[i]();
+  }
+}
+
+size_t SVHReactor::sourceCount()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_sources.size();
+}
+
+void SVHReactor::waitForDispatch(int id)
+{
+  if (inReactorThread())
+  {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_dispatch_condition.wait(lock, [this, id] { return m_dispatching != id; });
+}
+
+void SVHReactor::remove(int id)
+{
+  if (id >= 0 && !removePeriodic(id))
+  {
+    removeSource(id);
+  }
+}
+
+void SVHReactor::removeSource(int id)
+{
+#ifdef _SYSTEM_LINUX_
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::map<int, std::shared_ptr<Source> >::iterator it = m_sources.find(id);
+  if (it == m_sources.end())
+  {
+    return;
+  }
+  std::shared_ptr<Source> source = it->second;
+  m_sources.erase(it);
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
+
+  // Events of this source that were already fetched find no source anymore, only a handler call
+  // in progress has to be waited for
+  if (!inReactorThread())
+  {
+    m_dispatch_condition.wait(lock, [this, id] { return m_dispatching != id; });
+  }
+
+  if (source->kind != SOURCE_READER)
+  {
+    ::close(source->fd);
+  }
+#endif
+}
+
+void SVHReactor::run()
+{
+#ifdef _SYSTEM_LINUX_
+  epoll_event events[C_REACTOR_MAX_EVENTS];
+  while (m_running)
+  {
+    // Nothing but the sources wakes us up, there is no timeout
+    int ready = epoll_wait(m_epoll_fd, events, C_REACTOR_MAX_EVENTS, -1);
+    if (ready < 0)
+    {
+      if (errno != EINTR)
+      {
+        SVH_LOG_ERROR_STREAM("SVHReactor", "Event loop failed: " << strerror(errno));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      continue;
+    }
+
+    for (int i = 0; i < ready && m_running; ++i)
+    {
+      const int id = static_cast<int>(static_cast<uint32_t>(events[i].data.u64));
+      if (id == C_REACTOR_STOP_ID)
+      {
+        continue;
+      }
+      dispatch(id, events[i].events);
+    }
+  }
+#endif
+}
+
+void SVHReactor::dispatch(int id, std::uint32_t events)
+{
+#ifdef _SYSTEM_LINUX_
+  std::shared_ptr<Source> source;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::map<int, std::shared_ptr<Source> >::const_iterator it = m_sources.find(id);
+    if (it == m_sources.end())
+    {
+      // Removed after epoll_wait() returned
+      return;
+    }
+    source        = it->second;
+    m_dispatching = id;
+  }
+
+  bool call = true;
+  if (source->kind == SOURCE_READER)
+  {
+    call = (events & EPOLLIN) != 0;
+    if (events & (EPOLLERR | EPOLLHUP))
+    {
+      // The handler still gets the data that arrived before, but a broken descriptor would be
+      // reported over and over again
+      SVH_LOG_DEBUG_STREAM("SVHReactor",
+                           "File descriptor " << source->fd << " reported " << events
+                                              << ", disabling it.");
+      epoll_event event;
+      event.events   = 0;
+      event.data.u64 = static_cast<uint32_t>(id);
+      epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, source->fd, &event);
+    }
+  }
+  else
+  {
+    // Timers and events count their expirations, reading resets them to zero
+    uint64_t count = 0;
+    call           = ::read(source->fd, &count, sizeof(count)) == sizeof(count) && count > 0;
+  }
+
+  if (call && source->handler)
+  {
+    m_dispatch_count++;
+    source->handler();
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_dispatching = -1;
+  m_dispatch_condition.notify_all();
+#else
+  (void)id;
+  (void)events;
+#endif
+}
+
+SVHReactorPool::SVHReactorPool(size_t size, const SVHThreadSettings& settings)
+{
+  for (size_t i = 0; i < std::max<size_t>(size, 1); ++i)
+  {
+    SVHThreadSettings reactor_settings = settings;
+    if (reactor_settings.name.empty())
+    {
+      std::stringstream name;
+      name << "svh_reactor_" << i;
+      reactor_settings.name = name.str();
+    }
+    m_reactors.push_back(std::make_shared<SVHReactor>(reactor_settings));
+  }
+}
+
+std::shared_ptr<SVHReactor> SVHReactorPool::acquire()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  // Every hand holds a reference, the pool holds one more
+  size_t best = 0;
+  for (size_t i = 1; i < m_reactors.size(); ++i)
+  {
+    if (m_reactors[i].use_count() < m_reactors[best].use_count())
+    {
+      best = i;
+    }
+  }
+  return m_reactors[best];
+}
+
+} // namespace driver_svh
@@ -40,6 +40,14 @@
 #include <sstream>
 #include <thread>
 
+#ifdef _SYSTEM_LINUX_
+#  include <errno.h>
+#  include <poll.h>
+#  include <string.h>
+#  include <sys/eventfd.h>
+#  include <unistd.h>
+#endif
+
 using driver_svh::ArrayBuilder;
 
 namespace driver_svh {
@@ -48,19 +56,75 @@ SVHReceiveThread::SVHReceiveThread(const std::chrono::microseconds& idle_sleep,
                                    std::shared_ptr<Serial> device,
                                    ReceivedPacketCallback const& received_callback)
   : m_idle_sleep(idle_sleep)
+  , m_wait_for_data(false)
+  , m_wakeup_fd(-1)
   , m_serial_device(device)
   , m_received_state(RS_HEADE_R1)
   , m_length(0)
-  , m_data(0, 0)
-  , m_ab(0)
+  , m_checksum1(0)
+  , m_checksum2(0)
+  , m_received_packet(C_PACKET_DATA_SIZE)
   , m_packets_received(0)
+  , m_packets_skipped(0)
   , m_skipped_bytes(0)
   , m_received_callback(received_callback)
 {
 }
 
+SVHReceiveThread::SVHReceiveThread(std::shared_ptr<Serial> device,
+                                   ReceivedPacketCallback const& received_callback)
+  : SVHReceiveThread(std::chrono::microseconds(500), device, received_callback)
+{
+#ifdef _SYSTEM_LINUX_
+  m_wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (m_wakeup_fd >= 0)
+  {
+    m_wait_for_data = true;
+    // Only used as retry period if the device reports errors
+    m_idle_sleep = std::chrono::milliseconds(10);
+  }
+  else
+  {
+    SVH_LOG_WARN_STREAM("SVHReceiveThread",
+                        "Could not create eventfd (" << strerror(errno)
+                                                     << "), falling back to polling the device.");
+  }
+#endif
+}
+
+SVHReceiveThread::~SVHReceiveThread()
+{
+#ifdef _SYSTEM_LINUX_
+  if (m_wakeup_fd >= 0)
+  {
+    ::close(m_wakeup_fd);
+  }
+#endif
+}
+
+void SVHReceiveThread::stop()
+{
+  m_continue = false;
+#ifdef _SYSTEM_LINUX_
+  if (m_wakeup_fd >= 0)
+  {
+    uint64_t value = 1;
+    if (::write(m_wakeup_fd, &value, sizeof(value)) < 0)
+    {
+      SVH_LOG_DEBUG_STREAM("SVHReceiveThread", "Could not wake up receive thread: " << errno);
+    }
+  }
+#endif
+}
+
 void SVHReceiveThread::run()
 {
+  if (m_wait_for_data)
+  {
+    waitForData();
+    return;
+  }
+
   while (m_continue)
   {
     if (m_serial_device) // != NULL)
@@ -99,19 +163,68 @@ void SVHReceiveThread::run()
   }
 }
 
+void SVHReceiveThread::waitForData()
+{
+#ifdef _SYSTEM_LINUX_
+  pollfd fds[2];
+  fds[0].fd     = m_wakeup_fd;
+  fds[0].events = POLLIN;
+  fds[1].events = POLLIN;
+
+  while (m_continue)
+  {
+    if (!m_serial_device || !m_serial_device->isOpen())
+    {
+      SVH_LOG_WARN_STREAM("SVHReceiveThread",
+                          "Cannot read data from serial device. It is not opened!");
+      std::this_thread::sleep_for(m_idle_sleep);
+      continue;
+    }
+
+    fds[1].fd      = m_serial_device->fileDescriptor();
+    fds[0].revents = 0;
+    fds[1].revents = 0;
+
+    // Sleep until either data arrives or stop() is called. No timeout needed.
+    if (::poll(fds, 2, -1) < 0)
+    {
+      if (errno != EINTR)
+      {
+        SVH_LOG_DEBUG_STREAM("SVHReceiveThread", "Poll error: " << strerror(errno));
+        std::this_thread::sleep_for(m_idle_sleep);
+      }
+      continue;
+    }
+
+    if (fds[0].revents & POLLIN)
+    {
+      uint64_t value;
+      if (::read(m_wakeup_fd, &value, sizeof(value)) < 0)
+      {
+        SVH_LOG_DEBUG_STREAM("SVHReceiveThread", "Could not clear wakeup event: " << errno);
+      }
+    }
+
+    if (fds[1].revents & POLLIN)
+    {
+      receiveData();
+    }
+    else if (fds[1].revents & (POLLERR | POLLHUP | POLLNVAL))
+    {
+      // The device is gone or broken. Do not spin on the error but retry periodically.
+      SVH_LOG_DEBUG_STREAM("SVHReceiveThread",
+                           "Serial device reported an error condition: " << fds[1].revents);
+      std::this_thread::sleep_for(m_idle_sleep);
+    }
+  }
+#endif
+}
+
 bool SVHReceiveThread::receiveData()
 {
-  /*
-   * Each packet has to follow the defined packet structure which is ensured by the following state
-   * machine. The "Bytestream" (not realy a stream) is interpreted byte by byte. If the structure is
-   * still right the next state is entered, if a wrong byte is detected the whole packet is
-   * discarded and the SM switches to the synchronization state aggain. If the SM reaches the final
-   * state the packet will be given to the packet handler to decide what to do with its content.
-   *  NOTE: All layers working with a SerialPacket (except this one) assume that the packet has a
-   * valid structure and all data fields present.
-   */
-  uint8_t data_byte;
-  ssize_t bytes = m_serial_device->read(&data_byte, sizeof(uint8_t));
+  // Drain everything the device has buffered in one call instead of asking for every single byte.
+  // A zero timeout makes this a single select() and read() per burst of data.
+  ssize_t bytes = m_serial_device->read(m_read_buffer.data(), m_read_buffer.size(), 0);
   if (bytes < 0)
   {
     SVH_LOG_DEBUG_STREAM("SVHReceiveThread", "Serial read error:" << bytes);
@@ -122,6 +235,50 @@ bool SVHReceiveThread::receiveData()
     return false;
   }
 
+  // One clock read per burst. Every packet completed by these bytes was received at this time.
+  m_read_timestamp = std::chrono::steady_clock::now();
+
+  for (ssize_t i = 0; i < bytes; ++i)
+  {
+    processByte(m_read_buffer[i]);
+  }
+
+  return true;
+}
+
+size_t SVHReceiveThread::receiveAvailable()
+{
+  if (!m_serial_device || !m_serial_device->isOpen())
+  {
+    return 0;
+  }
+
+  ssize_t bytes = m_serial_device->readAvailable(m_read_buffer.data(), m_read_buffer.size());
+  if (bytes < 0)
+  {
+    SVH_LOG_DEBUG_STREAM("SVHReceiveThread", "Serial read error:" << bytes);
+    return 0;
+  }
+
+  m_read_timestamp = std::chrono::steady_clock::now();
+  for (ssize_t i = 0; i < bytes; ++i)
+  {
+    processByte(m_read_buffer[i]);
+  }
+  return static_cast<size_t>(bytes);
+}
+
+void SVHReceiveThread::processByte(std::uint8_t data_byte)
+{
+  /*
+   * Each packet has to follow the defined packet structure which is ensured by the following state
+   * machine. The "Bytestream" (not realy a stream) is interpreted byte by byte. If the structure is
+   * still right the next state is entered, if a wrong byte is detected the whole packet is
+   * discarded and the SM switches to the synchronization state aggain. If the SM reaches the final
+   * state the packet will be given to the packet handler to decide what to do with its content.
+   *  NOTE: All layers working with a SerialPacket (except this one) assume that the packet has a
+   * valid structure and all data fields present.
+   */
   switch (m_received_state)
   {
     case RS_HEADE_R1: {
@@ -156,85 +313,84 @@ bool SVHReceiveThread::receiveData()
       break;
     }
     case RS_INDEX: {
-      // Reset Array Builder for each fresh packet
-      m_ab.reset(0);
-
-      // Data bytes are not cenverted in endianess at this point
-      m_ab.appendWithoutConversion(data_byte);
-      m_received_state = RS_ADDRESS;
+      // The packet is reused for every frame, its payload keeps its capacity
+      m_received_packet.index = data_byte;
+      m_received_state        = RS_ADDRESS;
       break;
     }
     case RS_ADDRESS: {
       // get the address
-      m_ab.appendWithoutConversion(data_byte);
-      m_received_state = RS_LENGT_H1;
+      m_received_packet.address = data_byte;
+      m_received_state          = RS_LENGT_H1;
       break;
     }
     case RS_LENGT_H1: {
       // get payload length
-      m_ab.appendWithoutConversion(data_byte);
+      m_length         = data_byte;
       m_received_state = RS_LENGT_H2;
       break;
     }
     case RS_LENGT_H2: {
-      // get payload length
-      m_ab.appendWithoutConversion(data_byte);
-      m_length         = m_ab.readBack<uint16_t>();
-      m_received_state = RS_DATA;
-      m_data.clear();
-      m_data.reserve(m_length);
+      // get payload length, it is transmitted in little endian
+      m_length = static_cast<uint16_t>(m_length | (data_byte << 8));
+      if (m_length > C_PACKET_DATA_SIZE)
+      {
+        // No frame of the hand is longer, the header is corrupted. Waiting for its payload would
+        // swallow the frames that follow.
+        SVH_LOG_DEBUG_STREAM("SVHReceiveThread",
+                             "Invalid payload length " << m_length << ", skipping packet");
+        m_packets_skipped++;
+        m_skipped_bytes += 6;
+        m_received_state = RS_HEADE_R1;
+        break;
+      }
+      // The payload keeps the capacity of C_PACKET_DATA_SIZE it got in the constructor
+      m_received_packet.data.clear();
+      // Checksums are accumulated while the payload arrives
+      m_checksum1      = 0;
+      m_checksum2      = 0;
+      m_received_state = (m_length > 0) ? RS_DATA : RS_CHECKSU_M1;
       break;
     }
     case RS_DATA: {
       // get the payload itself
-      // Some conversion due to legacy hardware calls
-      m_data.push_back(data_byte);
-      m_ab.appendWithoutConversion(data_byte);
-      if (m_data.size() >= m_length)
+      m_received_packet.data.push_back(data_byte);
+      m_checksum1 += data_byte;
+      m_checksum2 ^= data_byte;
+      if (m_received_packet.data.size() >= m_length)
       {
         m_received_state = RS_CHECKSU_M1;
       }
       break;
     }
     case RS_CHECKSU_M1: {
-      m_checksum1      = data_byte;
-      m_checksum2      = 0;
+      // probe for correct checksum
+      m_checksum1      = static_cast<uint8_t>(data_byte - m_checksum1);
       m_received_state = RS_CHECKSU_M2;
       break;
     }
     case RS_CHECKSU_M2: {
-      m_checksum2       = data_byte;
       uint8_t checksum1 = m_checksum1;
-      uint8_t checksum2 = m_checksum2;
-      // probe for correct checksum
-      for (size_t i = 0; i < m_data.size(); ++i)
-      {
-        checksum1 -= m_data[i];
-        checksum2 ^= m_data[i];
-      }
+      uint8_t checksum2 = static_cast<uint8_t>(data_byte ^ m_checksum2);
 
       if ((checksum1 == 0) && (checksum2 == 0))
       {
-        // start with an empty package
-        // Warning: It is imperative for correct readouts to create the received_packet with the
-        // correct length!
-        SVHSerialPacket received_packet(m_length);
-        m_ab >> received_packet;
-
         m_packets_received++;
+        m_received_packet.timestamp = m_read_timestamp;
 
         if (m_skipped_bytes > 0)
           SVH_LOG_DEBUG_STREAM("SVHReceiveThread", "Skipped " << m_skipped_bytes << " bytes ");
         SVH_LOG_DEBUG_STREAM("SVHReceiveThread",
-                             "Received packet index:" << received_packet.index
-                                                      << ", address:" << received_packet.address
-                                                      << ", size:" << received_packet.data.size());
+                             "Received packet index:" << m_received_packet.index
+                                                      << ", address:" << m_received_packet.address
+                                                      << ", size:"
+                                                      << m_received_packet.data.size());
         m_skipped_bytes = 0;
 
         // notify whoever is waiting for this
         if (m_received_callback)
         {
-          m_received_callback(received_packet, m_packets_received);
+          m_received_callback(m_received_packet, m_packets_received);
         }
 
         m_received_state = RS_HEADE_R1;
@@ -243,28 +399,24 @@ bool SVHReceiveThread::receiveData()
       {
         m_received_state = RS_HEADE_R1;
 
-        SVHSerialPacket received_packet(m_length);
-        m_ab >> received_packet;
-
         if (m_skipped_bytes > 0)
           SVH_LOG_DEBUG_STREAM("SVHReceiveThread", "Skipped " << m_skipped_bytes << " bytes: ");
         SVH_LOG_DEBUG_STREAM("SVHReceiveThread",
                              "Checksum error: " << (int)checksum1 << "," << (int)checksum2
                                                 << "!=0, skipping " << m_length + 8
-                                                << "bytes, packet index:" << received_packet.index
-                                                << ", address:" << received_packet.address
-                                                << ", size:" << received_packet.data.size());
+                                                << "bytes, packet index:"
+                                                << m_received_packet.index
+                                                << ", address:" << m_received_packet.address
+                                                << ", size:" << m_received_packet.data.size());
         m_skipped_bytes = 0;
         if (m_received_callback)
         {
-          m_received_callback(received_packet, m_packets_received);
+          m_received_callback(m_received_packet, m_packets_received);
         }
       }
       break;
     }
   }
-
-  return true;
 }
 
 } // namespace driver_svh
@@ -37,7 +37,9 @@
 #include "schunk_svh_library/serial/SVHSerialInterface.h"
 #include "schunk_svh_library/Logger.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <functional>
 #include <memory>
 #include <schunk_svh_library/serial/ByteOrderConversion.h>
@@ -52,7 +54,36 @@ SVHSerialInterface::SVHSerialInterface(ReceivedPacketCallback const& received_pa
   : m_connected(false)
   , m_received_packet_callback(received_packet_callback)
   , m_packets_transmitted(0)
+  , m_transmit_window(0)
+  , m_acknowledge_timeout(std::chrono::milliseconds(10))
+  , m_packets_unacknowledged(0)
+  , m_pumped(false)
+  , m_reactor_driven(false)
+  , m_reactor_reader(-1)
+  , m_reactor_timer(-1)
+  , m_reactor_event(-1)
+  , m_emergency_generation(0)
+  , m_packets_flushed(0)
+  , m_transmit_running(false)
+  , m_active_submitters(0)
+  , m_writer_waiting(false)
+  , m_packets_submitted(0)
+  , m_packets_rejected(0)
+  , m_max_queue_depth(0)
 {
+  m_in_flight.reserve(C_MAX_TRANSMIT_WINDOW);
+
+  // Feedback and background traffic only get part of the link by default, so they cannot crowd
+  // out commands
+  for (size_t i = 0; i < SVH_PRIORITY_CLASSES; ++i)
+  {
+    m_transmit_queues[i].reset(new SVHTransmitQueue<TransmitRequest>(C_TRANSMIT_QUEUE_SIZE));
+    m_budget_shares[i]   = 1.0;
+    m_budget_tokens[i]   = 0.0;
+    m_packets_written[i] = 0;
+  }
+  m_budget_shares[SVH_PRIORITY_FEEDBACK]   = 0.5;
+  m_budget_shares[SVH_PRIORITY_BACKGROUND] = 0.5;
 }
 
 SVHSerialInterface::~SVHSerialInterface()
@@ -60,11 +91,20 @@ SVHSerialInterface::~SVHSerialInterface()
   // close();
 }
 
-bool SVHSerialInterface::connect(const std::string& dev_name)
+bool SVHSerialInterface::connect(const std::string& dev_name, const SVHThreadConfig& thread_config)
 {
   // close device if already opened
   close();
 
+  // Memory is locked before the threads start, so their stacks are locked as well
+  m_thread_config = thread_config;
+  m_thread_setup.clear();
+  m_thread_setup.setStackPrefault(thread_config.stack_prefault);
+  if (thread_config.lock_memory)
+  {
+    m_thread_setup.lockMemory();
+  }
+
   // create serial device
   m_serial_device.reset(
     new Serial(dev_name.c_str(), SerialFlags(SerialFlags::BR_921600, SerialFlags::DB_8)));
@@ -86,16 +126,31 @@ bool SVHSerialInterface::connect(const std::string& dev_name)
     return false;
   }
 
+  // The receiver blocks on the device and dispatches packets as soon as they arrive, unless the
+  // caller pumps it
   m_svh_receiver =
-    std::make_unique<SVHReceiveThread>(std::chrono::microseconds(500),
-                                       m_serial_device,
+    std::make_unique<SVHReceiveThread>(m_serial_device,
                                        std::bind(&SVHSerialInterface::receivedPacketCallback,
                                                  this,
                                                  std::placeholders::_1,
                                                  std::placeholders::_2));
 
-  // create receive thread
-  m_receive_thread = std::thread([this] { m_svh_receiver->run(); });
+  m_packets_submitted = 0;
+  m_packets_rejected  = 0;
+  m_max_queue_depth   = 0;
+  m_packets_flushed   = 0;
+  for (size_t i = 0; i < SVH_PRIORITY_CLASSES; ++i)
+  {
+    m_packets_written[i] = 0;
+    m_budget_tokens[i]   = C_LINK_BUDGET_BURST * C_FRAME_SIZE / C_LINK_BYTES_PER_SECOND * 1.0e6;
+  }
+  m_budget_refill    = std::chrono::steady_clock::now();
+  m_pump_next_write  = m_budget_refill;
+  m_transmit_running = true;
+  if (!m_pumped)
+  {
+    startThreads();
+  }
 
   m_connected = true;
   SVH_LOG_DEBUG_STREAM("SVHSerialInterface",
@@ -110,6 +165,62 @@ void SVHSerialInterface::close()
 {
   m_connected = false;
 
+  stopThreads();
+
+  // close and delete serial device handler
+  if (m_serial_device)
+  {
+    m_serial_device->close();
+
+    m_serial_device.reset();
+    SVH_LOG_DEBUG_STREAM("SVHSerialInterface", "Serial device handle was closed and terminated.");
+  }
+}
+
+void SVHSerialInterface::startThreads()
+{
+  if (m_reactor && registerWithReactor())
+  {
+    return;
+  }
+
+  // create receive thread
+  m_svh_receiver->resume();
+  m_receive_thread =
+    m_thread_setup.start(m_thread_config.receive, [this] { m_svh_receiver->run(); });
+
+  // create writer thread, from now on the only one writing to the device besides emergencies
+  m_transmit_running = true;
+  m_transmit_thread  =
+    m_thread_setup.start(m_thread_config.transmit, [this] { writeQueuedPackets(); });
+}
+
+void SVHSerialInterface::stopThreads()
+{
+  // let the writer thread send what is still queued (e.g. a final disable) and stop it. Producers
+  // that already passed the running check get to finish their push first.
+  m_transmit_running = false;
+  while (m_active_submitters > 0)
+  {
+    std::this_thread::yield();
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_transmit_wakeup_mutex);
+    m_transmit_wakeup_condition.notify_all();
+  }
+  if (m_transmit_thread.joinable())
+  {
+    m_transmit_thread.join();
+    SVH_LOG_DEBUG_STREAM("SVHSerialInterface", "Serial device writer thread was terminated.");
+  }
+  else
+  {
+    // Pumped or served by the reactor, so whatever is left is written right here. The reactor
+    // must not write at the same time.
+    unregisterFromReactor();
+    writeQueuedPackets();
+  }
+
   // cancel and delete receive packet thread
   if (m_svh_receiver)
   {
@@ -120,60 +231,324 @@ void SVHSerialInterface::close()
     m_receive_thread.join();
     SVH_LOG_DEBUG_STREAM("SVHSerialInterface", "Serial device receive thread was terminated.");
   }
+}
 
-  // close and delete serial device handler
-  if (m_serial_device)
+void SVHSerialInterface::setPumpMode(bool enable)
+{
+  if (enable == m_pumped)
   {
-    m_serial_device->close();
+    return;
+  }
 
-    m_serial_device.reset();
-    SVH_LOG_DEBUG_STREAM("SVHSerialInterface", "Serial device handle was closed and terminated.");
+  if (m_connected)
+  {
+    if (enable)
+    {
+      stopThreads();
+      m_pump_next_write  = std::chrono::steady_clock::now();
+      m_transmit_running = true;
+      m_pumped           = true;
+    }
+    else
+    {
+      m_pumped = false;
+      startThreads();
+    }
+  }
+  else
+  {
+    m_pumped = enable;
+  }
+}
+
+size_t SVHSerialInterface::read()
+{
+  if (!m_pumped || !m_connected)
+  {
+    return 0;
+  }
+  return m_svh_receiver->receiveAvailable();
+}
+
+size_t SVHSerialInterface::write()
+{
+  if (!m_pumped || !m_connected)
+  {
+    return 0;
+  }
+  return writeDuePackets();
+}
+
+size_t SVHSerialInterface::writeDuePackets()
+{
+  const double frame_time                         = C_FRAME_SIZE / C_LINK_BYTES_PER_SECOND * 1.0e6;
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  refillBudgets(now);
+
+  size_t written = 0;
+  TransmitRequest request;
+  while (now >= m_pump_next_write)
+  {
+    const size_t priority = nextWritablePriority();
+    if (priority >= SVH_PRIORITY_CLASSES || (m_transmit_window > 0 && !hasTransmitSlot()) ||
+        !m_transmit_queues[priority]->pop(request))
+    {
+      break;
+    }
+
+    bool success = false;
+    if (request.generation == m_emergency_generation)
+    {
+      m_budget_tokens[priority] -= frame_time;
+      success = writeCurrentPacket(request.packet, request.generation);
+      if (success)
+      {
+        m_packets_written[priority]++;
+        ++written;
+
+        // Replaces the sleeps of the writer thread, the next frame is due later
+        m_pump_next_write = now + request.hold_off;
+        if (m_transmit_window == 0)
+        {
+          m_pump_next_write +=
+            std::chrono::microseconds(static_cast<int64_t>(std::ceil(frame_time)));
+        }
+      }
+    }
+    else
+    {
+      m_packets_flushed++;
+    }
+
+    if (request.sent_index != NULL)
+    {
+      *request.sent_index = request.packet.index;
+    }
+    if (request.callback)
+    {
+      request.callback(success);
+    }
+  }
+  return written;
+}
+
+std::chrono::steady_clock::time_point SVHSerialInterface::nextWriteTime()
+{
+  if (transmitQueuesEmpty())
+  {
+    return std::chrono::steady_clock::time_point::max();
+  }
+
+  std::chrono::steady_clock::time_point next = m_pump_next_write;
+  if (nextWritablePriority() >= SVH_PRIORITY_CLASSES)
+  {
+    next = std::max(next, budgetRecoveryTime());
+  }
+  if (m_transmit_window > 0)
+  {
+    // An acknowledgement may open the window earlier, the reader takes care of that
+    std::lock_guard<std::mutex> lock(m_transmit_window_mutex);
+    if (m_in_flight.size() >= m_transmit_window)
+    {
+      next = std::max(next, m_in_flight.front().sent + m_acknowledge_timeout);
+    }
+  }
+  return next;
+}
+
+std::chrono::steady_clock::time_point SVHSerialInterface::budgetRecoveryTime() const
+{
+  const double frame_time = C_FRAME_SIZE / C_LINK_BYTES_PER_SECOND * 1.0e6;
+  std::chrono::steady_clock::time_point recovery = std::chrono::steady_clock::time_point::max();
+  for (size_t i = 0; i < SVH_PRIORITY_CLASSES; ++i)
+  {
+    if (!m_transmit_queues[i]->empty() && !hasBudget(i))
+    {
+      const std::chrono::microseconds missing(
+        static_cast<int64_t>(std::ceil((frame_time - m_budget_tokens[i]) / m_budget_shares[i])));
+      recovery = std::min(recovery, m_budget_refill + missing);
+    }
+  }
+  return recovery;
+}
+
+bool SVHSerialInterface::setReactor(const std::shared_ptr<SVHReactor>& reactor)
+{
+  if (m_connected)
+  {
+    SVH_LOG_ERROR_STREAM("SVHSerialInterface",
+                         "The reactor cannot be changed while the device is connected.");
+    return false;
+  }
+  m_reactor = reactor;
+  return true;
+}
+
+bool SVHSerialInterface::registerWithReactor()
+{
+  if (!m_reactor->isRunning())
+  {
+    SVH_LOG_WARN_STREAM("SVHSerialInterface",
+                        "Reactor is not running, starting receive and writer threads instead.");
+    return false;
+  }
+
+  m_transmit_running = true;
+  m_pump_next_write  = std::chrono::steady_clock::now();
+  m_reactor_timer    = m_reactor->addTimer([this] { reactorWrite(); });
+  m_reactor_event    = m_reactor->addEvent([this] { reactorWrite(); });
+  m_reactor_reader =
+    m_reactor->addReader(m_serial_device->fileDescriptor(), [this] { reactorRead(); });
+  if (m_reactor_timer < 0 || m_reactor_event < 0 || m_reactor_reader < 0)
+  {
+    SVH_LOG_WARN_STREAM("SVHSerialInterface",
+                        "Could not register with the reactor, starting receive and writer threads "
+                        "instead.");
+    unregisterFromReactor();
+    return false;
+  }
+
+  m_reactor_driven = true;
+  // Packets queued before the flag was set did not signal the event
+  m_reactor->notify(m_reactor_event);
+  return true;
+}
+
+void SVHSerialInterface::unregisterFromReactor()
+{
+  if (!m_reactor)
+  {
+    return;
+  }
+  m_reactor_driven = false;
+  m_reactor->remove(m_reactor_reader);
+  m_reactor->remove(m_reactor_timer);
+  m_reactor->remove(m_reactor_event);
+  m_reactor_reader = -1;
+  m_reactor_timer  = -1;
+  m_reactor_event  = -1;
+}
+
+void SVHSerialInterface::reactorRead()
+{
+  m_svh_receiver->receiveAvailable();
+
+  // Acknowledgements may have made room in the transmit window
+  if (m_transmit_window > 0 && m_transmit_running && !transmitQueuesEmpty())
+  {
+    reactorWrite();
+  }
+}
+
+void SVHSerialInterface::reactorWrite()
+{
+  writeDuePackets();
+
+  // Whatever is left is not due yet, the timer brings us back in time for it
+  const std::chrono::steady_clock::time_point next = nextWriteTime();
+  if (next != std::chrono::steady_clock::time_point::max())
+  {
+    m_reactor->armTimer(m_reactor_timer, next);
   }
 }
 
 bool SVHSerialInterface::sendPacket(SVHSerialPacket& packet)
 {
-  if (m_serial_device != NULL)
+  // For alignment: Always 64Byte data, padded with zeros
+  packet.data.resize(C_PACKET_DATA_SIZE, 0);
+  SVHFixedSerialPacket fixed_packet(packet);
+  bool success = sendPacket(fixed_packet);
+  // Callers match responses by the index the packet was sent with
+  packet.index = fixed_packet.index;
+  return success;
+}
+
+bool SVHSerialInterface::sendPacket(SVHFixedSerialPacket& packet)
+{
+  if (m_pumped)
   {
-    // For alignment: Always 64Byte data, padded with zeros
-    packet.data.resize(64, 0);
+    // Nobody would write it while we wait, it goes out with one of the next write() calls
+    return enqueuePacket(packet, TransmitCallback(), std::chrono::microseconds(0), NULL);
+  }
+
+  if (inReactorThread())
+  {
+    // A handler must not wait for the reactor, the packet goes out once the handler returned
+    return enqueuePacket(packet, TransmitCallback(), std::chrono::microseconds(0), NULL);
+  }
 
-    uint8_t check_sum1 = 0;
-    uint8_t check_sum2 = 0;
+  if (!m_transmit_running || std::this_thread::get_id() == m_transmit_thread.get_id())
+  {
+    // Not connected (nothing can interleave) or called from a completion callback
+    return writePacket(packet);
+  }
 
-    // Calculate Checksum for the packet
-    for (size_t i = 0; i < packet.data.size(); i++)
+  // Hand the packet to the writer thread and wait until it is on the wire
+  struct Completion
+  {
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool done;
+    bool success;
+  } completion;
+  completion.done    = false;
+  completion.success = false;
+
+  TransmitCallback callback = [&completion](bool success) {
+    std::lock_guard<std::mutex> lock(completion.mutex);
+    completion.success = success;
+    completion.done    = true;
+    completion.condition.notify_one();
+  };
+
+  // The writer reports the index back so that the caller can match the response
+  while (!enqueuePacket(packet, callback, std::chrono::microseconds(0), &packet.index))
+  {
+    if (!m_transmit_running)
     {
-      check_sum1 += packet.data[i];
-      check_sum2 ^= packet.data[i];
+      return false;
     }
+    // The queue is full, the writer frees a slot roughly every packet time
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
 
-    // set packet counter
-    packet.index = static_cast<uint8_t>(m_packets_transmitted % uint8_t(-1));
+  std::unique_lock<std::mutex> lock(completion.mutex);
+  completion.condition.wait(lock, [&completion] { return completion.done; });
+  return completion.success;
+}
 
+bool SVHSerialInterface::writePacket(SVHFixedSerialPacket& packet)
+{
+  return writePacket(packet, m_emergency_generation);
+}
+
+bool SVHSerialInterface::writePacket(SVHFixedSerialPacket& packet, unsigned int generation)
+{
+  if (m_serial_device != NULL)
+  {
     if (m_serial_device->isOpen())
     {
-      // Prepare arraybuilder
-      ssize_t size = static_cast<ssize_t>(packet.data.size() + C_PACKET_APPENDIX_SIZE);
-      driver_svh::ArrayBuilder send_array(size);
-      // Write header and packet information and checksum
-      send_array << PACKET_HEADER1 << PACKET_HEADER2 << packet << check_sum1 << check_sum2;
+      if (m_transmit_window > 0)
+      {
+        waitForTransmitSlot();
+      }
 
-      // actual hardware call to send the packet
-      ssize_t bytes_send = 0;
-      while (bytes_send < size)
+      if (!writeCurrentPacket(packet, generation))
       {
-        bytes_send +=
-          m_serial_device->write(send_array.array.data() + bytes_send, size - bytes_send);
+        return false;
       }
 
-      // Small delay -> THIS SHOULD NOT BE NECESSARY as the communication speed should be handable
-      // by the HW. However, it will die if this sleep is not used and this may also depend on your
-      // computer speed -> This issue might stem also from the hardware and will hopefully be fixed
-      // soon. 782µs are needed to send 72bytes via a baudrate of 921600
-      std::this_thread::sleep_for(std::chrono::microseconds(782));
-      // Instead you could wait for the response of the packet (or on of the previous n packets).
-      // This slows down the speed to the 2-way latency, which is platform dependent
+      if (m_transmit_window == 0)
+      {
+        // Small delay -> THIS SHOULD NOT BE NECESSARY as the communication speed should be
+        // handable by the HW. However, it will die if this sleep is not used and this may also
+        // depend on your computer speed -> This issue might stem also from the hardware and will
+        // hopefully be fixed soon. 782µs are needed to send 72bytes via a baudrate of 921600
+        std::this_thread::sleep_for(std::chrono::microseconds(782));
+        // Instead you can wait for the response of the packet (or on of the previous n packets)
+        // by setting a transmit window. This slows down the speed to the 2-way latency, which is
+        // platform dependent
+      }
     }
     else
     {
@@ -181,16 +556,407 @@ bool SVHSerialInterface::sendPacket(SVHSerialPacket& packet)
                            "sendPacket failed, serial device was not properly initialized.");
       return false;
     }
+  }
+
+  return true;
+}
+
+bool SVHSerialInterface::writeCurrentPacket(SVHFixedSerialPacket& packet, unsigned int generation)
+{
+  // Emergency packets are written from their caller's thread, so the device is shared
+  std::lock_guard<std::mutex> lock(m_device_mutex);
+  if (generation != m_emergency_generation)
+  {
+    // An emergency packet got ahead of this one while it waited for the window
+    m_packets_flushed++;
+    return false;
+  }
+
+  // set packet counter
+  packet.index = static_cast<uint8_t>(m_packets_transmitted % uint8_t(-1));
+  if (m_transmit_window > 0)
+  {
+    // Register before writing, the answer might be faster than we are
+    registerTransmitSlot(packet.index);
+  }
+  return writeFrame(packet, m_transmit_frame);
+}
+
+bool SVHSerialInterface::writeFrame(const SVHFixedSerialPacket& packet, SVHSerialFrame& frame)
+{
+  // Write header, packet information and checksum into the preallocated frame
+  encodeFrame(packet, frame);
+
+  // actual hardware call to send the packet
+  ssize_t size       = static_cast<ssize_t>(frame.size());
+  ssize_t bytes_send = 0;
+  while (bytes_send < size)
+  {
+    ssize_t bytes = m_serial_device->write(frame.data() + bytes_send, size - bytes_send);
+    if (bytes < 0)
+    {
+      SVH_LOG_ERROR_STREAM("SVHSerialInterface",
+                           "sendPacket failed, could not write to the serial device.");
+      return false;
+    }
+    bytes_send += bytes;
+  }
+
+  m_packets_transmitted++;
+  return true;
+}
+
+bool SVHSerialInterface::sendEmergencyPacket(SVHFixedSerialPacket& packet)
+{
+  if (m_serial_device == NULL || !m_serial_device->isOpen())
+  {
+    SVH_LOG_ERROR_STREAM("SVHSerialInterface",
+                         "Emergency packet could not be sent, serial device is not open.");
+    return false;
+  }
+
+  // Waits at most for the frame that is being written right now
+  std::lock_guard<std::mutex> lock(m_device_mutex);
+
+  // Everything queued so far was meant for the time before the emergency
+  m_emergency_generation++;
+
+  // Emergency packets are never held back by the transmit window, so they are not registered
+  packet.index = static_cast<uint8_t>(m_packets_transmitted % uint8_t(-1));
+  return writeFrame(packet, m_emergency_frame);
+}
+
+bool SVHSerialInterface::submitPacket(const SVHSerialPacket& packet,
+                                      const TransmitCallback& callback,
+                                      const std::chrono::microseconds& hold_off)
+{
+  return submitPacket(SVHFixedSerialPacket(packet), callback, hold_off);
+}
+
+bool SVHSerialInterface::submitPacket(const SVHFixedSerialPacket& packet,
+                                      const TransmitCallback& callback,
+                                      const std::chrono::microseconds& hold_off)
+{
+  return enqueuePacket(packet, callback, hold_off, NULL);
+}
+
+bool SVHSerialInterface::enqueuePacket(const SVHFixedSerialPacket& packet,
+                                       const TransmitCallback& callback,
+                                       const std::chrono::microseconds& hold_off,
+                                       std::uint8_t* sent_index)
+{
+  // Announce ourselves before checking the running flag so that close() can wait for us
+  m_active_submitters++;
+  if (!m_transmit_running)
+  {
+    m_active_submitters--;
+    SVH_LOG_DEBUG_STREAM("SVHSerialInterface",
+                         "submitPacket failed, serial device was not properly initialized.");
+    return false;
+  }
+
+  SVHTransmitQueue<TransmitRequest>& queue = *m_transmit_queues[transmitPriority(packet.address)];
+  TransmitRequest request = {packet, callback, hold_off, sent_index, m_emergency_generation};
+  bool pushed                              = queue.push(request);
+  m_active_submitters--;
+
+  if (!pushed)
+  {
+    m_packets_rejected++;
+    SVH_LOG_DEBUG_STREAM("SVHSerialInterface", "submitPacket failed, transmit queue is full.");
+    return false;
+  }
+  m_packets_submitted++;
+
+  size_t depth     = queue.size();
+  size_t max_depth = m_max_queue_depth;
+  while (depth > max_depth && !m_max_queue_depth.compare_exchange_weak(max_depth, depth))
+  {
+  }
+
+  if (m_reactor_driven)
+  {
+    m_reactor->notify(m_reactor_event);
+  }
+
+  // Only take the lock if the writer actually sleeps
+  if (m_writer_waiting)
+  {
+    std::lock_guard<std::mutex> lock(m_transmit_wakeup_mutex);
+    m_transmit_wakeup_condition.notify_one();
+  }
+  return true;
+}
+
+std::future<bool> SVHSerialInterface::submitPacketAsync(const SVHSerialPacket& packet)
+{
+  // std::function needs a copyable target, so the promise is shared with the callback
+  std::shared_ptr<std::promise<bool> > promise = std::make_shared<std::promise<bool> >();
+  std::future<bool> result                     = promise->get_future();
+
+  if (!submitPacket(packet, [promise](bool success) { promise->set_value(success); }))
+  {
+    promise->set_value(false);
+  }
+  return result;
+}
+
+SVHTransmitQueueStatistics SVHSerialInterface::transmitQueueStatistics()
+{
+  SVHTransmitQueueStatistics statistics;
+  statistics.depth = 0;
+  for (size_t i = 0; i < SVH_PRIORITY_CLASSES; ++i)
+  {
+    statistics.written[i] = m_packets_written[i];
+    statistics.depth += m_transmit_queues[i]->size();
+  }
+  statistics.max_depth = m_max_queue_depth;
+  statistics.submitted = m_packets_submitted;
+  statistics.rejected  = m_packets_rejected;
+  statistics.flushed   = m_packets_flushed;
+  return statistics;
+}
+
+void SVHSerialInterface::setPriorityBudget(SVHTransmitPriority priority, double share)
+{
+  if (priority < 0 || priority >= SVH_PRIORITY_CLASSES || !(share > 0.0 && share <= 1.0))
+  {
+    SVH_LOG_WARN_STREAM("SVHSerialInterface",
+                        "Link budget " << share << " for priority " << priority
+                                       << " is invalid - ignoring request");
+    return;
+  }
+  m_budget_shares[priority] = share;
+}
+
+SVHTransmitPriority SVHSerialInterface::transmitPriority(std::uint8_t address)
+{
+  // The command is encoded in the lower nibble, the channel in the upper one. Only requests may
+  // be overtaken. Every write shares one class, as the hand has to apply settings, state changes
+  // and targets in the order they were given.
+  switch (address & 0x0F)
+  {
+    case SVH_GET_CONTROL_FEEDBACK:
+    case SVH_GET_CONTROL_FEEDBACK_ALL:
+      return SVH_PRIORITY_FEEDBACK;
+    case SVH_GET_POSITION_SETTINGS:
+    case SVH_GET_CURRENT_SETTINGS:
+    case SVH_GET_CONTROLLER_STATE:
+    case SVH_GET_ENCODER_VALUES:
+    case SVH_GET_FIRMWARE_INFO:
+      return SVH_PRIORITY_BACKGROUND;
+    default:
+      return SVH_PRIORITY_COMMAND;
+  }
+}
 
-    m_packets_transmitted++;
+void SVHSerialInterface::refillBudgets(const std::chrono::steady_clock::time_point& now)
+{
+  const double elapsed = std::chrono::duration<double, std::micro>(now - m_budget_refill).count();
+  const double burst   = C_LINK_BUDGET_BURST * C_FRAME_SIZE / C_LINK_BYTES_PER_SECOND * 1.0e6;
+  m_budget_refill      = now;
+  for (size_t i = 0; i < SVH_PRIORITY_CLASSES; ++i)
+  {
+    m_budget_tokens[i] = std::min(burst, m_budget_tokens[i] + m_budget_shares[i] * elapsed);
   }
+}
+
+bool SVHSerialInterface::hasBudget(size_t priority) const
+{
+  // While stopping everything that is left is written as fast as possible
+  const double frame_time = C_FRAME_SIZE / C_LINK_BYTES_PER_SECOND * 1.0e6;
+  return !m_transmit_running || m_budget_shares[priority] >= 1.0 ||
+         m_budget_tokens[priority] >= frame_time;
+}
 
+size_t SVHSerialInterface::nextWritablePriority() const
+{
+  for (size_t i = 0; i < SVH_PRIORITY_CLASSES; ++i)
+  {
+    if (!m_transmit_queues[i]->empty() && hasBudget(i))
+    {
+      return i;
+    }
+  }
+  return SVH_PRIORITY_CLASSES;
+}
+
+bool SVHSerialInterface::transmitQueuesEmpty() const
+{
+  for (size_t i = 0; i < SVH_PRIORITY_CLASSES; ++i)
+  {
+    if (!m_transmit_queues[i]->empty())
+    {
+      return false;
+    }
+  }
   return true;
 }
 
+void SVHSerialInterface::writeQueuedPackets()
+{
+  const double frame_time = C_FRAME_SIZE / C_LINK_BYTES_PER_SECOND * 1.0e6;
+  TransmitRequest request;
+  while (true)
+  {
+    // The most urgent class that is within its budget goes first
+    refillBudgets(std::chrono::steady_clock::now());
+    const size_t priority = nextWritablePriority();
+    if (priority < SVH_PRIORITY_CLASSES && m_transmit_queues[priority]->pop(request))
+    {
+      if (request.generation != m_emergency_generation)
+      {
+        // Overtaken by an emergency packet, it must not be written after it anymore
+        m_packets_flushed++;
+        if (request.callback)
+        {
+          request.callback(false);
+        }
+        continue;
+      }
+
+      m_budget_tokens[priority] -= frame_time;
+      bool success = writePacket(request.packet, request.generation);
+      if (success)
+      {
+        m_packets_written[priority]++;
+      }
+      if (request.sent_index != NULL)
+      {
+        *request.sent_index = request.packet.index;
+      }
+      if (success && request.hold_off.count() > 0)
+      {
+        std::this_thread::sleep_for(request.hold_off);
+      }
+      if (request.callback)
+      {
+        request.callback(success);
+      }
+      continue;
+    }
+
+    if (!m_transmit_running && transmitQueuesEmpty())
+    {
+      // stop was requested and everything is written
+      break;
+    }
+
+    // Packets of throttled classes wait until the earliest budget has recovered
+    const std::chrono::steady_clock::time_point wake_up = budgetRecoveryTime();
+
+    // Announce the sleep before checking the queue again, so a producer either sees the flag or
+    // we see its packet
+    std::unique_lock<std::mutex> lock(m_transmit_wakeup_mutex);
+    m_writer_waiting = true;
+    if (wake_up == std::chrono::steady_clock::time_point::max())
+    {
+      // Any new packet wakes us up, the next loop run works out whether it can be written yet
+      m_transmit_wakeup_condition.wait(
+        lock, [this] { return !transmitQueuesEmpty() || !m_transmit_running; });
+    }
+    else
+    {
+      // Only the writer touches the budgets, so it can refill them while checking
+      m_transmit_wakeup_condition.wait_until(lock, wake_up, [this] {
+        refillBudgets(std::chrono::steady_clock::now());
+        return nextWritablePriority() < SVH_PRIORITY_CLASSES || !m_transmit_running;
+      });
+    }
+    m_writer_waiting = false;
+  }
+}
+
+void SVHSerialInterface::setTransmitWindow(unsigned int window,
+                                           const std::chrono::microseconds& acknowledge_timeout)
+{
+  std::lock_guard<std::mutex> lock(m_transmit_window_mutex);
+  if (window > C_MAX_TRANSMIT_WINDOW)
+  {
+    SVH_LOG_WARN_STREAM("SVHSerialInterface",
+                        "Transmit window of " << window << " packets is too large, using "
+                                              << C_MAX_TRANSMIT_WINDOW);
+    window = C_MAX_TRANSMIT_WINDOW;
+  }
+  m_transmit_window     = window;
+  m_acknowledge_timeout = acknowledge_timeout;
+  m_in_flight.clear();
+  m_transmit_window_condition.notify_all();
+}
+
+unsigned int SVHSerialInterface::unacknowledgedPacketCount()
+{
+  std::lock_guard<std::mutex> lock(m_transmit_window_mutex);
+  return m_packets_unacknowledged;
+}
+
+void SVHSerialInterface::waitForTransmitSlot()
+{
+  std::unique_lock<std::mutex> lock(m_transmit_window_mutex);
+  while (m_transmit_window > 0 && m_in_flight.size() >= m_transmit_window)
+  {
+    // The oldest packet is the first one to time out
+    auto deadline = m_in_flight.front().sent + m_acknowledge_timeout;
+    if (std::chrono::steady_clock::now() >= deadline)
+    {
+      expireTransmitSlots(deadline);
+      continue;
+    }
+    m_transmit_window_condition.wait_until(lock, deadline);
+  }
+}
+
+bool SVHSerialInterface::hasTransmitSlot()
+{
+  std::lock_guard<std::mutex> lock(m_transmit_window_mutex);
+  expireTransmitSlots(std::chrono::steady_clock::now());
+  return m_transmit_window == 0 || m_in_flight.size() < m_transmit_window;
+}
+
+void SVHSerialInterface::expireTransmitSlots(const std::chrono::steady_clock::time_point& now)
+{
+  // Packets are ordered by send time, so the expired ones are at the front
+  while (!m_in_flight.empty() && now >= m_in_flight.front().sent + m_acknowledge_timeout)
+  {
+    SVH_LOG_DEBUG_STREAM("SVHSerialInterface",
+                         "Packet with index " << static_cast<int>(m_in_flight.front().index)
+                                              << " was not acknowledged in time");
+    m_in_flight.erase(m_in_flight.begin());
+    m_packets_unacknowledged++;
+  }
+}
+
+void SVHSerialInterface::registerTransmitSlot(std::uint8_t index)
+{
+  std::lock_guard<std::mutex> lock(m_transmit_window_mutex);
+  InFlightPacket in_flight = {index, std::chrono::steady_clock::now()};
+  m_in_flight.push_back(in_flight);
+}
+
+void SVHSerialInterface::releaseTransmitSlot(std::uint8_t index)
+{
+  std::lock_guard<std::mutex> lock(m_transmit_window_mutex);
+  for (std::vector<InFlightPacket>::iterator it = m_in_flight.begin(); it != m_in_flight.end();
+       ++it)
+  {
+    if (it->index == index)
+    {
+      m_in_flight.erase(it);
+      m_transmit_window_condition.notify_all();
+      break;
+    }
+  }
+}
+
 void SVHSerialInterface::resetTransmitPackageCount()
 {
   m_packets_transmitted = 0;
+  {
+    // Indices start over, so old entries could be mistaken for new ones
+    std::lock_guard<std::mutex> lock(m_transmit_window_mutex);
+    m_in_flight.clear();
+    m_transmit_window_condition.notify_all();
+  }
   // Only the receive thread knows abotu the accurate number it has received
   m_svh_receiver->resetReceivedPackageCount();
 }
@@ -226,7 +992,11 @@ void SVHSerialInterface::receivedPacketCallback(const SVHSerialPacket& packet,
                                                 unsigned int packet_count)
 {
   m_last_index = packet.index;
-  m_received_packet_callback(packet, packet_count);
+  releaseTransmitSlot(packet.index);
+  if (m_received_packet_callback)
+  {
+    m_received_packet_callback(packet, packet_count);
+  }
 }
 
 } // namespace driver_svh
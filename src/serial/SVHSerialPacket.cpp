@@ -35,8 +35,43 @@
 //----------------------------------------------------------------------
 #include <schunk_svh_library/serial/SVHSerialPacket.h>
 
+#include <algorithm>
+
 namespace driver_svh {
 
+SVHFixedSerialPacket::SVHFixedSerialPacket(const SVHSerialPacket& packet)
+  : index(packet.index)
+  , address(packet.address)
+  , data()
+{
+  std::copy(packet.data.begin(),
+            packet.data.begin() + std::min(packet.data.size(), data.size()),
+            data.begin());
+}
+
+void encodeFrame(const SVHFixedSerialPacket& packet, SVHSerialFrame& frame)
+{
+  frame[0] = PACKET_HEADER1;
+  frame[1] = PACKET_HEADER2;
+  frame[2] = packet.index;
+  frame[3] = packet.address;
+  // length is transmitted in little endian
+  frame[4] = static_cast<std::uint8_t>(C_PACKET_DATA_SIZE & 0xFF);
+  frame[5] = static_cast<std::uint8_t>(C_PACKET_DATA_SIZE >> 8);
+
+  std::uint8_t check_sum1 = 0;
+  std::uint8_t check_sum2 = 0;
+  for (size_t i = 0; i < C_PACKET_DATA_SIZE; ++i)
+  {
+    frame[6 + i] = packet.data[i];
+    check_sum1 += packet.data[i];
+    check_sum2 ^= packet.data[i];
+  }
+
+  frame[C_FRAME_SIZE - 2] = check_sum1;
+  frame[C_FRAME_SIZE - 1] = check_sum2;
+}
+
 driver_svh::ArrayBuilder& operator<<(driver_svh::ArrayBuilder& ab, const SVHSerialPacket& data)
 {
   ab << data.index << data.address << static_cast<uint16_t>(data.data.size()) << data.data;
@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * This file contains the helpers that apply the scheduling settings to the
+ * driver threads and collect the settings that could not be applied.
+ */
+//----------------------------------------------------------------------
+#include <schunk_svh_library/Logger.h>
+#include <schunk_svh_library/serial/SVHThreadConfig.h>
+
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <memory>
+
+#ifdef _SYSTEM_LINUX_
+#  include <alloca.h>
+#  include <pthread.h>
+#  include <sched.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace driver_svh {
+
+namespace {
+
+#ifdef _SYSTEM_LINUX_
+//! touches every page of the given amount of stack below the caller, so it is mapped afterwards
+void prefaultStack(size_t size)
+{
+  const size_t page_size         = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  volatile unsigned char* buffer = static_cast<unsigned char*>(alloca(size));
+  for (size_t i = 0; i < size; i += page_size)
+  {
+    buffer[i] = 0;
+  }
+}
+#endif
+
+} // namespace
+
+SVHThreadSetup::SVHThreadSetup()
+  : m_stack_prefault(0)
+{
+}
+
+std::thread SVHThreadSetup::start(const SVHThreadSettings& settings,
+                                  const std::function<void()>& body)
+{
+  // The promise is shared, the thread may still be inside set_value() when we return
+  std::shared_ptr<std::promise<void> > applied = std::make_shared<std::promise<void> >();
+  std::future<void> done                       = applied->get_future();
+  std::thread thread([this, settings, body, applied] {
+    apply(settings);
+    applied->set_value();
+    body();
+  });
+  done.wait();
+  return thread;
+}
+
+void SVHThreadSetup::apply(const SVHThreadSettings& settings)
+{
+  const std::string thread = settings.name.empty() ? "unnamed" : settings.name;
+#ifdef _SYSTEM_LINUX_
+  if (!settings.name.empty())
+  {
+    // The kernel keeps at most 15 characters and the terminating zero
+    int error = pthread_setname_np(pthread_self(), settings.name.substr(0, 15).c_str());
+    if (error != 0)
+    {
+      fail(thread, "name", error);
+    }
+  }
+
+  if (!settings.cpus.empty())
+  {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    int error = 0;
+    for (size_t i = 0; i < settings.cpus.size(); ++i)
+    {
+      if (settings.cpus[i] < 0 || settings.cpus[i] >= CPU_SETSIZE)
+      {
+        error = EINVAL;
+        break;
+      }
+      CPU_SET(settings.cpus[i], &cpus);
+    }
+    if (error == 0)
+    {
+      error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+    if (error != 0)
+    {
+      fail(thread, "affinity", error);
+    }
+  }
+
+  if (settings.policy != C_THREAD_POLICY_INHERIT)
+  {
+    sched_param param;
+    param.sched_priority = settings.priority;
+    int error            = pthread_setschedparam(pthread_self(), settings.policy, &param);
+    if (error != 0)
+    {
+      fail(thread, "policy", error);
+    }
+  }
+
+  if (m_stack_prefault > C_MAX_STACK_PREFAULT)
+  {
+    fail(thread, "stack_prefault", EINVAL);
+  }
+  else if (m_stack_prefault > 0)
+  {
+    prefaultStack(m_stack_prefault);
+  }
+#else
+  // Without pthreads none of the settings can be applied
+  if (!settings.name.empty())
+  {
+    fail(thread, "name", ENOSYS);
+  }
+  if (!settings.cpus.empty())
+  {
+    fail(thread, "affinity", ENOSYS);
+  }
+  if (settings.policy != C_THREAD_POLICY_INHERIT)
+  {
+    fail(thread, "policy", ENOSYS);
+  }
+  if (m_stack_prefault > 0)
+  {
+    fail(thread, "stack_prefault", ENOSYS);
+  }
+#endif
+}
+
+bool SVHThreadSetup::lockMemory()
+{
+#ifdef _SYSTEM_LINUX_
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+  {
+    return true;
+  }
+  fail("", "lock_memory", errno);
+#else
+  fail("", "lock_memory", ENOSYS);
+#endif
+  return false;
+}
+
+std::vector<SVHThreadSetupFailure> SVHThreadSetup::failures() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_failures;
+}
+
+void SVHThreadSetup::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_failures.clear();
+}
+
+void SVHThreadSetup::fail(const std::string& thread, const std::string& setting, int error)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (size_t i = 0; i < m_failures.size(); ++i)
+  {
+    if (m_failures[i].thread == thread && m_failures[i].setting == setting &&
+        m_failures[i].error == error)
+    {
+      // Restarted threads fail the same way again
+      return;
+    }
+  }
+
+  SVHThreadSetupFailure failure = {thread, setting, error};
+  m_failures.push_back(failure);
+  SVH_LOG_WARN_STREAM("SVHThreadSetup",
+                      "Could not apply " << setting << (thread.empty() ? "" : " to thread ")
+                                         << thread << ": " << strerror(error));
+}
+
+} // namespace driver_svh
@@ -489,6 +489,33 @@ ssize_t Serial::write(const void* data, ssize_t size)
 #endif
 }
 
+ssize_t Serial::readAvailable(void* data, ssize_t size)
+{
+#if defined _SYSTEM_LINUX_
+  if (m_file_descr < 0)
+    return m_status;
+
+  // The device is opened non blocking, so this is a single system call
+  ssize_t bytes_read = ::read(m_file_descr, data, size);
+  if (bytes_read < 0)
+  {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+      return 0;
+    }
+    m_status = -errno;
+    SVH_LOG_DEBUG_STREAM("Serial",
+                         "Error on reading '" << m_dev_name << "'. Status (" << m_status << ":"
+                                              << strerror(-m_status) << ")");
+    return m_status;
+  }
+  m_status = 0;
+  return bytes_read;
+#else
+  return read(data, size, 0);
+#endif
+}
+
 ssize_t Serial::read(void* data, ssize_t size, unsigned long time, bool return_on_less_data)
 {
   // tTime end_time = tTime().FutureUSec(time);
@@ -156,5 +156,35 @@ BOOST_AUTO_TEST_CASE(ReadBackTest)
   BOOST_CHECK_EQUAL(size, size_peek);
 }
 
+BOOST_AUTO_TEST_CASE(LittleEndianWireFormat)
+{
+  // The wire format has to be little endian regardless of the host
+  ArrayBuilder ab(0);
+  ab << static_cast<u_int32_t>(0x11223344) << static_cast<int16_t>(-2) << 1.0f;
+
+  const u_int8_t expected[] = {0x44, 0x33, 0x22, 0x11, 0xFE, 0xFF, 0x00, 0x00, 0x80, 0x3F};
+  std::vector<u_int8_t> expected_bytes(expected, expected + sizeof(expected));
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    ab.array.begin(), ab.array.end(), expected_bytes.begin(), expected_bytes.end());
+
+  BOOST_CHECK_EQUAL(driver_svh::byteSwap(static_cast<u_int16_t>(0x1122)), 0x2211);
+  BOOST_CHECK_EQUAL(driver_svh::byteSwap(static_cast<u_int32_t>(0x11223344)), 0x44332211u);
+  BOOST_CHECK_EQUAL(driver_svh::byteSwap(static_cast<u_int64_t>(0x1122334455667788ull)),
+                    0x8877665544332211ull);
+  BOOST_CHECK_EQUAL(driver_svh::readLittleEndian<int16_t>(&ab.array[4]), -2);
+}
+
+BOOST_AUTO_TEST_CASE(ReserveAvoidsReallocation)
+{
+  ArrayBuilder ab(0);
+  ab.reserve(64);
+  const u_int8_t* data = ab.array.data();
+  for (int i = 0; i < 16; ++i)
+  {
+    ab << static_cast<float>(i);
+  }
+  BOOST_CHECK_EQUAL(ab.array.size(), 64u);
+  BOOST_CHECK(ab.array.data() == data);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
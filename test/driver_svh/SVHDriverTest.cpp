@@ -41,6 +41,14 @@
 #include <schunk_svh_library/control/SVHPositionSettings.h>
 #include <schunk_svh_library/serial/SVHSerialPacket.h>
 
+#include "SVHSimulatedHand.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <thread>
+
 using driver_svh::ArrayBuilder;
 using namespace driver_svh;
 
@@ -292,5 +300,252 @@ BOOST_AUTO_TEST_CASE(ControllerreceiveFeedback)
   std::cout << "Done" << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(ControllerReceiveFeedbackAllChannels)
+{
+  std::cout << "Controller receiving feedback Packet of all channels ....";
+
+  // Reset Array Builder
+  g_payload.reset(0);
+
+  // Create Structures
+  SVHController controller;
+  SVHSerialPacket test_serial_packet(64, SVH_GET_CONTROL_FEEDBACK_ALL);
+  SVHControllerFeedbackAllChannels test_feedback_in(SVHControllerFeedback(-100, 9),
+                                                    SVHControllerFeedback(1, -10),
+                                                    SVHControllerFeedback(200000, 11),
+                                                    SVHControllerFeedback(3, 12),
+                                                    SVHControllerFeedback(4, 13),
+                                                    SVHControllerFeedback(5, 14),
+                                                    SVHControllerFeedback(6, 15),
+                                                    SVHControllerFeedback(7, 16),
+                                                    SVHControllerFeedback(8, -17));
+  // Conversion
+  g_payload << test_feedback_in;
+  std::copy(g_payload.array.begin(), g_payload.array.end(), test_serial_packet.data.begin());
+
+  // Emulate received packet, decoded straight from the payload
+  controller.receivedPacketCallback(test_serial_packet, 1);
+
+  SVHControllerFeedbackAllChannels feedback_out;
+  controller.getControllerFeedbackAllChannels(feedback_out);
+  BOOST_CHECK_EQUAL(test_feedback_in, feedback_out);
+
+  // A truncated packet must not overwrite the last feedback
+  SVHSerialPacket truncated_packet(20, SVH_GET_CONTROL_FEEDBACK_ALL);
+  controller.receivedPacketCallback(truncated_packet, 2);
+  controller.getControllerFeedbackAllChannels(feedback_out);
+  BOOST_CHECK_EQUAL(test_feedback_in, feedback_out);
+
+  // Only the accepted packet counts as fresh feedback, the truncated one is not sequenced
+  BOOST_CHECK_EQUAL(controller.getControllerFeedbackSequence(SVH_PINKY), 1u);
+  BOOST_CHECK(controller.controllerFeedbackChangedSince(SVH_PINKY, 0));
+  BOOST_CHECK(!controller.controllerFeedbackChangedSince(SVH_PINKY, 1));
+  std::chrono::nanoseconds age;
+  BOOST_REQUIRE(controller.getControllerFeedbackAge(SVH_PINKY, age));
+  BOOST_CHECK(age >= std::chrono::nanoseconds(0));
+  BOOST_CHECK(age < std::chrono::seconds(10));
+  BOOST_CHECK(!controller.getControllerFeedbackAge(SVH_ALL, age));
+
+  std::cout << "Done" << std::endl;
+}
+
+BOOST_AUTO_TEST_CASE(FingerManagerResetGroups)
+{
+  SVHFingerManager finger_manager;
+
+  std::vector<std::vector<SVHChannel> > groups;
+  groups.push_back({SVH_FINGER_SPREAD});
+  groups.push_back({SVH_INDEX_FINGER_PROXIMAL, SVH_MIDDLE_FINGER_PROXIMAL, SVH_RING_FINGER});
+  BOOST_CHECK(finger_manager.setResetGroups(groups));
+
+  // A channel may only be part of one group
+  groups.push_back({SVH_PINKY, SVH_RING_FINGER});
+  BOOST_CHECK(!finger_manager.setResetGroups(groups));
+
+  groups.back() = {SVH_PINKY, SVH_DIMENSION};
+  BOOST_CHECK(!finger_manager.setResetGroups(groups));
+
+  BOOST_CHECK(finger_manager.setResetGroups(std::vector<std::vector<SVHChannel> >()));
+
+  // Without a hand nothing is homed, grouped or not
+  BOOST_CHECK(!finger_manager.resetChannel(SVH_ALL));
+}
+
+BOOST_AUTO_TEST_CASE(FingerManagerHomesGroupsConcurrently)
+{
+  SVHSimulatedHand hand;
+  // The pinky is blocked on its first attempt, the ring finger on every attempt
+  hand.setStalls(SVH_PINKY, 1);
+  hand.setStalls(SVH_RING_FINGER, 10);
+
+  SVHFingerManager finger_manager;
+  finger_manager.setHomingTimeout(1);
+  BOOST_REQUIRE(finger_manager.connect(hand.slaveName()));
+  BOOST_REQUIRE(finger_manager.setResetGroups(
+    {{SVH_FINGER_SPREAD},
+     {SVH_THUMB_OPPOSITION, SVH_INDEX_FINGER_PROXIMAL, SVH_MIDDLE_FINGER_PROXIMAL},
+     {SVH_THUMB_FLEXION,
+      SVH_INDEX_FINGER_DISTAL,
+      SVH_MIDDLE_FINGER_DISTAL,
+      SVH_RING_FINGER,
+      SVH_PINKY}}));
+
+  BOOST_CHECK(!finger_manager.resetChannel(SVH_ALL));
+
+  // The channels of a group are driven together with frames for all channels
+  BOOST_CHECK_EQUAL(hand.receivedCount(SVH_SET_CONTROL_COMMAND), 0u);
+  BOOST_CHECK_GT(hand.receivedCount(SVH_SET_CONTROL_COMMAND_ALL), 0u);
+
+  // A blocked channel times out on its own, only the failed channels are retried
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    const SVHChannel channel = static_cast<SVHChannel>(i);
+    if (channel == SVH_RING_FINGER)
+    {
+      BOOST_CHECK(!finger_manager.isHomed(channel));
+      BOOST_CHECK_EQUAL(hand.drives(channel), 3u);
+    }
+    else
+    {
+      BOOST_CHECK_MESSAGE(finger_manager.isHomed(channel), "channel " << channel);
+      BOOST_CHECK_EQUAL(hand.drives(channel), channel == SVH_PINKY ? 2u : 1u);
+    }
+  }
+
+  finger_manager.disconnect();
+}
+
+BOOST_AUTO_TEST_CASE(FingerManagerHomingCalibration)
+{
+  SVHFingerManager finger_manager;
+  const std::string file_name = "test_homing_calibration.bin";
+
+  // Nothing is saved before all channels are homed
+  BOOST_CHECK(!finger_manager.saveHomingCalibration(file_name));
+  BOOST_CHECK(!std::ifstream(file_name.c_str()).good());
+
+  // A calibration can only be verified against a connected hand
+  std::ofstream(file_name.c_str(), std::ios::binary) << "garbage";
+  BOOST_CHECK(!finger_manager.loadHomingCalibration(file_name));
+  finger_manager.setHomingCalibrationCache(file_name);
+  BOOST_CHECK(!finger_manager.resetChannel(SVH_ALL));
+  std::remove(file_name.c_str());
+
+  // Homing a simulated hand saves the calibration
+  SVHSimulatedHand hand;
+  std::vector<double> positions(SVH_DIMENSION, 0.0);
+  {
+    SVHFingerManager homed;
+    BOOST_REQUIRE(homed.connect(hand.slaveName()));
+    homed.setHomingCalibrationCache(file_name);
+    BOOST_REQUIRE(homed.resetChannel(SVH_ALL));
+    BOOST_REQUIRE(std::ifstream(file_name.c_str()).good());
+
+    // The file is updated with the positions the fingers moved to afterwards on disconnect
+    BOOST_REQUIRE(homed.setTargetPosition(SVH_PINKY, 0.5, 0.0));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    for (size_t i = 0; i < SVH_DIMENSION; ++i)
+    {
+      BOOST_REQUIRE(homed.getPosition(static_cast<SVHChannel>(i), positions[i]));
+    }
+    BOOST_CHECK_CLOSE(positions[SVH_PINKY], 0.5, 1.0);
+    homed.disconnect();
+  }
+
+  // Not even the hand can be identified while the caller pumps the communication
+  {
+    SVHFingerManager pumped;
+    BOOST_REQUIRE(pumped.connect(hand.slaveName()));
+    BOOST_REQUIRE(pumped.setPumpMode(true));
+    BOOST_CHECK(!pumped.loadHomingCalibration(file_name));
+    BOOST_CHECK(!pumped.isHomed(SVH_PINKY));
+    pumped.disconnect();
+  }
+
+  // Intact encoders of the same hand make homing unnecessary, also if it answers slowly
+  hand.setFirmwareDelay(std::chrono::milliseconds(300));
+  {
+    SVHFingerManager restored;
+    BOOST_REQUIRE(restored.connect(hand.slaveName()));
+    BOOST_CHECK(restored.loadHomingCalibration(file_name));
+    for (size_t i = 0; i < SVH_DIMENSION; ++i)
+    {
+      double position = 0.0;
+      BOOST_CHECK(restored.isHomed(static_cast<SVHChannel>(i)));
+      BOOST_CHECK(restored.getPosition(static_cast<SVHChannel>(i), position));
+      BOOST_CHECK_SMALL(position - positions[i], 1.0e-6);
+    }
+    restored.disconnect();
+  }
+  hand.setFirmwareDelay(std::chrono::milliseconds(0));
+
+  // The calibration belongs to one device and one firmware
+  const std::string link_name = "test_homing_calibration_device";
+  BOOST_REQUIRE_EQUAL(::symlink(hand.slaveName().c_str(), link_name.c_str()), 0);
+  {
+    SVHFingerManager other_device;
+    BOOST_REQUIRE(other_device.connect(link_name));
+    BOOST_CHECK(!other_device.loadHomingCalibration(file_name));
+    BOOST_CHECK(!other_device.isHomed(SVH_PINKY));
+    other_device.disconnect();
+  }
+  ::unlink(link_name.c_str());
+
+  hand.setFirmware(2, 0);
+  {
+    SVHFingerManager other_firmware;
+    BOOST_REQUIRE(other_firmware.connect(hand.slaveName()));
+    BOOST_CHECK(!other_firmware.loadHomingCalibration(file_name));
+    other_firmware.disconnect();
+  }
+  hand.setFirmware(1, 0);
+
+  // After a power cycle every encoder reads zero. That lies within the cached soft limits but not
+  // at the saved positions.
+  hand.powerCycle();
+  {
+    SVHFingerManager power_cycled;
+    BOOST_REQUIRE(power_cycled.connect(hand.slaveName()));
+    BOOST_CHECK(!power_cycled.loadHomingCalibration(file_name));
+    BOOST_CHECK(!power_cycled.isHomed(SVH_PINKY));
+    power_cycled.disconnect();
+  }
+  std::remove(file_name.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(FingerManagerFeedbackPolling)
+{
+  SVHFingerManager finger_manager;
+
+  BOOST_CHECK(finger_manager.setFeedbackPollingRate(100.0));
+  BOOST_CHECK(finger_manager.setFeedbackPollingRate(C_FEEDBACK_POLLING_MAX_RATE));
+  BOOST_CHECK(!finger_manager.setFeedbackPollingRate(0.0));
+  BOOST_CHECK(!finger_manager.setFeedbackPollingRate(C_FEEDBACK_POLLING_MAX_RATE * 2.0));
+
+  // Nothing is polled, let alone skipped, without a hand
+  finger_manager.setAdaptiveFeedbackPolling(true);
+  BOOST_CHECK_EQUAL(finger_manager.getSkippedFeedbackPolls(), 0u);
+
+  // The reactor can be chosen before connecting
+  BOOST_CHECK(finger_manager.setReactor(std::make_shared<SVHReactor>()));
+  BOOST_CHECK(finger_manager.setReactor(NULL));
+}
+
+BOOST_AUTO_TEST_CASE(FingerManagerPollsAnIdleHandEveryPeriod)
+{
+  SVHSimulatedHand hand;
+  SVHFingerManager finger_manager;
+  BOOST_REQUIRE(finger_manager.setFeedbackPollingRate(100.0));
+  finger_manager.setAdaptiveFeedbackPolling(true);
+  BOOST_REQUIRE(finger_manager.connect(hand.slaveName()));
+
+  // The replies to the own polls must not make the next poll look unnecessary
+  const unsigned int polls = hand.receivedCount(SVH_GET_CONTROL_FEEDBACK_ALL);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  BOOST_CHECK_GE(hand.receivedCount(SVH_GET_CONTROL_FEEDBACK_ALL) - polls, 40u);
+  BOOST_CHECK_EQUAL(finger_manager.getSkippedFeedbackPolls(), 0u);
+
+  finger_manager.disconnect();
+}
 
 BOOST_AUTO_TEST_SUITE_END()
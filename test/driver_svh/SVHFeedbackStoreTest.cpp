@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * Tests of the lock-free feedback store.
+ */
+//----------------------------------------------------------------------
+#include <boost/test/unit_test.hpp>
+
+#include <schunk_svh_library/control/SVHFeedbackStore.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace driver_svh;
+
+BOOST_AUTO_TEST_SUITE(ts_SVHFeedbackStore)
+
+BOOST_AUTO_TEST_CASE(StoreAndLoad)
+{
+  SVHFeedbackStore store;
+  SVHControllerFeedback feedback(1, 1);
+  BOOST_REQUIRE(store.load(0, feedback));
+  BOOST_CHECK(feedback == SVHControllerFeedback(0, 0));
+
+  store.store(4, SVHControllerFeedback(-1234, 321), std::chrono::steady_clock::now());
+  BOOST_REQUIRE(store.load(4, feedback));
+  BOOST_CHECK(feedback == SVHControllerFeedback(-1234, 321));
+  BOOST_CHECK(!store.load(C_FEEDBACK_CHANNELS, feedback));
+
+  std::vector<SVHControllerFeedback> feedbacks;
+  for (int i = 0; i < 9; ++i)
+  {
+    feedbacks.push_back(SVHControllerFeedback(i * 100, static_cast<int16_t>(-i)));
+  }
+  store.storeAll(feedbacks, std::chrono::steady_clock::now());
+
+  const SVHFeedbackSnapshot snapshot = store.snapshot();
+  for (size_t i = 0; i < C_FEEDBACK_CHANNELS; ++i)
+  {
+    BOOST_CHECK(snapshot[i] == feedbacks[i]);
+  }
+
+  std::vector<SVHControllerFeedback> loaded;
+  store.loadAll(loaded);
+  BOOST_CHECK(loaded == feedbacks);
+}
+
+BOOST_AUTO_TEST_CASE(SequenceAndTimestamp)
+{
+  SVHFeedbackStore store;
+  SVHFeedbackSample sample;
+  BOOST_REQUIRE(store.load(2, sample));
+  BOOST_CHECK_EQUAL(sample.sequence, 0u);
+  BOOST_CHECK(!store.changedSince(2, 0));
+
+  const std::chrono::steady_clock::time_point first = std::chrono::steady_clock::now();
+  store.store(2, SVHControllerFeedback(10, 1), first);
+  BOOST_REQUIRE(store.load(2, sample));
+  BOOST_CHECK_EQUAL(sample.sequence, 1u);
+  BOOST_CHECK(sample.timestamp == first);
+  BOOST_CHECK(sample.feedback == SVHControllerFeedback(10, 1));
+  BOOST_CHECK(store.changedSince(2, 0));
+  BOOST_CHECK(!store.changedSince(2, 1));
+  BOOST_CHECK_EQUAL(store.sequence(3), 0u);
+
+  // An update of all channels counts for every channel
+  const std::chrono::steady_clock::time_point second = first + std::chrono::milliseconds(2);
+  store.storeAll(std::vector<SVHControllerFeedback>(C_FEEDBACK_CHANNELS), second);
+  BOOST_CHECK_EQUAL(store.sequence(2), 2u);
+  BOOST_CHECK_EQUAL(store.sequence(3), 1u);
+  BOOST_REQUIRE(store.load(3, sample));
+  BOOST_CHECK(sample.timestamp == second);
+  BOOST_CHECK_EQUAL(store.sequence(C_FEEDBACK_CHANNELS), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(WaitForUpdate)
+{
+  SVHFeedbackStore store;
+
+  // Nothing arrives, the wait has to time out at the deadline
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  BOOST_CHECK(!store.waitForUpdate(1, 0, start + std::chrono::milliseconds(20)));
+  BOOST_CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+  BOOST_CHECK(!store.waitForUpdate(C_FEEDBACK_CHANNELS, 0, start));
+
+  std::thread writer([&store] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    store.store(1, SVHControllerFeedback(5, 5), std::chrono::steady_clock::now());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    store.storeAll(std::vector<SVHControllerFeedback>(C_FEEDBACK_CHANNELS),
+                   std::chrono::steady_clock::now());
+  });
+
+  const std::chrono::steady_clock::time_point deadline =
+    std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  const SVHFeedbackSequences sequences = store.sequences();
+  BOOST_CHECK(store.waitForUpdate(1, 0, deadline));
+  BOOST_CHECK_EQUAL(store.sequence(1), 1u);
+  BOOST_CHECK(store.waitForAll(sequences, deadline));
+  BOOST_CHECK(std::chrono::steady_clock::now() < deadline);
+  for (size_t i = 0; i < C_FEEDBACK_CHANNELS; ++i)
+  {
+    BOOST_CHECK(store.changedSince(i, sequences[i]));
+  }
+  writer.join();
+
+  // Feedback that arrived before the wait started is not missed
+  BOOST_CHECK(store.waitForUpdate(1, 0, std::chrono::steady_clock::now()));
+}
+
+BOOST_AUTO_TEST_CASE(ReadersNeverSeeTornUpdates)
+{
+  SVHFeedbackStore store;
+  std::atomic<bool> running(true);
+  std::atomic<int> torn(0);
+
+  // Every update writes the same value to all channels, so a reader mixing two updates would see
+  // different values within one snapshot.
+  std::thread writer([&store, &running] {
+    std::vector<SVHControllerFeedback> feedbacks(C_FEEDBACK_CHANNELS);
+    for (int32_t value = 1; value < 200000; ++value)
+    {
+      for (size_t i = 0; i < feedbacks.size(); ++i)
+      {
+        feedbacks[i].position = value;
+        feedbacks[i].current  = static_cast<int16_t>(value);
+      }
+      store.storeAll(feedbacks, std::chrono::steady_clock::now());
+    }
+    running = false;
+  });
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 2; ++r)
+  {
+    readers.push_back(std::thread([&store, &running, &torn] {
+      while (running)
+      {
+        const SVHFeedbackSnapshot snapshot = store.snapshot();
+        for (size_t i = 0; i < snapshot.size(); ++i)
+        {
+          if (snapshot[i].position != snapshot[0].position ||
+              snapshot[i].current != static_cast<int16_t>(snapshot[0].position))
+          {
+            torn++;
+          }
+        }
+      }
+    }));
+  }
+
+  writer.join();
+  for (size_t r = 0; r < readers.size(); ++r)
+  {
+    readers[r].join();
+  }
+  BOOST_CHECK_EQUAL(torn.load(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,182 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * Tests of the compile time protocol codec against the ArrayBuilder serialization.
+ */
+//----------------------------------------------------------------------
+#include <boost/test/unit_test.hpp>
+
+#include <schunk_svh_library/control/SVHProtocolCodec.h>
+
+#include <vector>
+
+using namespace driver_svh;
+
+namespace {
+
+//! payload bytes of a request packet, truncated to the size written by the ArrayBuilder
+std::vector<std::uint8_t> payloadOf(const SVHFixedSerialPacket& packet, size_t size)
+{
+  return std::vector<std::uint8_t>(packet.data.begin(), packet.data.begin() + size);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ts_SVHProtocolCodec)
+
+BOOST_AUTO_TEST_CASE(PayloadSizes)
+{
+  BOOST_CHECK_EQUAL(SVHWireLayout<SVHNoPayload>::size(), 0u);
+  BOOST_CHECK_EQUAL(SVHWireLayout<SVHControlCommand>::size(), 4u);
+  BOOST_CHECK_EQUAL(SVHWireLayout<SVHControlCommandAllChannels>::size(), 36u);
+  BOOST_CHECK_EQUAL(SVHWireLayout<SVHControllerFeedback>::size(), 6u);
+  BOOST_CHECK_EQUAL(SVHWireLayout<SVHControllerFeedbackAllChannels>::size(), 54u);
+  BOOST_CHECK_EQUAL(SVHWireLayout<SVHPositionSettings>::size(), 40u);
+  BOOST_CHECK_EQUAL(SVHWireLayout<SVHCurrentSettings>::size(), 40u);
+  BOOST_CHECK_EQUAL(SVHWireLayout<SVHControllerState>::size(), 12u);
+  BOOST_CHECK_EQUAL(SVHWireLayout<SVHEncoderSettings>::size(), 36u);
+  BOOST_CHECK_EQUAL(SVHWireLayout<SVHFirmwareInfo>::size(), 56u);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeMatchesArrayBuilder)
+{
+  SVHPositionSettings position_settings(
+    -1.0f, 2.0f, 3.5f, 4.0f, 0.001f, -500.0f, 500.0f, 0.5f, 0.25f, 0.125f);
+  SVHFixedSerialPacket position_packet =
+    encodeRequest<SVH_SET_POSITION_SETTINGS>(position_settings, 3);
+  BOOST_CHECK_EQUAL(position_packet.address, SVH_SET_POSITION_SETTINGS | (3 << 4));
+  ArrayBuilder ab;
+  ab << position_settings;
+  BOOST_CHECK(payloadOf(position_packet, ab.array.size()) == ab.array);
+
+  SVHCurrentSettings current_settings(
+    -191.0f, 191.0f, 0.405f, 4e-6f, -300.0f, 300.0f, 0.707f, 0.0410f, -400.0f, 400.0f);
+  SVHFixedSerialPacket current_packet = encodeRequest<SVH_SET_CURRENT_SETTINGS>(current_settings);
+  ab.reset(0);
+  ab << current_settings;
+  BOOST_CHECK(payloadOf(current_packet, ab.array.size()) == ab.array);
+
+  SVHControllerState controller_state(0x001F, 0x001F, 0x0203, 0x0203, 0x0001, 0x0001);
+  SVHFixedSerialPacket state_packet = encodeRequest<SVH_SET_CONTROLLER_STATE>(controller_state);
+  ab.reset(0);
+  ab << controller_state;
+  BOOST_CHECK(payloadOf(state_packet, ab.array.size()) == ab.array);
+
+  SVHEncoderSettings encoder_settings;
+  encoder_settings.scalings = {1, 2, 3, 4, 5, 6, 7, 8, 0xFFFFFFFF};
+  SVHFixedSerialPacket encoder_packet = encodeRequest<SVH_SET_ENCODER_VALUES>(encoder_settings);
+  ab.reset(0);
+  ab << encoder_settings;
+  BOOST_CHECK(payloadOf(encoder_packet, ab.array.size()) == ab.array);
+
+  SVHFixedSerialPacket command_packet =
+    encodeRequest<SVH_SET_CONTROL_COMMAND>(SVHControlCommand(-12345), 8);
+  ab.reset(0);
+  ab << SVHControlCommand(-12345);
+  BOOST_CHECK_EQUAL(command_packet.address, SVH_SET_CONTROL_COMMAND | (8 << 4));
+  BOOST_CHECK(payloadOf(command_packet, ab.array.size()) == ab.array);
+
+  // Requests without payload keep the packet zero padded
+  SVHFixedSerialPacket request_packet = encodeRequest<SVH_GET_FIRMWARE_INFO>();
+  BOOST_CHECK_EQUAL(request_packet.address, SVH_GET_FIRMWARE_INFO);
+  for (size_t i = 0; i < request_packet.data.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(request_packet.data[i], 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DecodeMatchesArrayBuilder)
+{
+  SVHControllerFeedbackAllChannels feedback_all(SVHControllerFeedback(1, -1),
+                                                SVHControllerFeedback(2, -2),
+                                                SVHControllerFeedback(3, -3),
+                                                SVHControllerFeedback(4, -4),
+                                                SVHControllerFeedback(5, -5),
+                                                SVHControllerFeedback(6, -6),
+                                                SVHControllerFeedback(7, -7),
+                                                SVHControllerFeedback(8, -8),
+                                                SVHControllerFeedback(-9, 9));
+  ArrayBuilder ab;
+  ab << feedback_all;
+
+  std::vector<SVHControllerFeedback> feedbacks(9);
+  BOOST_REQUIRE(decodeResponse<SVH_GET_CONTROL_FEEDBACK_ALL>(ab.array, feedbacks));
+  BOOST_CHECK(feedbacks == feedback_all.feedbacks);
+
+  SVHControllerFeedback feedback;
+  BOOST_REQUIRE(decodeResponse<SVH_SET_CONTROL_COMMAND>(ab.array, feedback));
+  BOOST_CHECK_EQUAL(feedback.position, 1);
+
+  SVHFirmwareInfo firmware_info;
+  firmware_info.svh           = "SVH ";
+  firmware_info.version_major = 4;
+  firmware_info.version_minor = 2;
+  firmware_info.text          = std::string(48, 'x');
+  std::vector<std::uint8_t> firmware_payload(56, 0);
+  SVHWireLayout<SVHFirmwareInfo>::encode(firmware_info, firmware_payload.data());
+
+  SVHFirmwareInfo decoded;
+  BOOST_REQUIRE(decodeResponse<SVH_GET_FIRMWARE_INFO>(firmware_payload, decoded));
+  ab.reset(0);
+  ab.appendWithoutConversion(firmware_payload);
+  SVHFirmwareInfo expected;
+  ab >> expected;
+  BOOST_CHECK_EQUAL(decoded.svh, expected.svh);
+  BOOST_CHECK_EQUAL(decoded.version_major, 4);
+  BOOST_CHECK_EQUAL(decoded.version_minor, 2);
+  BOOST_CHECK_EQUAL(decoded.text, expected.text);
+
+  SVHPositionSettings position_settings(1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+  SVHFixedSerialPacket packet = encodeRequest<SVH_SET_POSITION_SETTINGS>(position_settings);
+  std::vector<std::uint8_t> payload(packet.data.begin(), packet.data.end());
+  SVHPositionSettings decoded_settings;
+  BOOST_REQUIRE(decodeResponse<SVH_SET_POSITION_SETTINGS>(payload, decoded_settings));
+  BOOST_CHECK(decoded_settings == position_settings);
+}
+
+BOOST_AUTO_TEST_CASE(TruncatedPayloadIsRejected)
+{
+  std::vector<std::uint8_t> payload(53, 0x5A);
+
+  std::vector<SVHControllerFeedback> feedbacks(9, SVHControllerFeedback(7, 7));
+  BOOST_CHECK(!decodeResponse<SVH_GET_CONTROL_FEEDBACK_ALL>(payload, feedbacks));
+  BOOST_CHECK(feedbacks[0] == SVHControllerFeedback(7, 7));
+
+  SVHControllerState state;
+  payload.resize(11);
+  BOOST_CHECK(!decodeResponse<SVH_GET_CONTROLLER_STATE>(payload, state));
+  BOOST_CHECK_EQUAL(state.pwm_fault, 0);
+
+  SVHControllerFeedback feedback(7, 7);
+  payload.resize(5);
+  BOOST_CHECK(!decodeResponse<SVH_GET_CONTROL_FEEDBACK>(payload, feedback));
+  BOOST_CHECK_EQUAL(feedback.position, 7);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
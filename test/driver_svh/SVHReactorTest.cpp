@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * Tests of the epoll based reactor that serves devices, timers and events.
+ */
+//----------------------------------------------------------------------
+#include <boost/test/unit_test.hpp>
+
+#include <schunk_svh_library/serial/SVHReactor.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+
+using namespace driver_svh;
+
+namespace {
+
+//! Waits until the counter reached the expected value or the timeout passed
+bool waitForCount(const std::atomic<int>& counter,
+                  int expected,
+                  const std::chrono::milliseconds& timeout)
+{
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (counter < expected && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return counter >= expected;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ts_SVHReactor)
+
+BOOST_AUTO_TEST_CASE(ReaderIsCalledWithData)
+{
+  SVHReactor reactor;
+  BOOST_REQUIRE(reactor.isRunning());
+
+  int fds[2];
+  BOOST_REQUIRE(::pipe(fds) == 0);
+  std::atomic<int> bytes(0);
+  std::atomic<bool> in_reactor(false);
+  const int id = reactor.addReader(fds[0], [&] {
+    char buffer[16];
+    ssize_t count = ::read(fds[0], buffer, sizeof(buffer));
+    bytes += static_cast<int>(count > 0 ? count : 0);
+    in_reactor = reactor.inReactorThread();
+  });
+  BOOST_REQUIRE(id >= 0);
+  BOOST_CHECK(!reactor.inReactorThread());
+
+  BOOST_REQUIRE(::write(fds[1], "abc", 3) == 3);
+  BOOST_CHECK(waitForCount(bytes, 3, std::chrono::milliseconds(100)));
+  BOOST_CHECK(in_reactor);
+
+  // Removed sources are not served anymore
+  reactor.remove(id);
+  BOOST_REQUIRE(::write(fds[1], "de", 2) == 2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  BOOST_CHECK_EQUAL(bytes.load(), 3);
+
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
+
+BOOST_AUTO_TEST_CASE(TimersExpireOnceOrPeriodically)
+{
+  SVHReactor reactor;
+  std::atomic<int> single(0);
+  std::atomic<int> periodic(0);
+  const int single_id   = reactor.addTimer([&single] { single++; });
+  const int periodic_id = reactor.addTimer([&periodic] { periodic++; });
+  BOOST_REQUIRE(single_id >= 0);
+  BOOST_REQUIRE(periodic_id >= 0);
+
+  // Disarmed until armed
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  BOOST_CHECK_EQUAL(single.load() + periodic.load(), 0);
+
+  const auto now = std::chrono::steady_clock::now();
+  BOOST_CHECK(reactor.armTimer(single_id, now + std::chrono::milliseconds(5)));
+  BOOST_CHECK(reactor.armTimer(periodic_id, now, std::chrono::milliseconds(2)));
+  BOOST_CHECK(waitForCount(periodic, 10, std::chrono::milliseconds(200)));
+  BOOST_CHECK_EQUAL(single.load(), 1);
+
+  BOOST_CHECK(reactor.disarmTimer(periodic_id));
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  const int stopped = periodic;
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  BOOST_CHECK_EQUAL(periodic.load(), stopped);
+
+  // Only timers can be armed
+  const int event_id = reactor.addEvent([] {});
+  BOOST_CHECK(!reactor.armTimer(event_id, now));
+}
+
+BOOST_AUTO_TEST_CASE(EventsMergeNotifications)
+{
+  SVHReactor reactor;
+  std::atomic<int> calls(0);
+  std::atomic<bool> release(false);
+  const int id = reactor.addEvent([&] {
+    calls++;
+    while (!release)
+    {
+      std::this_thread::yield();
+    }
+  });
+  BOOST_REQUIRE(id >= 0);
+
+  // Notifications during a running handler lead to a single further call
+  BOOST_CHECK(reactor.notify(id));
+  BOOST_REQUIRE(waitForCount(calls, 1, std::chrono::milliseconds(100)));
+  for (int i = 0; i < 5; ++i)
+  {
+    BOOST_CHECK(reactor.notify(id));
+  }
+  release = true;
+  BOOST_CHECK(waitForCount(calls, 2, std::chrono::milliseconds(100)));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  BOOST_CHECK_EQUAL(calls.load(), 2);
+  BOOST_CHECK(reactor.dispatchCount() >= 2u);
+
+  reactor.remove(id);
+  BOOST_CHECK(!reactor.notify(id));
+}
+
+BOOST_AUTO_TEST_CASE(RemoveWaitsForRunningHandler)
+{
+  SVHReactor reactor;
+  std::atomic<bool> running(false);
+  std::atomic<bool> finished(false);
+  const int id = reactor.addEvent([&] {
+    running = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    finished = true;
+  });
+  BOOST_REQUIRE(reactor.notify(id));
+  while (!running)
+  {
+    std::this_thread::yield();
+  }
+
+  reactor.remove(id);
+  BOOST_CHECK(finished);
+}
+
+BOOST_AUTO_TEST_CASE(PeriodicHandlersShareATimer)
+{
+  SVHReactor reactor;
+  std::atomic<int> first(0);
+  std::atomic<int> second(0);
+  std::atomic<int> other(0);
+  const int first_id  = reactor.addPeriodic(std::chrono::milliseconds(2), [&first] { first++; });
+  const int second_id = reactor.addPeriodic(std::chrono::milliseconds(2), [&second] { second++; });
+  const int other_id  = reactor.addPeriodic(std::chrono::milliseconds(3), [&other] { other++; });
+  BOOST_REQUIRE(first_id >= 0 && second_id >= 0 && other_id >= 0);
+  BOOST_CHECK_EQUAL(reactor.addPeriodic(std::chrono::microseconds(0), [] {}), -1);
+
+  // One timer per period
+  BOOST_CHECK_EQUAL(reactor.sourceCount(), 2u);
+  BOOST_CHECK(waitForCount(second, 10, std::chrono::milliseconds(200)));
+  BOOST_CHECK(waitForCount(other, 5, std::chrono::milliseconds(200)));
+  BOOST_CHECK(first >= 9);
+
+  // The timer goes away with the last handler of its period
+  reactor.remove(first_id);
+  BOOST_CHECK_EQUAL(reactor.sourceCount(), 2u);
+  const int stopped = first;
+  reactor.remove(second_id);
+  BOOST_CHECK_EQUAL(reactor.sourceCount(), 1u);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  BOOST_CHECK_EQUAL(first.load(), stopped);
+
+  reactor.remove(other_id);
+  BOOST_CHECK_EQUAL(reactor.sourceCount(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(PoolHandsOutTheLeastUsedReactor)
+{
+  SVHReactorPool pool(2);
+  BOOST_CHECK_EQUAL(pool.size(), 2u);
+  BOOST_CHECK(pool.reactor(0)->isRunning());
+  BOOST_CHECK(pool.reactor(1)->isRunning());
+
+  std::shared_ptr<SVHReactor> first  = pool.acquire();
+  std::shared_ptr<SVHReactor> second = pool.acquire();
+  std::shared_ptr<SVHReactor> third  = pool.acquire();
+  BOOST_CHECK(first != second);
+  BOOST_CHECK(third == first);
+
+  // Released reactors are handed out again first
+  second.reset();
+  BOOST_CHECK(pool.acquire() != first);
+
+  // A pool always has a reactor
+  SVHReactorPool empty_pool(0);
+  BOOST_CHECK_EQUAL(empty_pool.size(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * Tests of the receive state machine. A pseudo terminal stands in for the
+ * serial device so that no hardware is needed.
+ */
+//----------------------------------------------------------------------
+#include <boost/test/unit_test.hpp>
+
+#include <schunk_svh_library/serial/ByteOrderConversion.h>
+#include <schunk_svh_library/serial/SVHReceiveThread.h>
+#include <schunk_svh_library/serial/SVHSerialPacket.h>
+#include <schunk_svh_library/serial/Serial.h>
+
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <memory>
+#include <stdlib.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace driver_svh;
+using driver_svh::serial::Serial;
+using driver_svh::serial::SerialFlags;
+
+namespace {
+
+//! Serializes a packet into its wire format including header and checksum
+std::vector<std::uint8_t> buildFrame(std::uint8_t index, std::uint8_t address, std::uint8_t value)
+{
+  SVHSerialPacket packet(64, address);
+  packet.index = index;
+  for (size_t i = 0; i < packet.data.size(); ++i)
+  {
+    packet.data[i] = static_cast<std::uint8_t>(value + i);
+  }
+
+  std::uint8_t check_sum1 = 0;
+  std::uint8_t check_sum2 = 0;
+  for (size_t i = 0; i < packet.data.size(); ++i)
+  {
+    check_sum1 += packet.data[i];
+    check_sum2 ^= packet.data[i];
+  }
+
+  ArrayBuilder ab(0);
+  ab << PACKET_HEADER1 << PACKET_HEADER2 << packet << check_sum1 << check_sum2;
+  return ab.array;
+}
+
+//! Master side of a pseudo terminal with the slave side opened as serial device
+struct PseudoTerminal
+{
+  int master;
+  std::shared_ptr<Serial> device;
+
+  PseudoTerminal()
+  {
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    grantpt(master);
+    unlockpt(master);
+    device = std::make_shared<Serial>(ptsname(master),
+                                      SerialFlags(SerialFlags::BR_921600, SerialFlags::DB_8));
+  }
+
+  ~PseudoTerminal()
+  {
+    device->close();
+    ::close(master);
+  }
+};
+
+//! Waits until \a count packets have arrived or a second has passed
+bool waitForPackets(const std::atomic<unsigned int>& received, unsigned int count)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (received < count && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return received >= count;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ts_SVHReceiveThread)
+
+BOOST_AUTO_TEST_CASE(ReceiveBurstOfFrames)
+{
+  PseudoTerminal pty;
+  BOOST_REQUIRE(pty.device->isOpen());
+
+  std::atomic<unsigned int> received{0};
+  std::vector<SVHSerialPacket> packets;
+  SVHReceiveThread receiver(std::chrono::microseconds(500),
+                            pty.device,
+                            [&](const SVHSerialPacket& packet, unsigned int packet_count) {
+                              packets.push_back(packet);
+                              received = packet_count;
+                            });
+  std::thread receive_thread([&] { receiver.run(); });
+
+  const std::chrono::steady_clock::time_point sent = std::chrono::steady_clock::now();
+  // Two frames with some garbage in front end up in the same read call
+  std::vector<std::uint8_t> stream = {0x00, 0x12, PACKET_HEADER1};
+  std::vector<std::uint8_t> frame1 = buildFrame(1, SVH_SET_CONTROL_COMMAND, 10);
+  std::vector<std::uint8_t> frame2 = buildFrame(2, SVH_GET_CONTROL_FEEDBACK_ALL, 20);
+  stream.insert(stream.end(), frame1.begin(), frame1.end());
+  stream.insert(stream.end(), frame2.begin(), frame2.end());
+  BOOST_REQUIRE_EQUAL(::write(pty.master, stream.data(), stream.size()),
+                      static_cast<ssize_t>(stream.size()));
+
+  BOOST_CHECK(waitForPackets(received, 2));
+
+  receiver.stop();
+  receive_thread.join();
+
+  BOOST_REQUIRE_EQUAL(packets.size(), 2u);
+  BOOST_CHECK_EQUAL(packets[0].index, 1);
+  BOOST_CHECK_EQUAL(packets[0].address, SVH_SET_CONTROL_COMMAND);
+  BOOST_CHECK_EQUAL(packets[0].data.size(), 64u);
+  BOOST_CHECK_EQUAL(packets[0].data[5], 15);
+  BOOST_CHECK_EQUAL(packets[1].index, 2);
+  BOOST_CHECK_EQUAL(packets[1].address, SVH_GET_CONTROL_FEEDBACK_ALL);
+  BOOST_CHECK_EQUAL(packets[1].data[63], 83);
+  BOOST_CHECK_EQUAL(receiver.receivedPacketCount(), 2u);
+
+  // Packets are stamped with the monotonic time they arrived
+  BOOST_CHECK(packets[0].timestamp >= sent);
+  BOOST_CHECK(packets[1].timestamp >= packets[0].timestamp);
+}
+
+BOOST_AUTO_TEST_CASE(OversizedLengthIsSkipped)
+{
+  PseudoTerminal pty;
+  BOOST_REQUIRE(pty.device->isOpen());
+
+  std::atomic<unsigned int> received{0};
+  std::vector<SVHSerialPacket> packets;
+  SVHReceiveThread receiver(std::chrono::microseconds(500),
+                            pty.device,
+                            [&](const SVHSerialPacket& packet, unsigned int packet_count) {
+                              packets.push_back(packet);
+                              received = packet_count;
+                            });
+  std::thread receive_thread([&] { receiver.run(); });
+
+  // A corrupted header announcing the largest possible payload must not swallow the next frame
+  std::vector<std::uint8_t> stream = {
+    PACKET_HEADER1, PACKET_HEADER2, 3, SVH_GET_CONTROL_FEEDBACK, 0xFF, 0xFF};
+  std::vector<std::uint8_t> frame = buildFrame(4, SVH_GET_CONTROL_FEEDBACK, 30);
+  stream.insert(stream.end(), frame.begin(), frame.end());
+  BOOST_REQUIRE_EQUAL(::write(pty.master, stream.data(), stream.size()),
+                      static_cast<ssize_t>(stream.size()));
+
+  BOOST_CHECK(waitForPackets(received, 1));
+
+  receiver.stop();
+  receive_thread.join();
+
+  BOOST_REQUIRE_EQUAL(packets.size(), 1u);
+  BOOST_CHECK_EQUAL(packets[0].index, 4);
+  BOOST_CHECK_EQUAL(packets[0].data.size(), 64u);
+  BOOST_CHECK_EQUAL(receiver.skippedPacketCount(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(EventDrivenReceive)
+{
+  PseudoTerminal pty;
+  BOOST_REQUIRE(pty.device->isOpen());
+
+  std::atomic<unsigned int> received{0};
+  SVHReceiveThread receiver(
+    pty.device, [&](const SVHSerialPacket&, unsigned int packet_count) {
+      received = packet_count;
+    });
+  std::thread receive_thread([&] { receiver.run(); });
+
+  std::vector<std::uint8_t> frame = buildFrame(7, SVH_GET_CONTROL_FEEDBACK, 0);
+  BOOST_REQUIRE_EQUAL(::write(pty.master, frame.data(), frame.size()),
+                      static_cast<ssize_t>(frame.size()));
+  BOOST_CHECK(waitForPackets(received, 1));
+
+  // The idle thread is blocked in poll() and has to be woken up by stop()
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  auto start = std::chrono::steady_clock::now();
+  receiver.stop();
+  receive_thread.join();
+  BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
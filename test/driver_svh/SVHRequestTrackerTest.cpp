@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * Tests of the request tracker used for pipelined request exchanges.
+ */
+//----------------------------------------------------------------------
+#include <boost/test/unit_test.hpp>
+
+#include <schunk_svh_library/control/SVHRequestTracker.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace driver_svh;
+
+namespace {
+
+SVHFixedSerialPacket makeRequest(std::uint8_t index, std::uint8_t address)
+{
+  SVHFixedSerialPacket packet(address);
+  packet.index = index;
+  return packet;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ts_SVHRequestTracker)
+
+BOOST_AUTO_TEST_CASE(MatchesIndexAndAddress)
+{
+  SVHRequestTracker tracker;
+  // Nothing is recorded before start()
+  tracker.track(makeRequest(0, 0x01));
+  BOOST_CHECK_EQUAL(tracker.pendingCount(), 0u);
+
+  tracker.start();
+  tracker.track(makeRequest(0, 0x01));
+  tracker.track(makeRequest(1, 0x13));
+  tracker.track(makeRequest(2, 0x14));
+  BOOST_CHECK_EQUAL(tracker.pendingCount(), 3u);
+  BOOST_CHECK(!tracker.waitForAll(std::chrono::microseconds(0)));
+
+  // Same index with another address is not an answer
+  BOOST_CHECK(!tracker.acknowledge(1, 0x14));
+  BOOST_CHECK(tracker.acknowledge(1, 0x13));
+  BOOST_CHECK(!tracker.acknowledge(1, 0x13));
+  BOOST_CHECK(tracker.acknowledge(0, 0x01));
+  BOOST_CHECK_EQUAL(tracker.acknowledgedCount(), 2u);
+  BOOST_CHECK_EQUAL(tracker.pendingCount(), 1u);
+
+  // Only the unanswered request is handed back
+  std::vector<SVHFixedSerialPacket> missing = tracker.takeUnacknowledged();
+  BOOST_REQUIRE_EQUAL(missing.size(), 1u);
+  BOOST_CHECK_EQUAL(missing[0].index, 2);
+  BOOST_CHECK_EQUAL(missing[0].address, 0x14);
+  BOOST_CHECK(tracker.waitForAll(std::chrono::microseconds(0)));
+
+  // Retransmitted with a new index
+  tracker.track(makeRequest(5, 0x14));
+  BOOST_CHECK(tracker.acknowledge(5, 0x14));
+  BOOST_CHECK(tracker.waitForAll(std::chrono::microseconds(0)));
+  BOOST_CHECK_EQUAL(tracker.acknowledgedCount(), 3u);
+
+  tracker.stop();
+  BOOST_CHECK(!tracker.acknowledge(5, 0x14));
+}
+
+BOOST_AUTO_TEST_CASE(ResponseBeforeRequestIsRecorded)
+{
+  SVHRequestTracker tracker;
+  tracker.start();
+  BOOST_CHECK(!tracker.acknowledge(7, 0x02));
+  tracker.track(makeRequest(7, 0x02));
+  BOOST_CHECK_EQUAL(tracker.pendingCount(), 0u);
+  BOOST_CHECK_EQUAL(tracker.acknowledgedCount(), 1u);
+  BOOST_CHECK(tracker.waitForAll(std::chrono::microseconds(0)));
+}
+
+BOOST_AUTO_TEST_CASE(WaitReturnsOnLastResponse)
+{
+  SVHRequestTracker tracker;
+  tracker.start();
+  for (std::uint8_t i = 0; i < 27; ++i)
+  {
+    tracker.track(makeRequest(i, 0x00));
+  }
+
+  std::thread responder([&tracker] {
+    for (std::uint8_t i = 0; i < 27; ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      tracker.acknowledge(i, 0x00);
+    }
+  });
+
+  // Returns long before the timeout once the last response arrived
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  BOOST_CHECK(tracker.waitForAll(std::chrono::seconds(5)));
+  BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+  responder.join();
+  BOOST_CHECK_EQUAL(tracker.acknowledgedCount(), 27u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
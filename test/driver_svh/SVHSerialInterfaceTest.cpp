@@ -0,0 +1,835 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * Tests of the transmit pacing of the serial interface. The master side of a
+ * pseudo terminal plays the hand and echoes or swallows the sent packets.
+ */
+//----------------------------------------------------------------------
+#include <boost/test/unit_test.hpp>
+
+#include <schunk_svh_library/control/SVHController.h>
+#include <schunk_svh_library/serial/SVHSerialInterface.h>
+#include <schunk_svh_library/serial/SVHSerialPacket.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace driver_svh;
+
+namespace {
+
+//! Master side of a pseudo terminal, the slave side is opened by the serial interface
+struct PseudoTerminalMaster
+{
+  int fd;
+  std::string slave_name;
+
+  PseudoTerminalMaster()
+  {
+    fd = posix_openpt(O_RDWR | O_NOCTTY);
+    grantpt(fd);
+    unlockpt(fd);
+    slave_name = ptsname(fd);
+  }
+
+  ~PseudoTerminalMaster() { ::close(fd); }
+};
+
+//! Plays the hand by writing everything back, which acknowledges each packet with its own index
+struct EchoHand
+{
+  std::atomic<bool> running;
+  std::thread thread;
+
+  explicit EchoHand(int fd)
+    : running(true)
+  {
+    thread = std::thread([this, fd] {
+      std::uint8_t buffer[256];
+      pollfd fds = {fd, POLLIN, 0};
+      while (running)
+      {
+        if (::poll(&fds, 1, 10) > 0 && (fds.revents & POLLIN))
+        {
+          ssize_t bytes = ::read(fd, buffer, sizeof(buffer));
+          if (bytes > 0 && ::write(fd, buffer, bytes) != bytes)
+          {
+            break;
+          }
+        }
+      }
+    });
+  }
+
+  ~EchoHand()
+  {
+    running = false;
+    thread.join();
+  }
+};
+
+//! Reads the addresses of all frames the hand receives within the timeout
+std::vector<std::uint8_t> receivedAddresses(int fd, const std::chrono::milliseconds& timeout)
+{
+  std::vector<std::uint8_t> bytes;
+  std::uint8_t buffer[256];
+  pollfd fds  = {fd, POLLIN, 0};
+  auto finish = std::chrono::steady_clock::now() + timeout;
+  while (std::chrono::steady_clock::now() < finish)
+  {
+    if (::poll(&fds, 1, 5) > 0 && (fds.revents & POLLIN))
+    {
+      ssize_t count = ::read(fd, buffer, sizeof(buffer));
+      if (count > 0)
+      {
+        bytes.insert(bytes.end(), buffer, buffer + count);
+      }
+    }
+  }
+
+  // Every frame has a fixed size of header, index, address, length, 64 bytes and checksums
+  std::vector<std::uint8_t> addresses;
+  for (size_t offset = 0; offset + 72 <= bytes.size(); offset += 72)
+  {
+    addresses.push_back(bytes[offset + 3]);
+  }
+  return addresses;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ts_SVHSerialInterface)
+
+BOOST_AUTO_TEST_CASE(FixedPacketFrameMatchesArrayBuilder)
+{
+  SVHSerialPacket packet(40, SVH_SET_CONTROL_COMMAND_ALL);
+  packet.index = 17;
+  ArrayBuilder payload(0);
+  for (int32_t i = 0; i < 9; ++i)
+  {
+    payload << static_cast<int32_t>(-1000 * i + 3);
+  }
+  std::copy(payload.array.begin(), payload.array.end(), packet.data.begin());
+
+  SVHFixedSerialPacket fixed_packet(SVH_SET_CONTROL_COMMAND_ALL);
+  fixed_packet.index = 17;
+  size_t offset      = 0;
+  for (int32_t i = 0; i < 9; ++i)
+  {
+    offset = fixed_packet.write(offset, static_cast<int32_t>(-1000 * i + 3));
+  }
+  BOOST_CHECK_EQUAL(offset, 36u);
+  BOOST_CHECK(SVHFixedSerialPacket(packet).data == fixed_packet.data);
+
+  // Reference encoding as it was done with the ArrayBuilder
+  packet.data.resize(C_PACKET_DATA_SIZE, 0);
+  std::uint8_t check_sum1 = 0;
+  std::uint8_t check_sum2 = 0;
+  for (size_t i = 0; i < packet.data.size(); ++i)
+  {
+    check_sum1 += packet.data[i];
+    check_sum2 ^= packet.data[i];
+  }
+  ArrayBuilder reference(0);
+  reference << PACKET_HEADER1 << PACKET_HEADER2 << packet << check_sum1 << check_sum2;
+
+  SVHSerialFrame frame;
+  encodeFrame(fixed_packet, frame);
+  BOOST_REQUIRE_EQUAL(reference.array.size(), frame.size());
+  BOOST_CHECK(std::equal(frame.begin(), frame.end(), reference.array.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(TransmitWindowTimesOutWithoutAcknowledgement)
+{
+  PseudoTerminalMaster pty;
+  SVHSerialInterface serial_interface(NULL);
+  BOOST_REQUIRE(serial_interface.connect(pty.slave_name));
+  serial_interface.setTransmitWindow(2, std::chrono::milliseconds(30));
+
+  SVHSerialPacket packet(0, SVH_GET_CONTROL_FEEDBACK);
+  auto start = std::chrono::steady_clock::now();
+  serial_interface.sendPacket(packet);
+  serial_interface.sendPacket(packet);
+  BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(30));
+
+  // The window is full and nobody answers, so the oldest packet has to time out first
+  serial_interface.sendPacket(packet);
+  BOOST_CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(30));
+  BOOST_CHECK_EQUAL(serial_interface.unacknowledgedPacketCount(), 1u);
+  BOOST_CHECK_EQUAL(serial_interface.transmittedPacketCount(), 3u);
+
+  serial_interface.close();
+}
+
+BOOST_AUTO_TEST_CASE(TransmitWindowFollowsAcknowledgements)
+{
+  PseudoTerminalMaster pty;
+  SVHSerialInterface serial_interface(NULL);
+  BOOST_REQUIRE(serial_interface.connect(pty.slave_name));
+  serial_interface.setTransmitWindow(1, std::chrono::seconds(1));
+
+  EchoHand hand(pty.fd);
+
+  SVHSerialPacket packet(0, SVH_GET_CONTROL_FEEDBACK);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < 20; ++i)
+  {
+    serial_interface.sendPacket(packet);
+    // The writer thread reports the index the packet was sent with
+    BOOST_CHECK_EQUAL(static_cast<size_t>(packet.index), i);
+  }
+  // Each packet waits for the echo of its predecessor, but never for the full timeout
+  BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+  BOOST_CHECK_EQUAL(serial_interface.unacknowledgedPacketCount(), 0u);
+
+  serial_interface.close();
+}
+
+BOOST_AUTO_TEST_CASE(TrackedRequestsArePipelined)
+{
+  PseudoTerminalMaster pty;
+  SVHController controller;
+  BOOST_REQUIRE(controller.connect(pty.slave_name));
+
+  // Without a hand nothing is answered and only the missing requests are sent again
+  controller.startRequestTracking();
+  controller.requestControllerFeedback(SVH_THUMB_FLEXION);
+  controller.requestControllerFeedback(SVH_PINKY);
+  BOOST_CHECK(!controller.waitForTrackedRequests(std::chrono::milliseconds(20)));
+  BOOST_CHECK_EQUAL(controller.getAcknowledgedRequestCount(), 0u);
+  BOOST_CHECK_EQUAL(controller.getPendingRequestCount(), 2u);
+
+  {
+    EchoHand hand(pty.fd);
+    // The retransmitted requests are answered now
+    BOOST_CHECK_EQUAL(controller.retransmitUnacknowledgedRequests(), 2u);
+    for (size_t i = 0; i < SVH_DIMENSION; ++i)
+    {
+      controller.requestControllerFeedback(static_cast<SVHChannel>(i));
+    }
+    auto start = std::chrono::steady_clock::now();
+    BOOST_CHECK(controller.waitForTrackedRequests(std::chrono::seconds(5)));
+    BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+    BOOST_CHECK_EQUAL(controller.getAcknowledgedRequestCount(), SVH_DIMENSION + 2u);
+  }
+
+  controller.stopRequestTracking();
+  controller.disconnect();
+}
+
+BOOST_AUTO_TEST_CASE(CommandsAreCoalesced)
+{
+  PseudoTerminalMaster pty;
+  SVHController controller;
+  BOOST_REQUIRE(controller.connect(pty.slave_name));
+
+  // Without any feedback the position of the other channels is unknown, a frame for all channels
+  // would drive them to tick 0. The batch is sent as single commands instead.
+  controller.beginCommandBatch();
+  controller.setControllerTarget(SVH_THUMB_FLEXION, 100);
+  controller.setControllerTarget(SVH_PINKY, 200);
+  controller.commitCommandBatch();
+  std::vector<std::uint8_t> addresses = receivedAddresses(pty.fd, std::chrono::milliseconds(50));
+  BOOST_REQUIRE_EQUAL(addresses.size(), 2u);
+  BOOST_CHECK_EQUAL(addresses[0], SVH_SET_CONTROL_COMMAND | (SVH_THUMB_FLEXION << 4));
+  BOOST_CHECK_EQUAL(addresses[1], SVH_SET_CONTROL_COMMAND | (SVH_PINKY << 4));
+  BOOST_CHECK_EQUAL(controller.getCoalescedCommandCount(), 0u);
+
+  // Without coalescing every target is its own frame
+  controller.setControllerTarget(SVH_THUMB_FLEXION, 100);
+  controller.setControllerTarget(SVH_PINKY, 200);
+  addresses = receivedAddresses(pty.fd, std::chrono::milliseconds(50));
+  BOOST_REQUIRE_EQUAL(addresses.size(), 2u);
+  BOOST_CHECK_EQUAL(addresses[0], SVH_SET_CONTROL_COMMAND | (SVH_THUMB_FLEXION << 4));
+  BOOST_CHECK_EQUAL(addresses[1], SVH_SET_CONTROL_COMMAND | (SVH_PINKY << 4));
+
+  // An explicit batch becomes a single frame for all channels
+  controller.beginCommandBatch();
+  for (int i = 0; i < SVH_DIMENSION; ++i)
+  {
+    controller.setControllerTarget(static_cast<SVHChannel>(i), i * 10);
+  }
+  BOOST_CHECK(receivedAddresses(pty.fd, std::chrono::milliseconds(20)).empty());
+  controller.commitCommandBatch();
+  addresses = receivedAddresses(pty.fd, std::chrono::milliseconds(50));
+  BOOST_REQUIRE_EQUAL(addresses.size(), 1u);
+  BOOST_CHECK_EQUAL(addresses[0], SVH_SET_CONTROL_COMMAND_ALL);
+  BOOST_CHECK_EQUAL(controller.getCoalescedCommandCount(), 9u);
+
+  // Targets within the window are merged, a lone target stays a single command
+  controller.setCommandCoalescing(std::chrono::milliseconds(5));
+  controller.setControllerTarget(SVH_RING_FINGER, 300);
+  controller.setControllerTarget(SVH_FINGER_SPREAD, 400);
+  addresses = receivedAddresses(pty.fd, std::chrono::milliseconds(50));
+  BOOST_REQUIRE_EQUAL(addresses.size(), 1u);
+  BOOST_CHECK_EQUAL(addresses[0], SVH_SET_CONTROL_COMMAND_ALL);
+  controller.setControllerTarget(SVH_RING_FINGER, 500);
+  addresses = receivedAddresses(pty.fd, std::chrono::milliseconds(50));
+  BOOST_REQUIRE_EQUAL(addresses.size(), 1u);
+  BOOST_CHECK_EQUAL(addresses[0], SVH_SET_CONTROL_COMMAND | (SVH_RING_FINGER << 4));
+  BOOST_CHECK_EQUAL(controller.getCoalescedCommandCount(), 11u);
+
+  controller.setCommandCoalescing(std::chrono::microseconds(0));
+  controller.disconnect();
+}
+
+BOOST_AUTO_TEST_CASE(RedundantCommandsAreSuppressed)
+{
+  PseudoTerminalMaster pty;
+  SVHController controller;
+  BOOST_REQUIRE(controller.connect(pty.slave_name));
+  controller.setCommandDeadband(10, std::chrono::milliseconds(60));
+
+  // The first target always goes out, targets within the deadband are dropped
+  controller.setControllerTarget(SVH_THUMB_FLEXION, 1000);
+  controller.setControllerTarget(SVH_THUMB_FLEXION, 1005);
+  controller.setControllerTarget(SVH_THUMB_FLEXION, 990);
+  controller.setControllerTarget(SVH_THUMB_FLEXION, 1011);
+  BOOST_CHECK_EQUAL(receivedAddresses(pty.fd, std::chrono::milliseconds(20)).size(), 2u);
+  BOOST_CHECK_EQUAL(controller.getSuppressedCommandCount(SVH_THUMB_FLEXION), 2u);
+
+  // Frames for all channels are only dropped if every channel is redundant
+  std::vector<int32_t> positions(SVH_DIMENSION, 0);
+  controller.setControllerTargetAllChannels(positions);
+  controller.setControllerTargetAllChannels(positions);
+  positions[SVH_PINKY] = 100;
+  controller.setControllerTargetAllChannels(positions);
+  BOOST_CHECK_EQUAL(receivedAddresses(pty.fd, std::chrono::milliseconds(20)).size(), 2u);
+  BOOST_CHECK_EQUAL(controller.getSuppressedCommandCount(SVH_PINKY), 1u);
+  BOOST_CHECK_EQUAL(controller.getSuppressedCommandCount(SVH_ALL), 2u + SVH_DIMENSION);
+
+  // The keepalive sends a redundant target once the last one is old enough
+  std::this_thread::sleep_for(std::chrono::milliseconds(80));
+  controller.setControllerTarget(SVH_PINKY, 100);
+  controller.setControllerTarget(SVH_PINKY, 100);
+  BOOST_CHECK_EQUAL(receivedAddresses(pty.fd, std::chrono::milliseconds(20)).size(), 1u);
+
+  // Forced targets, as repeated by the homing, are never dropped
+  controller.setControllerTarget(SVH_PINKY, 100, true);
+  controller.setControllerTarget(SVH_PINKY, 100, true);
+  controller.setControllerTargetAllChannels(positions, true);
+  BOOST_CHECK_EQUAL(receivedAddresses(pty.fd, std::chrono::milliseconds(20)).size(), 3u);
+
+  // Without the deadband everything is sent again
+  controller.setCommandDeadband(-1);
+  controller.setControllerTarget(SVH_PINKY, 100);
+  BOOST_CHECK_EQUAL(receivedAddresses(pty.fd, std::chrono::milliseconds(20)).size(), 1u);
+  BOOST_CHECK_EQUAL(controller.getSuppressedCommandCount(SVH_ALL), 3u + SVH_DIMENSION);
+
+  controller.disconnect();
+}
+
+BOOST_AUTO_TEST_CASE(PacketsAreScheduledByPriority)
+{
+  BOOST_CHECK_EQUAL(SVHSerialInterface::transmitPriority(SVH_SET_CONTROLLER_STATE),
+                    SVH_PRIORITY_COMMAND);
+  BOOST_CHECK_EQUAL(SVHSerialInterface::transmitPriority(SVH_SET_CONTROL_COMMAND | 0x30),
+                    SVH_PRIORITY_COMMAND);
+  BOOST_CHECK_EQUAL(SVHSerialInterface::transmitPriority(SVH_SET_POSITION_SETTINGS | 0x80),
+                    SVH_PRIORITY_COMMAND);
+  BOOST_CHECK_EQUAL(SVHSerialInterface::transmitPriority(SVH_GET_CONTROL_FEEDBACK_ALL),
+                    SVH_PRIORITY_FEEDBACK);
+  BOOST_CHECK_EQUAL(SVHSerialInterface::transmitPriority(SVH_GET_POSITION_SETTINGS | 0x80),
+                    SVH_PRIORITY_BACKGROUND);
+
+  PseudoTerminalMaster pty;
+  SVHSerialInterface serial_interface(NULL);
+  BOOST_REQUIRE(serial_interface.connect(pty.slave_name));
+  serial_interface.setPriorityBudget(SVH_PRIORITY_BACKGROUND, 0.1);
+
+  // Background traffic beyond its burst is throttled to a tenth of the link
+  SVHFixedSerialPacket settings(SVH_GET_POSITION_SETTINGS);
+  SVHFixedSerialPacket motion(SVH_SET_CONTROL_COMMAND_ALL);
+  const size_t background_count = 10;
+  for (size_t i = 0; i < background_count; ++i)
+  {
+    BOOST_CHECK(serial_interface.submitPacket(settings));
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::promise<void> written;
+  BOOST_CHECK(serial_interface.submitPacket(motion, [&written](bool) { written.set_value(); }));
+
+  // Commands overtake the queued background packets
+  BOOST_REQUIRE(written.get_future().wait_for(std::chrono::milliseconds(100)) ==
+                std::future_status::ready);
+  BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20));
+
+  std::vector<std::uint8_t> addresses = receivedAddresses(pty.fd, std::chrono::milliseconds(150));
+  BOOST_REQUIRE_EQUAL(addresses.size(), background_count + 1);
+  size_t motion_position =
+    std::find(addresses.begin(), addresses.end(), SVH_SET_CONTROL_COMMAND_ALL) - addresses.begin();
+  BOOST_CHECK(motion_position < C_LINK_BUDGET_BURST + 1);
+
+  SVHTransmitQueueStatistics statistics = serial_interface.transmitQueueStatistics();
+  BOOST_CHECK_EQUAL(statistics.written[SVH_PRIORITY_COMMAND], 1u);
+  BOOST_CHECK_EQUAL(statistics.written[SVH_PRIORITY_BACKGROUND], background_count);
+  BOOST_CHECK_EQUAL(statistics.depth, 0u);
+
+  serial_interface.close();
+}
+
+BOOST_AUTO_TEST_CASE(WritesKeepTheirOrder)
+{
+  PseudoTerminalMaster pty;
+  SVHSerialInterface serial_interface(NULL);
+  BOOST_REQUIRE(serial_interface.connect(pty.slave_name));
+
+  // Settings queued before an enable and a target have to reach the hand first, only the
+  // requests in between may be overtaken
+  const std::uint8_t sequence[] = {SVH_GET_POSITION_SETTINGS,
+                                   SVH_SET_POSITION_SETTINGS,
+                                   SVH_GET_CONTROL_FEEDBACK_ALL,
+                                   SVH_SET_CURRENT_SETTINGS,
+                                   SVH_SET_CONTROLLER_STATE,
+                                   SVH_GET_CONTROLLER_STATE,
+                                   SVH_SET_CONTROL_COMMAND_ALL,
+                                   SVH_SET_POSITION_SETTINGS};
+  for (size_t i = 0; i < sizeof(sequence); ++i)
+  {
+    BOOST_CHECK(serial_interface.submitPacket(SVHFixedSerialPacket(sequence[i])));
+  }
+
+  std::vector<std::uint8_t> addresses = receivedAddresses(pty.fd, std::chrono::milliseconds(100));
+  BOOST_REQUIRE_EQUAL(addresses.size(), sizeof(sequence));
+  std::vector<std::uint8_t> writes;
+  std::copy_if(addresses.begin(),
+               addresses.end(),
+               std::back_inserter(writes),
+               [](std::uint8_t address) {
+                 return SVHSerialInterface::transmitPriority(address) == SVH_PRIORITY_COMMAND;
+               });
+  const std::vector<std::uint8_t> expected = {SVH_SET_POSITION_SETTINGS,
+                                              SVH_SET_CURRENT_SETTINGS,
+                                              SVH_SET_CONTROLLER_STATE,
+                                              SVH_SET_CONTROL_COMMAND_ALL,
+                                              SVH_SET_POSITION_SETTINGS};
+  BOOST_CHECK(writes == expected);
+
+  serial_interface.close();
+}
+
+BOOST_AUTO_TEST_CASE(EmergencyPacketOvertakesQueuedTraffic)
+{
+  PseudoTerminalMaster pty;
+  SVHSerialInterface serial_interface(NULL);
+  BOOST_REQUIRE(serial_interface.connect(pty.slave_name));
+
+  // Without a transmit window every frame is paced, so the queue takes a while to drain
+  SVHFixedSerialPacket settings(SVH_GET_POSITION_SETTINGS);
+  const size_t queued_count = 30;
+  std::atomic<size_t> failed(0);
+  for (size_t i = 0; i < queued_count; ++i)
+  {
+    BOOST_CHECK(serial_interface.submitPacket(settings, [&failed](bool success) {
+      if (!success)
+      {
+        failed++;
+      }
+    }));
+  }
+
+  SVHFixedSerialPacket stop(SVH_SET_CONTROLLER_STATE);
+  auto start = std::chrono::steady_clock::now();
+  BOOST_CHECK(serial_interface.sendEmergencyPacket(stop));
+  BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(5));
+
+  // The stop is among the first frames and nothing that was queued before follows it
+  std::vector<std::uint8_t> addresses = receivedAddresses(pty.fd, std::chrono::milliseconds(100));
+  BOOST_REQUIRE(!addresses.empty());
+  BOOST_CHECK_EQUAL(addresses.back(), SVH_SET_CONTROLLER_STATE);
+  BOOST_CHECK(addresses.size() < 5);
+
+  SVHTransmitQueueStatistics statistics = serial_interface.transmitQueueStatistics();
+  BOOST_CHECK_EQUAL(statistics.flushed, queued_count + 1 - addresses.size());
+  BOOST_CHECK_EQUAL(failed.load(), static_cast<size_t>(statistics.flushed));
+  BOOST_CHECK_EQUAL(statistics.depth, 0u);
+
+  // The controller reports how long the stop took
+  serial_interface.close();
+  SVHController controller;
+  BOOST_REQUIRE(controller.connect(pty.slave_name));
+  controller.setAsynchronousTransmit(true);
+  for (size_t i = 0; i < SVH_DIMENSION; ++i)
+  {
+    controller.requestPositionSettings(static_cast<SVHChannel>(i));
+  }
+  controller.disableChannel(SVH_ALL);
+  BOOST_CHECK(controller.getEmergencyStopLatency() < std::chrono::milliseconds(5));
+  controller.disconnect();
+}
+
+BOOST_AUTO_TEST_CASE(PumpModeRunsWithoutThreads)
+{
+  PseudoTerminalMaster pty;
+  std::atomic<unsigned int> received(0);
+  SVHSerialInterface serial_interface(
+    [&received](const SVHSerialPacket&, unsigned int) { received++; });
+  serial_interface.setPumpMode(true);
+  BOOST_REQUIRE(serial_interface.connect(pty.slave_name));
+  EchoHand hand(pty.fd);
+
+  // Packets are only queued, nothing is written without pumping
+  SVHFixedSerialPacket packet(SVH_GET_CONTROL_FEEDBACK);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_CHECK(serial_interface.sendPacket(packet));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  BOOST_CHECK_EQUAL(serial_interface.transmittedPacketCount(), 0u);
+
+  // Without a transmit window one frame per call, the pacing delay postpones the next one
+  BOOST_CHECK_EQUAL(serial_interface.write(), 1u);
+  BOOST_CHECK_EQUAL(serial_interface.write(), 0u);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+  while (serial_interface.transmittedPacketCount() < 3 &&
+         std::chrono::steady_clock::now() < deadline)
+  {
+    serial_interface.write();
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  BOOST_CHECK_EQUAL(serial_interface.transmittedPacketCount(), 3u);
+
+  // The echoes are only dispatched by read()
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  BOOST_CHECK_EQUAL(received.load(), 0u);
+  deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+  while (received < 3 && std::chrono::steady_clock::now() < deadline)
+  {
+    serial_interface.read();
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  BOOST_CHECK_EQUAL(received.load(), 3u);
+
+  // Back to the own threads, sendPacket() returns once the packet was written
+  serial_interface.setPumpMode(false);
+  BOOST_CHECK(serial_interface.sendPacket(packet));
+  BOOST_CHECK_EQUAL(serial_interface.transmittedPacketCount(), 4u);
+  BOOST_CHECK_EQUAL(serial_interface.read(), 0u);
+  deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+  while (received < 4 && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_CHECK_EQUAL(received.load(), 4u);
+
+  serial_interface.close();
+}
+
+BOOST_AUTO_TEST_CASE(ReactorServesInterfacesWithoutOwnThreads)
+{
+  std::shared_ptr<SVHReactor> reactor = std::make_shared<SVHReactor>();
+  PseudoTerminalMaster pty;
+  std::atomic<unsigned int> received(0);
+  SVHSerialInterface serial_interface(
+    [&received](const SVHSerialPacket&, unsigned int) { received++; });
+  BOOST_CHECK(serial_interface.setReactor(reactor));
+  BOOST_REQUIRE(serial_interface.connect(pty.slave_name));
+  BOOST_CHECK(serial_interface.usesReactor());
+  BOOST_CHECK(!serial_interface.setReactor(NULL));
+  EchoHand hand(pty.fd);
+
+  // sendPacket() waits for the reactor to write the packet, the pacing is kept by its timer
+  SVHFixedSerialPacket packet(SVH_GET_CONTROL_FEEDBACK);
+  BOOST_CHECK(serial_interface.sendPacket(packet));
+  BOOST_CHECK_EQUAL(serial_interface.transmittedPacketCount(), 1u);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < 9; ++i)
+  {
+    BOOST_CHECK(serial_interface.submitPacket(packet));
+  }
+  auto deadline = start + std::chrono::milliseconds(200);
+  while (received < 10 && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_CHECK_EQUAL(serial_interface.transmittedPacketCount(), 10u);
+  BOOST_CHECK_EQUAL(received.load(), 10u);
+  BOOST_CHECK(std::chrono::steady_clock::now() - start >= std::chrono::microseconds(8 * 782));
+
+  // Acknowledgements read by the reactor open the transmit window
+  serial_interface.setTransmitWindow(2);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    BOOST_CHECK(serial_interface.submitPacket(packet));
+  }
+  deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+  while (received < 20 && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_CHECK_EQUAL(received.load(), 20u);
+  BOOST_CHECK_EQUAL(serial_interface.unacknowledgedPacketCount(), 0u);
+
+  serial_interface.close();
+  BOOST_CHECK(!serial_interface.usesReactor());
+  BOOST_CHECK(serial_interface.setReactor(NULL));
+}
+
+BOOST_AUTO_TEST_CASE(HandsShareOneReactor)
+{
+  std::shared_ptr<SVHReactor> reactor = std::make_shared<SVHReactor>();
+  const size_t hands                  = 3;
+  const unsigned int packets          = 10;
+
+  std::vector<std::unique_ptr<PseudoTerminalMaster> > ptys;
+  std::vector<std::unique_ptr<std::atomic<unsigned int> > > received;
+  std::vector<std::unique_ptr<EchoHand> > echo_hands;
+  std::vector<std::unique_ptr<SVHSerialInterface> > interfaces;
+  for (size_t i = 0; i < hands; ++i)
+  {
+    ptys.emplace_back(new PseudoTerminalMaster());
+    received.emplace_back(new std::atomic<unsigned int>(0));
+    std::atomic<unsigned int>* counter = received.back().get();
+    interfaces.emplace_back(new SVHSerialInterface(
+      [counter](const SVHSerialPacket&, unsigned int) { (*counter)++; }));
+    interfaces.back()->setReactor(reactor);
+    BOOST_REQUIRE(interfaces.back()->connect(ptys.back()->slave_name));
+    echo_hands.emplace_back(new EchoHand(ptys.back()->fd));
+  }
+
+  // Every hand adds its device, pacing timer and submit event to the same thread
+  BOOST_CHECK_EQUAL(reactor->sourceCount(), 3 * hands);
+
+  // Each hand sends from a thread of its own and only sees its own answers
+  std::vector<std::thread> senders;
+  for (size_t i = 0; i < hands; ++i)
+  {
+    SVHSerialInterface* serial_interface = interfaces[i].get();
+    senders.push_back(std::thread([serial_interface] {
+      SVHFixedSerialPacket packet(SVH_GET_CONTROL_FEEDBACK);
+      for (unsigned int p = 0; p < packets; ++p)
+      {
+        BOOST_CHECK(serial_interface->sendPacket(packet));
+      }
+    }));
+  }
+  for (size_t i = 0; i < senders.size(); ++i)
+  {
+    senders[i].join();
+  }
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+  for (size_t i = 0; i < hands; ++i)
+  {
+    while (*received[i] < packets && std::chrono::steady_clock::now() < deadline)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    BOOST_CHECK_EQUAL(interfaces[i]->transmittedPacketCount(), packets);
+    BOOST_CHECK_EQUAL(received[i]->load(), packets);
+  }
+
+  // Closing one hand leaves the others running
+  interfaces[0]->close();
+  BOOST_CHECK_EQUAL(reactor->sourceCount(), 3 * (hands - 1));
+  SVHFixedSerialPacket packet(SVH_GET_CONTROL_FEEDBACK);
+  BOOST_CHECK(interfaces[1]->sendPacket(packet));
+  BOOST_CHECK_EQUAL(interfaces[1]->transmittedPacketCount(), packets + 1);
+
+  for (size_t i = 1; i < hands; ++i)
+  {
+    interfaces[i]->close();
+  }
+  BOOST_CHECK_EQUAL(reactor->sourceCount(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(SubmitPacketCompletesInOrder)
+{
+  PseudoTerminalMaster pty;
+  EchoHand hand(pty.fd);
+  SVHSerialInterface serial_interface(NULL);
+
+  SVHSerialPacket packet(0, SVH_GET_CONTROL_FEEDBACK);
+  BOOST_CHECK(!serial_interface.submitPacket(packet));
+  BOOST_REQUIRE(serial_interface.connect(pty.slave_name));
+  serial_interface.setTransmitWindow(1, std::chrono::seconds(1));
+
+  std::vector<int> completed;
+  std::mutex completed_mutex;
+  for (int i = 0; i < 5; ++i)
+  {
+    BOOST_CHECK(serial_interface.submitPacket(packet, [&, i](bool success) {
+      std::lock_guard<std::mutex> lock(completed_mutex);
+      completed.push_back(success ? i : -1);
+    }));
+  }
+  std::future<bool> last = serial_interface.submitPacketAsync(packet);
+  BOOST_REQUIRE(last.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+  BOOST_CHECK(last.get());
+
+  {
+    std::lock_guard<std::mutex> lock(completed_mutex);
+    BOOST_CHECK_EQUAL(completed.size(), 5u);
+    for (size_t i = 0; i < completed.size(); ++i)
+    {
+      BOOST_CHECK_EQUAL(completed[i], static_cast<int>(i));
+    }
+  }
+
+  SVHTransmitQueueStatistics statistics = serial_interface.transmitQueueStatistics();
+  BOOST_CHECK_EQUAL(statistics.depth, 0u);
+  BOOST_CHECK_EQUAL(statistics.submitted, 6u);
+  BOOST_CHECK_EQUAL(statistics.rejected, 0u);
+  BOOST_CHECK(statistics.max_depth >= 1u);
+  BOOST_CHECK_EQUAL(serial_interface.transmittedPacketCount(), 6u);
+
+  serial_interface.close();
+  BOOST_CHECK(!serial_interface.submitPacket(packet));
+}
+
+BOOST_AUTO_TEST_CASE(SubmitPacketRejectsWhenQueueIsFull)
+{
+  PseudoTerminalMaster pty;
+  SVHSerialInterface serial_interface(NULL);
+  BOOST_REQUIRE(serial_interface.connect(pty.slave_name));
+  // Nobody answers, so the writer is stuck waiting for the first acknowledgement
+  serial_interface.setTransmitWindow(1, std::chrono::milliseconds(20));
+
+  SVHSerialPacket packet(0, SVH_GET_CONTROL_FEEDBACK);
+  unsigned int accepted = 0;
+  for (size_t i = 0; i < C_TRANSMIT_QUEUE_SIZE + 10; ++i)
+  {
+    if (serial_interface.submitPacket(packet))
+    {
+      accepted++;
+    }
+  }
+
+  SVHTransmitQueueStatistics statistics = serial_interface.transmitQueueStatistics();
+  BOOST_CHECK(statistics.rejected > 0u);
+  BOOST_CHECK_EQUAL(statistics.submitted, accepted);
+  BOOST_CHECK_EQUAL(statistics.submitted + statistics.rejected, C_TRANSMIT_QUEUE_SIZE + 10);
+  BOOST_CHECK(statistics.max_depth <= C_TRANSMIT_QUEUE_SIZE);
+
+  // Closing still writes everything that was accepted
+  serial_interface.close();
+  BOOST_CHECK_EQUAL(serial_interface.transmittedPacketCount(), accepted);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentSendersKeepFramesIntact)
+{
+  PseudoTerminalMaster pty;
+  SVHSerialInterface serial_interface(NULL);
+  BOOST_REQUIRE(serial_interface.connect(pty.slave_name));
+
+  const size_t threads            = 4;
+  const size_t packets_per_thread = 25;
+  const size_t frame_size         = 64 + C_PACKET_APPENDIX_SIZE;
+  const size_t expected_bytes     = threads * packets_per_thread * frame_size;
+
+  // Collect everything that reaches the wire
+  std::vector<std::uint8_t> wire;
+  std::thread reader([&] {
+    std::uint8_t buffer[1024];
+    pollfd fds    = {pty.fd, POLLIN, 0};
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (wire.size() < expected_bytes && std::chrono::steady_clock::now() < deadline)
+    {
+      if (::poll(&fds, 1, 10) > 0 && (fds.revents & POLLIN))
+      {
+        ssize_t bytes = ::read(pty.fd, buffer, sizeof(buffer));
+        if (bytes > 0)
+        {
+          wire.insert(wire.end(), buffer, buffer + bytes);
+        }
+      }
+    }
+  });
+
+  // Half of the threads block in sendPacket(), the other half only submit
+  std::vector<std::thread> senders;
+  for (size_t t = 0; t < threads; ++t)
+  {
+    senders.push_back(std::thread([&, t] {
+      for (size_t i = 0; i < packets_per_thread; ++i)
+      {
+        SVHSerialPacket packet(64, static_cast<std::uint8_t>(SVH_SET_CONTROL_COMMAND | (t << 4)));
+        for (size_t j = 0; j < packet.data.size(); ++j)
+        {
+          packet.data[j] = static_cast<std::uint8_t>(t);
+        }
+        if (t % 2 == 0)
+        {
+          BOOST_CHECK(serial_interface.sendPacket(packet));
+        }
+        else
+        {
+          while (!serial_interface.submitPacket(packet))
+          {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+          }
+        }
+      }
+    }));
+  }
+  for (size_t t = 0; t < threads; ++t)
+  {
+    senders[t].join();
+  }
+  reader.join();
+  serial_interface.close();
+
+  BOOST_REQUIRE_EQUAL(wire.size(), expected_bytes);
+  BOOST_CHECK_EQUAL(serial_interface.transmittedPacketCount(), threads * packets_per_thread);
+
+  // Every frame has to be complete and carry the payload of exactly one sender
+  std::vector<size_t> frames_per_thread(threads, 0);
+  for (size_t offset = 0; offset < wire.size(); offset += frame_size)
+  {
+    const std::uint8_t* frame = &wire[offset];
+    BOOST_REQUIRE_EQUAL(frame[0], PACKET_HEADER1);
+    BOOST_REQUIRE_EQUAL(frame[1], PACKET_HEADER2);
+    BOOST_CHECK_EQUAL(frame[2], static_cast<std::uint8_t>((offset / frame_size) % 255));
+    size_t sender = frame[3] >> 4;
+    BOOST_REQUIRE(sender < threads);
+    for (size_t j = 0; j < 64; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(frame[6 + j], sender);
+    }
+    frames_per_thread[sender]++;
+  }
+  for (size_t t = 0; t < threads; ++t)
+  {
+    BOOST_CHECK_EQUAL(frames_per_thread[t], packets_per_thread);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
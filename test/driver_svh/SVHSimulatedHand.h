@@ -0,0 +1,348 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * A simulated hand for tests of the finger manager. It plays the hand on
+ * the master side of a pseudo terminal and answers every request like the
+ * real hand, with a frame of the same index and address. Settings are
+ * echoed, the firmware info, targets and feedback requests are answered
+ * from a simple model:
+ * every channel reaches its target right away, except the far away targets
+ * of the homing which stop at a hard stop and drive the current up.
+ */
+//----------------------------------------------------------------------
+#ifndef DRIVER_SVH_SVH_SIMULATED_HAND_H_INCLUDED
+#define DRIVER_SVH_SVH_SIMULATED_HAND_H_INCLUDED
+
+#include <schunk_svh_library/control/SVHProtocolCodec.h>
+#include <schunk_svh_library/serial/ByteOrderConversion.h>
+#include <schunk_svh_library/serial/SVHSerialPacket.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace driver_svh {
+
+//! Targets beyond this distance from zero are homing targets that end at a hard stop
+const int32_t C_SIMULATED_HOMING_TARGET = 500000;
+
+//! Position of the hard stops of the simulated channels, close enough to zero for the soft limits
+//! found by homing to contain zero
+const int32_t C_SIMULATED_HARD_STOP = 20000;
+
+//! Current of a simulated channel pressing against its hard stop, above every homing threshold
+const int16_t C_SIMULATED_STOP_CURRENT = 600;
+
+//! Plays the hand on a pseudo terminal, the serial interface connects to slaveName()
+class SVHSimulatedHand
+{
+public:
+  SVHSimulatedHand()
+    : m_running(true)
+    , m_channels(C_CODEC_CHANNELS)
+  {
+    m_firmware.svh           = "SVH ";
+    m_firmware.version_major = 1;
+    m_firmware.version_minor = 0;
+    m_firmware.text          = "simulated";
+    m_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    grantpt(m_fd);
+    unlockpt(m_fd);
+    m_slave_name = ptsname(m_fd);
+    for (size_t i = 0; i < m_received.size(); ++i)
+    {
+      m_received[i]         = 0;
+      m_received_at_stop[i] = 0;
+    }
+    m_stops          = 0;
+    m_firmware_delay = std::chrono::milliseconds(0);
+    m_thread = std::thread([this] { run(); });
+  }
+
+  ~SVHSimulatedHand()
+  {
+    m_running = false;
+    m_thread.join();
+    ::close(m_fd);
+  }
+
+  //! device name to connect to
+  const std::string& slaveName() const { return m_slave_name; }
+
+  //! number of received frames with the given command, the channel of the address is ignored
+  unsigned int receivedCount(std::uint8_t command) const { return m_received[command & 0x0F]; }
+
+  //! number of frames with the given command that were received after the last stop
+  unsigned int receivedSinceStop(std::uint8_t command) const
+  {
+    return m_received[command & 0x0F] - m_received_at_stop[command & 0x0F];
+  }
+
+  //! number of controller states that switched off all powered channels at once
+  unsigned int stops() const { return m_stops; }
+
+  //! the first count drives of the channel to its hard stop are blocked without any current
+  void setStalls(size_t channel, unsigned int count)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_channels[channel].stalls = count;
+  }
+
+  //! version the hand reports in its firmware info
+  void setFirmware(uint16_t version_major, uint16_t version_minor)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_firmware.version_major = version_major;
+    m_firmware.version_minor = version_minor;
+  }
+
+  //! delays the answer to firmware info requests and every frame behind it like a slow link
+  void setFirmwareDelay(const std::chrono::milliseconds& delay)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_firmware_delay = delay;
+  }
+
+  //! switches all channels off, the encoders restart at zero like after switching the hand off
+  void powerCycle()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_channels.size(); ++i)
+    {
+      m_channels[i].target  = 0;
+      m_channels[i].powered = false;
+      m_channels[i].driving = false;
+    }
+  }
+
+  //! number of times the channel was driven towards its hard stop, each enabling starts a new drive
+  unsigned int drives(size_t channel)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_channels[channel].drives;
+  }
+
+private:
+  //! model of one channel
+  struct Channel
+  {
+    int32_t target;
+    bool powered;
+    bool driving;
+    unsigned int drives;
+    unsigned int stalls;
+
+    Channel()
+      : target(0)
+      , powered(false)
+      , driving(false)
+      , drives(0)
+      , stalls(0)
+    {
+    }
+
+    void setTarget(int32_t new_target)
+    {
+      const bool homing = std::abs(new_target) >= C_SIMULATED_HOMING_TARGET;
+      if (homing && !driving)
+      {
+        drives++;
+      }
+      driving = homing;
+      target  = new_target;
+    }
+
+    SVHControllerFeedback feedback() const
+    {
+      if (std::abs(target) < C_SIMULATED_HOMING_TARGET)
+      {
+        return SVHControllerFeedback(target, 0);
+      }
+      const int32_t direction = target > 0 ? 1 : -1;
+      const int16_t current   = drives <= stalls ? 0 : C_SIMULATED_STOP_CURRENT;
+      return SVHControllerFeedback(direction * C_SIMULATED_HARD_STOP,
+                                   static_cast<int16_t>(direction * current));
+    }
+  };
+
+  //! answers targets and feedback requests from the model, everything else is echoed
+  void answer(SVHFixedSerialPacket& packet)
+  {
+    const size_t channel = (packet.address >> 4) & 0x0F;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    switch (packet.address & 0x0F)
+    {
+      case SVH_SET_CONTROL_COMMAND:
+        if (channel < m_channels.size())
+        {
+          m_channels[channel].setTarget(readLittleEndian<int32_t>(packet.data.data()));
+        }
+        // fall through
+      case SVH_GET_CONTROL_FEEDBACK:
+        if (channel < m_channels.size())
+        {
+          packet.data.fill(0);
+          SVHWireLayout<SVHControllerFeedback>::encode(m_channels[channel].feedback(),
+                                                       packet.data.data());
+        }
+        break;
+      case SVH_SET_CONTROL_COMMAND_ALL:
+        for (size_t i = 0; i < m_channels.size(); ++i)
+        {
+          m_channels[i].setTarget(readLittleEndian<int32_t>(packet.data.data() + 4 * i));
+        }
+        // fall through
+      case SVH_GET_CONTROL_FEEDBACK_ALL:
+      {
+        SVHControllerFeedbackAllChannels feedback;
+        feedback.feedbacks.clear();
+        for (size_t i = 0; i < m_channels.size(); ++i)
+        {
+          feedback.feedbacks.push_back(m_channels[i].feedback());
+        }
+        packet.data.fill(0);
+        SVHWireLayout<SVHControllerFeedbackAllChannels>::encode(feedback, packet.data.data());
+        break;
+      }
+      case SVH_GET_FIRMWARE_INFO:
+        packet.data.fill(0);
+        SVHWireLayout<SVHFirmwareInfo>::encode(m_firmware, packet.data.data());
+        break;
+      case SVH_SET_CONTROLLER_STATE:
+      {
+        // A channel that is switched off ends its drive
+        SVHControllerState state;
+        SVHWireLayout<SVHControllerState>::decode(packet.data.data(), state);
+        bool was_powered = false;
+        bool is_powered  = false;
+        for (size_t i = 0; i < m_channels.size(); ++i)
+        {
+          const bool powered = (state.pwm_reset & (1 << i)) != 0;
+          if (m_channels[i].powered && !powered)
+          {
+            m_channels[i].driving = false;
+          }
+          was_powered           = was_powered || m_channels[i].powered;
+          is_powered            = is_powered || powered;
+          m_channels[i].powered = powered;
+        }
+        if (was_powered && !is_powered)
+        {
+          for (size_t i = 0; i < m_received.size(); ++i)
+          {
+            m_received_at_stop[i] = m_received[i].load();
+          }
+          m_stops++;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  //! collects the bytes of complete frames and answers each of them
+  void run()
+  {
+    std::vector<std::uint8_t> bytes;
+    std::uint8_t buffer[256];
+    pollfd fds = {m_fd, POLLIN, 0};
+    while (m_running)
+    {
+      if (::poll(&fds, 1, 10) <= 0 || !(fds.revents & POLLIN))
+      {
+        continue;
+      }
+      const ssize_t count = ::read(m_fd, buffer, sizeof(buffer));
+      if (count <= 0)
+      {
+        continue;
+      }
+      bytes.insert(bytes.end(), buffer, buffer + count);
+
+      while (bytes.size() >= C_FRAME_SIZE)
+      {
+        if (bytes[0] != PACKET_HEADER1 || bytes[1] != PACKET_HEADER2)
+        {
+          bytes.erase(bytes.begin());
+          continue;
+        }
+        SVHFixedSerialPacket packet(bytes[3]);
+        packet.index = bytes[2];
+        std::copy(bytes.begin() + 6, bytes.begin() + 6 + C_PACKET_DATA_SIZE, packet.data.begin());
+        bytes.erase(bytes.begin(), bytes.begin() + C_FRAME_SIZE);
+
+        m_received[packet.address & 0x0F]++;
+        if ((packet.address & 0x0F) == SVH_GET_FIRMWARE_INFO)
+        {
+          std::chrono::milliseconds delay;
+          {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            delay = m_firmware_delay;
+          }
+          std::this_thread::sleep_for(delay);
+        }
+        answer(packet);
+        SVHSerialFrame frame;
+        encodeFrame(packet, frame);
+        if (::write(m_fd, frame.data(), frame.size()) != static_cast<ssize_t>(frame.size()))
+        {
+          return;
+        }
+      }
+    }
+  }
+
+  int m_fd;
+  std::string m_slave_name;
+  std::atomic<bool> m_running;
+  std::array<std::atomic<unsigned int>, 16> m_received;
+  std::array<std::atomic<unsigned int>, 16> m_received_at_stop;
+  std::atomic<unsigned int> m_stops;
+  std::mutex m_mutex;
+  std::vector<Channel> m_channels;
+  SVHFirmwareInfo m_firmware;
+  std::chrono::milliseconds m_firmware_delay;
+  std::thread m_thread;
+};
+
+} // namespace driver_svh
+
+#endif
@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * Tests of the thread settings that are applied on connect.
+ */
+//----------------------------------------------------------------------
+#include <boost/test/unit_test.hpp>
+
+#include <schunk_svh_library/control/SVHController.h>
+#include <schunk_svh_library/serial/SVHReactor.h>
+#include <schunk_svh_library/serial/SVHSerialInterface.h>
+#include <schunk_svh_library/serial/SVHThreadConfig.h>
+
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+
+using namespace driver_svh;
+
+namespace {
+
+//! true if a failure of the setting with the given error was reported
+bool hasFailure(const std::vector<SVHThreadSetupFailure>& failures,
+                const std::string& setting,
+                int error)
+{
+  for (size_t i = 0; i < failures.size(); ++i)
+  {
+    if (failures[i].setting == setting && failures[i].error == error)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ts_SVHThreadConfig)
+
+BOOST_AUTO_TEST_CASE(SettingsAreAppliedBeforeTheThreadRuns)
+{
+  SVHThreadSetup setup;
+  setup.setStackPrefault(64 * 1024);
+
+  // Pin to the first core we may use
+  cpu_set_t allowed;
+  BOOST_REQUIRE(sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+  int cpu = 0;
+  while (!CPU_ISSET(cpu, &allowed))
+  {
+    ++cpu;
+  }
+
+  SVHThreadSettings settings;
+  settings.name = "svh_test_thread_name";
+  settings.cpus.push_back(cpu);
+
+  std::string name;
+  bool on_cpu_only   = false;
+  std::thread thread = setup.start(settings, [&] {
+    char buffer[16];
+    pthread_getname_np(pthread_self(), buffer, sizeof(buffer));
+    name = buffer;
+
+    cpu_set_t cpus;
+    pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    on_cpu_only = CPU_COUNT(&cpus) == 1 && CPU_ISSET(cpu, &cpus);
+  });
+  thread.join();
+
+  // Names are cut to what the kernel keeps
+  BOOST_CHECK_EQUAL(name, "svh_test_thread");
+  BOOST_CHECK(on_cpu_only);
+  BOOST_CHECK(setup.failures().empty());
+}
+
+BOOST_AUTO_TEST_CASE(FailuresAreReportedOnce)
+{
+  SVHThreadSetup setup;
+  setup.setStackPrefault(C_MAX_STACK_PREFAULT + 1);
+
+  SVHThreadSettings settings;
+  settings.name     = "svh_invalid";
+  settings.policy   = SCHED_FIFO;
+  settings.priority = 1000;
+  settings.cpus.push_back(-1);
+
+  bool ran = false;
+  for (size_t i = 0; i < 2; ++i)
+  {
+    std::thread thread = setup.start(settings, [&ran] { ran = true; });
+    thread.join();
+  }
+  BOOST_CHECK(ran);
+
+  // A failing setting does not keep the thread from running
+  const std::vector<SVHThreadSetupFailure> failures = setup.failures();
+  BOOST_CHECK_EQUAL(failures.size(), 3u);
+  BOOST_CHECK(hasFailure(failures, "policy", EINVAL));
+  BOOST_CHECK(hasFailure(failures, "affinity", EINVAL));
+  BOOST_CHECK(hasFailure(failures, "stack_prefault", EINVAL));
+  BOOST_CHECK_EQUAL(failures[0].thread, "svh_invalid");
+
+  setup.clear();
+  BOOST_CHECK(setup.failures().empty());
+}
+
+BOOST_AUTO_TEST_CASE(ConnectReportsFailuresOfItsThreads)
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  BOOST_REQUIRE(master >= 0);
+  grantpt(master);
+  unlockpt(master);
+
+  SVHThreadConfig config;
+  config.transmit.cpus.push_back(-1);
+
+  SVHSerialInterface serial_interface(ReceivedPacketCallback{});
+  BOOST_REQUIRE(serial_interface.connect(ptsname(master), config));
+  const std::vector<SVHThreadSetupFailure> failures = serial_interface.threadSetupFailures();
+  BOOST_REQUIRE_EQUAL(failures.size(), 1u);
+  BOOST_CHECK_EQUAL(failures[0].thread, "svh_transmit");
+  BOOST_CHECK_EQUAL(failures[0].setting, "affinity");
+
+  // Reconnecting starts over
+  BOOST_REQUIRE(serial_interface.connect(ptsname(master)));
+  BOOST_CHECK(serial_interface.threadSetupFailures().empty());
+  serial_interface.close();
+  ::close(master);
+
+  // The reactor thread has settings of its own
+  SVHThreadSettings reactor_settings;
+  reactor_settings.policy   = SCHED_FIFO;
+  reactor_settings.priority = 1000;
+  SVHReactor reactor(reactor_settings);
+  BOOST_CHECK(reactor.isRunning());
+  BOOST_CHECK(hasFailure(reactor.threadSetupFailures(), "policy", EINVAL));
+}
+
+BOOST_AUTO_TEST_CASE(CommandFlusherHasItsOwnSettings)
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  BOOST_REQUIRE(master >= 0);
+  grantpt(master);
+  unlockpt(master);
+
+  SVHThreadConfig config;
+  config.command.cpus.push_back(-1);
+
+  SVHController controller;
+  BOOST_REQUIRE(controller.connect(ptsname(master), config));
+  BOOST_CHECK(controller.getThreadSetupFailures().empty());
+
+  // The flusher only starts with coalescing
+  controller.setCommandCoalescing(std::chrono::milliseconds(1));
+  const std::vector<SVHThreadSetupFailure> failures = controller.getThreadSetupFailures();
+  BOOST_REQUIRE_EQUAL(failures.size(), 1u);
+  BOOST_CHECK_EQUAL(failures[0].thread, "svh_command");
+  BOOST_CHECK_EQUAL(failures[0].setting, "affinity");
+
+  controller.setCommandCoalescing(std::chrono::microseconds(0));
+  controller.disconnect();
+  ::close(master);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * Tests of the trajectory interpolation.
+ */
+//----------------------------------------------------------------------
+#include <boost/test/unit_test.hpp>
+
+#include <schunk_svh_library/control/SVHFingerManager.h>
+#include <schunk_svh_library/control/SVHTrajectory.h>
+
+#include "SVHSimulatedHand.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace driver_svh;
+
+namespace {
+
+SVHTrajectoryWaypoint makeWaypoint(int64_t time_ms, double position)
+{
+  return SVHTrajectoryWaypoint(std::chrono::milliseconds(time_ms),
+                               std::vector<double>(C_TRAJECTORY_CHANNELS, position));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ts_SVHTrajectory)
+
+BOOST_AUTO_TEST_CASE(MalformedWaypointsAreRejected)
+{
+  SVHTrajectory trajectory;
+  std::vector<SVHTrajectoryWaypoint> waypoints;
+  BOOST_CHECK(!trajectory.setWaypoints(waypoints, SVH_INTERPOLATION_LINEAR));
+
+  waypoints.push_back(makeWaypoint(0, 0.0));
+  waypoints.push_back(makeWaypoint(0, 1.0));
+  BOOST_CHECK(!trajectory.setWaypoints(waypoints, SVH_INTERPOLATION_LINEAR));
+
+  waypoints.back().time = std::chrono::milliseconds(100);
+  waypoints.back().positions.resize(C_TRAJECTORY_CHANNELS - 1);
+  BOOST_CHECK(!trajectory.setWaypoints(waypoints, SVH_INTERPOLATION_LINEAR));
+
+  waypoints.back().positions.resize(C_TRAJECTORY_CHANNELS, 1.0);
+  BOOST_CHECK(trajectory.setWaypoints(waypoints, SVH_INTERPOLATION_LINEAR));
+  BOOST_CHECK(trajectory.duration() == std::chrono::milliseconds(100));
+}
+
+BOOST_AUTO_TEST_CASE(InterpolationPassesWaypoints)
+{
+  std::vector<SVHTrajectoryWaypoint> waypoints;
+  waypoints.push_back(makeWaypoint(0, 0.0));
+  waypoints.push_back(makeWaypoint(100, 1000.0));
+  waypoints.push_back(makeWaypoint(300, 3000.0));
+  waypoints.push_back(makeWaypoint(400, 2000.0));
+
+  const SVHInterpolation interpolations[] = {
+    SVH_INTERPOLATION_LINEAR, SVH_INTERPOLATION_CUBIC, SVH_INTERPOLATION_QUINTIC};
+  for (SVHInterpolation interpolation : interpolations)
+  {
+    SVHTrajectory trajectory;
+    BOOST_REQUIRE(trajectory.setWaypoints(waypoints, interpolation));
+
+    std::vector<double> positions;
+    for (size_t w = 0; w < waypoints.size(); ++w)
+    {
+      trajectory.sample(waypoints[w].time, positions);
+      BOOST_REQUIRE_EQUAL(positions.size(), C_TRAJECTORY_CHANNELS);
+      BOOST_CHECK_CLOSE(positions[0] + 1.0, waypoints[w].positions[0] + 1.0, 1e-6);
+    }
+
+    // Held before the start and after the end
+    trajectory.sample(std::chrono::milliseconds(-10), positions);
+    BOOST_CHECK_EQUAL(positions[4], 0.0);
+    trajectory.sample(std::chrono::milliseconds(1000), positions);
+    BOOST_CHECK_EQUAL(positions[4], 2000.0);
+
+    // No overshoot beyond the neighbouring waypoints
+    double previous = 0.0;
+    for (int64_t t = 0; t <= 300; t += 5)
+    {
+      trajectory.sample(std::chrono::milliseconds(t), positions);
+      BOOST_CHECK(positions[8] >= previous - 1e-9);
+      BOOST_CHECK(positions[8] <= 3000.0 + 1e-9);
+      previous = positions[8];
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SmoothInterpolationStartsAtRest)
+{
+  std::vector<SVHTrajectoryWaypoint> waypoints;
+  waypoints.push_back(makeWaypoint(0, 0.0));
+  waypoints.push_back(makeWaypoint(1000, 1000.0));
+
+  std::vector<double> linear;
+  std::vector<double> cubic;
+  std::vector<double> quintic;
+  SVHTrajectory trajectory;
+  const std::chrono::microseconds early(10000);
+
+  BOOST_REQUIRE(trajectory.setWaypoints(waypoints, SVH_INTERPOLATION_LINEAR));
+  trajectory.sample(early, linear);
+  BOOST_REQUIRE(trajectory.setWaypoints(waypoints, SVH_INTERPOLATION_CUBIC));
+  trajectory.sample(early, cubic);
+  BOOST_REQUIRE(trajectory.setWaypoints(waypoints, SVH_INTERPOLATION_QUINTIC));
+  trajectory.sample(early, quintic);
+
+  BOOST_CHECK_CLOSE(linear[0], 10.0, 1e-6);
+  BOOST_CHECK(cubic[0] < linear[0]);
+  BOOST_CHECK(quintic[0] < cubic[0]);
+
+  // All are symmetric around the middle of the segment
+  trajectory.sample(std::chrono::milliseconds(500), quintic);
+  BOOST_CHECK_CLOSE(quintic[0], 500.0, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(FingerManagerRejectsTrajectoryWithoutHand)
+{
+  SVHFingerManager finger_manager;
+  std::vector<SVHTrajectoryWaypoint> waypoints;
+  waypoints.push_back(makeWaypoint(100, 0.0));
+
+  BOOST_CHECK(!finger_manager.executeTrajectory(waypoints));
+  BOOST_CHECK(!finger_manager.isTrajectoryActive());
+  BOOST_CHECK(finger_manager.waitForTrajectory(std::chrono::milliseconds(0)));
+  BOOST_CHECK(finger_manager.setTrajectoryRate(250.0));
+  BOOST_CHECK(!finger_manager.setTrajectoryRate(0.0));
+  BOOST_CHECK(!finger_manager.setTrajectoryRate(C_TRAJECTORY_MAX_RATE * 2.0));
+}
+
+BOOST_AUTO_TEST_CASE(EmergencyStopEndsTrajectory)
+{
+  SVHSimulatedHand hand;
+  SVHFingerManager finger_manager;
+  BOOST_REQUIRE(finger_manager.connect(hand.slaveName()));
+  BOOST_REQUIRE(finger_manager.resetChannel(SVH_ALL));
+  BOOST_REQUIRE(finger_manager.setTrajectoryRate(C_TRAJECTORY_MAX_RATE));
+
+  // Stopped at different points of the stream, no target may reach the hand after the stop
+  for (unsigned int run = 0; run < 40; ++run)
+  {
+    SVHTrajectoryWaypoint waypoint(std::chrono::milliseconds(1000),
+                                   std::vector<double>(SVH_DIMENSION, 0.0));
+    for (size_t i = 0; i < SVH_DIMENSION; ++i)
+    {
+      double position = 0.0;
+      BOOST_REQUIRE(finger_manager.getPosition(static_cast<SVHChannel>(i), position));
+      waypoint.positions[i] = position * 0.5;
+    }
+    const unsigned int streamed = hand.receivedCount(SVH_SET_CONTROL_COMMAND_ALL);
+    const unsigned int stops    = hand.stops();
+    BOOST_REQUIRE(
+      finger_manager.executeTrajectory(std::vector<SVHTrajectoryWaypoint>(1, waypoint)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10 + run));
+
+    finger_manager.disableChannel(SVH_ALL);
+    BOOST_CHECK(!finger_manager.isTrajectoryActive());
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    BOOST_REQUIRE_EQUAL(hand.stops(), stops + 1);
+    BOOST_CHECK(hand.receivedCount(SVH_SET_CONTROL_COMMAND_ALL) > streamed);
+    BOOST_CHECK_EQUAL(hand.receivedSinceStop(SVH_SET_CONTROL_COMMAND_ALL), 0u);
+  }
+
+  finger_manager.disconnect();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
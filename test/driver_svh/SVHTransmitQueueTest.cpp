@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2024 SCHUNK SE & Co. KG, Lauffen/Neckar Germany
+// Copyright 2022 FZI Forschungszentrum Informatik, Karlsruhe, Germany
+//
+// This file is part of the Schunk SVH Library.
+//
+// The Schunk SVH Library is free software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at your
+// option) any later version.
+//
+// The Schunk SVH Library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+// Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along with
+// the Schunk SVH Library. If not, see <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+//----------------------------------------------------------------------
+/*!\file
+ *
+ * \author  agent <agent@local>
+ * \date    2026-10-16
+ *
+ * Tests of the lock-free multi-producer transmit queue.
+ */
+//----------------------------------------------------------------------
+#include <boost/test/unit_test.hpp>
+
+#include <schunk_svh_library/serial/SVHTransmitQueue.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace driver_svh;
+
+BOOST_AUTO_TEST_SUITE(ts_SVHTransmitQueue)
+
+BOOST_AUTO_TEST_CASE(FifoAndCapacity)
+{
+  SVHTransmitQueue<int> queue(5);
+  BOOST_CHECK_EQUAL(queue.capacity(), 8u);
+  BOOST_CHECK(queue.empty());
+
+  for (int i = 0; i < 8; ++i)
+  {
+    BOOST_CHECK(queue.push(i));
+  }
+  int value = 42;
+  BOOST_CHECK(!queue.push(value));
+  BOOST_CHECK_EQUAL(value, 42);
+  BOOST_CHECK_EQUAL(queue.size(), 8u);
+
+  // Wrap around a few times
+  for (int i = 0; i < 20; ++i)
+  {
+    BOOST_REQUIRE(queue.pop(value));
+    BOOST_CHECK_EQUAL(value, i);
+    int next = i + 8;
+    BOOST_CHECK(queue.push(next));
+  }
+  BOOST_CHECK_EQUAL(queue.size(), 8u);
+}
+
+BOOST_AUTO_TEST_CASE(ManyProducersOneConsumer)
+{
+  const int producers           = 4;
+  const int values_per_producer = 10000;
+  SVHTransmitQueue<int> queue(64);
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p)
+  {
+    threads.push_back(std::thread([&queue, p] {
+      for (int i = 0; i < values_per_producer; ++i)
+      {
+        int value = p * values_per_producer + i;
+        while (!queue.push(value))
+        {
+          std::this_thread::yield();
+        }
+      }
+    }));
+  }
+
+  // Values of each producer have to arrive complete and in their original order
+  std::vector<int> last(producers, -1);
+  int received = 0;
+  int value;
+  while (received < producers * values_per_producer)
+  {
+    if (queue.pop(value))
+    {
+      int producer = value / values_per_producer;
+      BOOST_REQUIRE(producer >= 0 && producer < producers);
+      BOOST_REQUIRE(value % values_per_producer > last[producer]);
+      last[producer] = value % values_per_producer;
+      received++;
+    }
+  }
+
+  for (int p = 0; p < producers; ++p)
+  {
+    threads[p].join();
+    BOOST_CHECK_EQUAL(last[p], values_per_producer - 1);
+  }
+  BOOST_CHECK(queue.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()